@@ -143,6 +143,7 @@ cairo_t* desktop_t::get_drawing_context() {
 	if (canvas_current_surface == 0 || canvas_current_buffer != canvas_buffer_info.buffer) {
 		if (canvas_current_context != 0) {
 			cairo_destroy(canvas_current_context);
+			cairo_surface_destroy(canvas_current_surface);
 		}
 
 		canvas_current_surface = cairo_image_surface_create_for_data((uint8_t*) canvas_buffer_info.buffer, CAIRO_FORMAT_ARGB32, canvas_buffer_info.width,
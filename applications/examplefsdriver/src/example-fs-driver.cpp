@@ -76,16 +76,15 @@ int main(int argc, char* argv[]) {
 	 * delegate by telling the kernel to create a mountpoint.
 	 *
 	 * The process must specify a name, and gets a mountpoint &
-	 * a transaction storage back:
+	 * the request ring back:
 	 */
 	const char* name = "testfs";
 	g_fs_virt_id mountpoint_id;
-	g_address transaction_storage_addr;
+	g_fs_tasked_delegate_ring* ring;
 
 	phys_node_t* mountpoint_node = fake_discovery(0, "root");
 	g_fs_register_as_delegate_status result = g_fs_register_as_delegate(name,
-			mountpoint_node->phys_id, &mountpoint_id,
-			&transaction_storage_addr);
+			mountpoint_node->phys_id, &mountpoint_id, &ring);
 	mountpoint_node->virt_id = mountpoint_id;
 
 	/**
@@ -102,157 +101,82 @@ int main(int argc, char* argv[]) {
 				name);
 
 	} else if (result == G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL) {
-		/**
-		 * The transaction storage is used in various operations, like discovering nodes,
-		 * to transfer data from the kernel to the process.
-		 */
-		uint8_t* transaction_storage = (uint8_t*) transaction_storage_addr;
-
-		g_tid tid = g_get_tid();
-		g_fs_phys_id dummy_fs_node_id_counter = 0;
 
 		/**
-		 * The driver must now make a message loop, asking for messages that are
-		 * addressed to the **thread** that was registered.
+		 * The driver must now take requests from the ring. Each request
+		 * is completed once its results are written.
 		 */
 		while (true) {
-			g_message_empty(request);
-			g_recv_msg(tid, &request);
+			g_fs_tasked_delegate_request* request = g_fs_next_request(ring);
 
 			// Now do what is necessary to perform the requested operation
-			if (request.type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER) {
-				g_fs_tasked_delegate_transaction_storage_discovery* disc =
-						(g_fs_tasked_delegate_transaction_storage_discovery*) transaction_storage;
-
-				phys_node_t* parent = 0;
-				if (phys_nodes.count(disc->parent_phys_fs_id) > 0) {
-					parent = phys_nodes[disc->parent_phys_fs_id];
-
-					phys_node_t* child = fake_discovery(parent, disc->name);
-
-					g_fs_virt_id created_vfs_node_id;
-					g_fs_create_node_status stat = g_fs_create_node(
-							parent->virt_id, disc->name, G_FS_NODE_TYPE_FILE,
-							child->phys_id, &created_vfs_node_id);
-					child->virt_id = created_vfs_node_id;
-					g_logger::log(
-							"discovered child of %i (phys %i) named %s, virt %i, phys %i",
-							parent->virt_id, parent->phys_id, disc->name,
-							child->virt_id, child->phys_id);
-
-					disc->result_status = G_FS_DISCOVERY_SUCCESSFUL;
+			if (request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER) {
+				if (phys_nodes.count(request->phys_fs_id) > 0) {
+					phys_node_t* parent = phys_nodes[request->phys_fs_id];
+					phys_node_t* child = fake_discovery(parent, request->name);
+
+					g_logger::log("discovered child of %i (phys %i) named %s, phys %i",
+							request->virt_fs_id, parent->phys_id, request->name,
+							child->phys_id);
+
+					// the kernel creates the node from these results
+					request->result_phys_fs_id = child->phys_id;
+					request->result_type = G_FS_NODE_TYPE_FILE;
+					request->result_status = G_FS_DISCOVERY_SUCCESSFUL;
 				} else {
 					g_logger::log(
 							"tried to find child of non-existing physical node: %i",
-							disc->parent_phys_fs_id);
-					disc->result_status = G_FS_DISCOVERY_ERROR;
+							request->phys_fs_id);
+					request->result_status = G_FS_DISCOVERY_ERROR;
 				}
-				g_fs_set_transaction_status(request.parameterA,
-						G_FS_TRANSACTION_FINISHED);
 
-			} else if (request.type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ) {
-				g_fs_tasked_delegate_transaction_storage_read* storage =
-						(g_fs_tasked_delegate_transaction_storage_read*) transaction_storage;
+			} else if (request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN) {
+				request->result_status = G_FS_OPEN_SUCCESSFUL;
+
+			} else if (request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE) {
+				request->result_status = G_FS_CLOSE_SUCCESSFUL;
+
+			} else if (request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ) {
 
 				// this is a dummy method, driver has exactly 1024 random files
-				int toread = 1024 - storage->offset;
-				int requested = storage->length;
+				int toread = 1024 - request->offset;
+				int requested = request->length;
 				toread = toread < requested ? toread : requested;
+				if (toread < 0) {
+					toread = 0;
+				}
+
+				// the buffer is the memory of the reading task
 				for (int i = 0; i < toread; i++) {
-					((char*) storage->mapped_buffer)[i] = (char) ('a'
+					((char*) request->buffer)[i] = (char) ('a'
 							+ (i % ('z' - 'a')));
 				}
-				storage->result_read = toread;
-				storage->result_status = G_FS_READ_SUCCESSFUL;
-				g_fs_set_transaction_status(request.parameterA,
-						G_FS_TRANSACTION_FINISHED);
+				request->result_length = toread;
+				request->result_status = G_FS_READ_SUCCESSFUL;
 
-			} else if (request.type
+			} else if (request->type
 					== G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE) {
-				g_fs_tasked_delegate_transaction_storage_write* storage =
-						(g_fs_tasked_delegate_transaction_storage_write*) transaction_storage;
 
 				std::stringstream content;
-				for (int i = 0; i < storage->length; i++) {
-					content << ((char*) storage->mapped_buffer)[i];
+				for (int i = 0; i < request->length; i++) {
+					content << ((char*) request->buffer)[i];
 				}
 				g_logger::log(
 						"wrote %i to node %i: '" + content.str() + "'",
-						storage->length, storage->phys_fs_id);
-				storage->result_write = storage->length;
-				storage->result_status = G_FS_WRITE_SUCCESSFUL;
-				g_fs_set_transaction_status(request.parameterA,
-						G_FS_TRANSACTION_FINISHED);
+						request->length, request->phys_fs_id);
+				request->result_length = request->length;
+				request->result_status = G_FS_WRITE_SUCCESSFUL;
 
-			} else if (request.type
+			} else if (request->type
 					== G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH) {
-				g_fs_tasked_delegate_transaction_storage_get_length* storage =
-						(g_fs_tasked_delegate_transaction_storage_get_length*) transaction_storage;
-
-				storage->result_length = 1024;
-				storage->result_status = G_FS_LENGTH_SUCCESSFUL;
-				g_fs_set_transaction_status(request.parameterA,
-						G_FS_TRANSACTION_FINISHED);
-
-			} else if (request.type
-					== G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY) {
-				g_fs_tasked_delegate_transaction_storage_directory_refresh* storage =
-						(g_fs_tasked_delegate_transaction_storage_directory_refresh*) transaction_storage;
-
-				klog("got read directory request");
-
-				for(int position = 0; position < 10; position++) {
-					phys_node_t* parent = phys_nodes[storage->parent_phys_fs_id];
-
-					// prepare name
-					std::stringstream filenames;
-					filenames << "file" << position;
-					std::string filename = filenames.str();
-
-					// find existing node at position
-					phys_node_t* child = 0;
-
-					int index = 0;
-					for (auto entry : phys_nodes) {
-						if (entry.second->parent->phys_id == parent->phys_id) {
-							if (index == position) {
-								child = entry.second;
-								break;
-							}
-							++index;
-						}
-					}
-
-					// otherwise create node
-					if (child == 0) {
-						child = fake_discovery(parent, filename.c_str());
-						klog("- creating fake child: %s", filename.c_str());
-					}
-
-					klog("- fake child: %s", filename.c_str());
-
-					// create/update node
-					g_fs_virt_id vfs_node_id;
-					g_fs_create_node_status stat = g_fs_create_node(
-							parent->virt_id, (char*) filename.c_str(),
-							G_FS_NODE_TYPE_FILE, child->phys_id, &vfs_node_id);
-					child->virt_id = vfs_node_id;
-
-					if (stat == G_FS_CREATE_NODE_STATUS_CREATED) {
-						g_logger::log("created node when reading dir");
-					} else if (stat == G_FS_CREATE_NODE_STATUS_UPDATED) {
-						g_logger::log("updated node when reading dir");
-					} else {
-						g_logger::log("failed on node when reading dir");
-					}
-
-					storage->result_status = G_FS_READ_DIRECTORY_SUCCESSFUL;
-				}
+				request->result_length = 1024;
+				request->result_status = G_FS_LENGTH_SUCCESSFUL;
 
-				g_fs_set_transaction_status(request.parameterA,
-						G_FS_TRANSACTION_FINISHED);
+			} else {
+				request->result_status = G_FS_OPEN_ERROR;
 			}
 
+			g_fs_complete_request(request);
 		}
 
 	} else {
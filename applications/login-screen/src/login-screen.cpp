@@ -111,6 +111,10 @@ int main(int argc, char** argv) {
 	g_ui_open_status open_stat = g_ui::open();
 
 	if (open_stat == G_UI_OPEN_STATUS_SUCCESSFUL) {
+
+		// set up the window with as few messages as possible
+		g_ui::begin_batch();
+
 		loginWindow = g_window::create();
 
 		loginWindow->setTitle("Login");
@@ -156,6 +160,8 @@ int main(int argc, char** argv) {
 		loginWindow->setResizable(false);
 		loginWindow->setVisible(true);
 
+		g_ui::end_batch();
+
 		// canvas test
 		auto bufferInfo = canvas->getBuffer();
 		klog("buffer: %x, size: %ix%i", bufferInfo.buffer, bufferInfo.width, bufferInfo.height);
@@ -216,6 +222,13 @@ int main(int argc, char** argv) {
 				dir = true;
 			}
 
+			// the buffer changes with every blit
+			bufferInfo = canvas->getBuffer();
+			if (bufferInfo.buffer == 0) {
+				g_sleep(100);
+				continue;
+			}
+
 			cairo_surface_t* bufferSurface = cairo_image_surface_create_for_data((uint8_t*) bufferInfo.buffer, CAIRO_FORMAT_ARGB32, bufferInfo.width,
 					bufferInfo.height, cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, bufferInfo.width));
 			auto cr = cairo_create(bufferSurface);
@@ -231,6 +244,8 @@ int main(int argc, char** argv) {
 			cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
 			cairo_fill(cr);
 
+			cairo_destroy(cr);
+			cairo_surface_destroy(bufferSurface);
 			canvas->blit(g_rectangle(0, 0, bufferInfo.width, bufferInfo.height));
 
 			g_sleep(10);
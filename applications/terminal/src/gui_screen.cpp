@@ -239,6 +239,7 @@ cairo_t* gui_screen_t::getGraphics() {
 	if (existingSurface == 0 || existingSurfaceBuffer != bufferInfo.buffer) {
 		if (existingContext != 0) {
 			cairo_destroy(existingContext);
+			cairo_surface_destroy(existingSurface);
 		}
 
 		existingSurface = cairo_image_surface_create_for_data(
@@ -143,6 +143,9 @@ bool gui_screen_t::initialize() {
 	window->setListener(G_UI_COMPONENT_EVENT_TYPE_FOCUS, new terminal_focus_listener_t(this));
 
 	font = g_font_loader::get("consolas");
+	if (font) {
+		atlas = font->getAtlas(14);
+	}
 
 	g_create_thread_d((void*) paint_entry, this);
 	g_create_thread_d((void*) blink_cursor_entry, this);
@@ -175,42 +178,12 @@ void gui_screen_t::paint_entry(gui_screen_t* screen) {
 	screen->paint();
 }
 
-/**
- *
- */
-char_layout_t* gui_screen_t::get_char_layout(cairo_scaled_font_t* scaled_face, char c) {
-
-	// Take char from layout cache
-	auto entry = char_layout_cache.find(c);
-	if (entry != char_layout_cache.end()) {
-		return (*entry).second;
-	}
-
-	// Perform layouting
-	char cbuf[2];
-	cbuf[0] = c;
-	cbuf[1] = 0;
-
-	char_layout_t* layout = new char_layout_t();
-	cairo_text_cluster_flags_t cluster_flags;
-	cairo_status_t stat = cairo_scaled_font_text_to_glyphs(scaled_face, 0, 0, cbuf, 1, &layout->glyph_buffer, &layout->glyph_count, &layout->cluster_buffer,
-			&layout->cluster_count, &cluster_flags);
-
-	if (stat == CAIRO_STATUS_SUCCESS) {
-		char_layout_cache[c] = layout;
-		return layout;
-	}
-	return 0;
-}
-
 /**
  *
  */
 void gui_screen_t::paint() {
 
-	int padding = 0;
 	while (true) {
-		auto windowBounds = window->getBounds();
 		update_visible_buffer_size();
 
 		auto cr = getGraphics();
@@ -219,69 +192,171 @@ void gui_screen_t::paint() {
 			continue;
 		}
 
-		// clear
-		cairo_save(cr);
-		cairo_set_source_rgba(cr, 0, 0, 0, 1);
-		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-		cairo_paint(cr);
-		cairo_restore(cr);
-
 		raster_lock.lock();
+		paint_uptodate = true;
 
-		// paint cursor
+		// cursor cell must be repainted when it appears or disappears
 		bool blink_on = false;
 		if (focused) {
 			blink_on = (g_millis() - last_input_time < 300) || cursorBlink;
+		}
+		if (blink_on != cursor_painted) {
+			mark_line_dirty(cursor_y);
+			cursor_painted = blink_on;
+		}
+
+		int changed_top = bufferSize.height;
+		int changed_bottom = 0;
+
+		if (raster_buffer && atlas) {
+			int scrolled_pixels = scrolled_lines * char_height;
 
-			if (blink_on) {
+			if (repaint_all || scrolled_pixels >= bufferSize.height) {
 				cairo_save(cr);
-				cairo_set_source_rgba(cr, 0.5, 0.7, 1, 1);
-				cairo_rectangle(cr, cursor_x * char_width + padding, cursor_y * char_height + padding + 1, char_width, char_height + 1);
-				cairo_fill(cr);
+				cairo_set_source_rgba(cr, 0, 0, 0, 1);
+				cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+				cairo_paint(cr);
 				cairo_restore(cr);
-			}
-		}
 
-		if (raster_buffer) {
-			cairo_set_font_face(cr, font->getFace());
-			cairo_set_font_size(cr, 14);
-			auto scaled_face = cairo_get_scaled_font(cr);
+				for (int y = 0; y < raster_size.height; y++) {
+					if (!paint_line(cr, y, blink_on)) {
+						break;
+					}
+				}
+
+				changed_top = 0;
+				changed_bottom = bufferSize.height;
+
+			} else {
+				// move the painted lines and repaint what was exposed
+				int first_exposed = raster_size.height;
+				if (scrolled_pixels > 0) {
+					scroll_canvas(scrolled_pixels);
+					first_exposed = (bufferSize.height - scrolled_pixels) / char_height - 1;
+
+					changed_top = 0;
+					changed_bottom = bufferSize.height;
+				}
 
-			for (int y = 0; y < raster_size.height; y++) {
-				for (int x = 0; x < raster_size.width; x++) {
-					uint8_t c = raster_buffer[y * raster_size.width + x];
-					if (c == 0) {
+				for (int y = 0; y < raster_size.height; y++) {
+					bool dirty = y >= first_exposed || dirty_lines[y] || (y > 0 && dirty_lines[y - 1])
+							|| (y < raster_size.height - 1 && dirty_lines[y + 1]);
+					if (!dirty) {
 						continue;
 					}
+					if (!paint_line(cr, y, blink_on)) {
+						break;
+					}
 
-					// Render only the character
-					char_layout_t* char_layout = get_char_layout(scaled_face, c);
-
-					if (char_layout) {
-						cairo_save(cr);
-						if (cursor_x == x && cursor_y == y && blink_on) {
-							cairo_set_source_rgba(cr, 0, 0, 0, 1);
-						} else {
-							cairo_set_source_rgba(cr, 1, 1, 1, 1);
-						}
-						cairo_translate(cr, x * char_width + padding, (y + 1) * char_height + padding);
-						cairo_glyph_path(cr, char_layout->glyph_buffer, char_layout->cluster_buffer[0].num_glyphs);
-						cairo_fill(cr);
-						cairo_restore(cr);
+					int top = y * char_height;
+					int bottom = (y == raster_size.height - 1) ? bufferSize.height : top + char_height;
+					if (top < changed_top) {
+						changed_top = top;
+					}
+					if (bottom > changed_bottom) {
+						changed_bottom = bottom;
 					}
 				}
 			}
+
+			memset(dirty_lines, 0, raster_size.height);
+			scrolled_lines = 0;
+			repaint_all = false;
 		}
 
 		raster_lock.unlock();
 
-		canvas->blit(g_rectangle(0, 0, bufferSize.width, bufferSize.height));
+		if (changed_bottom > bufferSize.height) {
+			changed_bottom = bufferSize.height;
+		}
+		if (changed_top < changed_bottom) {
+			canvas->blit(g_rectangle(0, changed_top, bufferSize.width, changed_bottom - changed_top));
+		}
 
-		paint_uptodate = true;
 		g_atomic_block(&paint_uptodate);
 	}
 }
 
+/**
+ *
+ */
+bool gui_screen_t::paint_line(cairo_t* cr, int line, bool blink_on) {
+
+	int top = line * char_height;
+	if (top >= bufferSize.height) {
+		return false;
+	}
+	int bottom = (line == raster_size.height - 1) ? bufferSize.height : top + char_height;
+
+	cairo_save(cr);
+	cairo_rectangle(cr, 0, top, bufferSize.width, bottom - top);
+	cairo_clip(cr);
+
+	// clear
+	cairo_set_source_rgba(cr, 0, 0, 0, 1);
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_paint(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+	int first = line > 0 ? line - 1 : 0;
+	int last = line < raster_size.height - 1 ? line + 1 : line;
+
+	// paint cursor
+	if (blink_on && cursor_y >= first && cursor_y <= last) {
+		cairo_set_source_rgba(cr, 0.5, 0.7, 1, 1);
+		cairo_rectangle(cr, cursor_x * char_width, cursor_y * char_height + 1, char_width, char_height + 1);
+		cairo_fill(cr);
+	}
+
+	// composite the cached glyph masks of this and the neighbouring lines
+	for (int y = first; y <= last; y++) {
+		for (int x = 0; x < raster_size.width; x++) {
+			uint8_t c = raster_buffer[y * raster_size.width + x];
+			if (c == 0) {
+				continue;
+			}
+
+			g_atlas_glyph* glyph = atlas->getCharacter(c);
+			if (glyph) {
+				if (cursor_x == x && cursor_y == y && blink_on) {
+					cairo_set_source_rgba(cr, 0, 0, 0, 1);
+				} else {
+					cairo_set_source_rgba(cr, 1, 1, 1, 1);
+				}
+				g_glyph_atlas::paint(cr, glyph, x * char_width, (y + 1) * char_height);
+			}
+		}
+	}
+
+	cairo_restore(cr);
+	return true;
+}
+
+/**
+ *
+ */
+void gui_screen_t::scroll_canvas(int pixels) {
+
+	cairo_surface_flush(existingSurface);
+
+	int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, bufferSize.width);
+	int rows = bufferSize.height - pixels;
+	if (rows > 0) {
+		memmove(existingSurfaceBuffer, existingSurfaceBuffer + pixels * stride, rows * stride);
+	}
+
+	cairo_surface_mark_dirty(existingSurface);
+}
+
+/**
+ *
+ */
+void gui_screen_t::mark_line_dirty(int line) {
+	if (dirty_lines && line >= 0 && line < raster_size.height) {
+		dirty_lines[line] = 1;
+	}
+}
+
 /**
  *
  */
@@ -300,6 +375,7 @@ cairo_t* gui_screen_t::getGraphics() {
 	if (existingSurface == 0 || existingSurfaceBuffer != bufferInfo.buffer) {
 		if (existingContext != 0) {
 			cairo_destroy(existingContext);
+			cairo_surface_destroy(existingSurface);
 		}
 
 		existingSurface = cairo_image_surface_create_for_data((uint8_t*) bufferInfo.buffer, CAIRO_FORMAT_ARGB32, bufferInfo.width, bufferInfo.height,
@@ -308,6 +384,11 @@ cairo_t* gui_screen_t::getGraphics() {
 		existingContext = cairo_create(existingSurface);
 	}
 
+	// a new buffer has no content yet
+	if (bufferInfo.fresh) {
+		repaint_all = true;
+	}
+
 	return existingContext;
 }
 
@@ -328,6 +409,7 @@ void gui_screen_t::clean() {
 
 	raster_lock.lock();
 	memset(raster_buffer, 0, raster_size.height * raster_size.width);
+	repaint_all = true;
 	raster_lock.unlock();
 	repaint();
 }
@@ -346,22 +428,43 @@ void gui_screen_t::backspace() {
  *
  */
 void gui_screen_t::writeChar(char c) {
-	if (charIsUtf8(c)) {
 
-		if (raster_buffer) {
+	raster_lock.lock();
+	put_char(c);
+	raster_lock.unlock();
 
-			if (c == '\n') {
-				moveCursor(0, cursor_y + 1);
-			} else {
-				raster_lock.lock();
-				raster_buffer[cursor_y * raster_size.width + cursor_x] = c;
-				raster_lock.unlock();
-				moveCursor(cursor_x + 1, cursor_y);
-			}
+	repaint();
+}
 
-		}
+/**
+ *
+ */
+void gui_screen_t::writeString(const char* text, int length) {
+
+	raster_lock.lock();
+	for (int i = 0; i < length; i++) {
+		put_char(text[i]);
+	}
+	raster_lock.unlock();
 
-		paint_uptodate = false;
+	repaint();
+}
+
+/**
+ *
+ */
+void gui_screen_t::put_char(char c) {
+
+	if (!charIsUtf8(c) || !raster_buffer) {
+		return;
+	}
+
+	if (c == '\n') {
+		move_cursor_locked(0, cursor_y + 1);
+	} else {
+		raster_buffer[cursor_y * raster_size.width + cursor_x] = c;
+		mark_line_dirty(cursor_y);
+		move_cursor_locked(cursor_x + 1, cursor_y);
 	}
 }
 
@@ -393,6 +496,18 @@ g_key_info gui_screen_t::readInput() {
 void gui_screen_t::moveCursor(int x, int y) {
 
 	raster_lock.lock();
+	move_cursor_locked(x, y);
+	raster_lock.unlock();
+
+	repaint();
+}
+
+/**
+ *
+ */
+void gui_screen_t::move_cursor_locked(int x, int y) {
+
+	mark_line_dirty(cursor_y);
 	cursor_x = x;
 	cursor_y = y;
 
@@ -411,18 +526,21 @@ void gui_screen_t::moveCursor(int x, int y) {
 		int raster_width = raster_size.width;
 		int raster_bytes = raster_width * raster_size.height;
 
-		memcpy(raster_buffer, &raster_buffer[raster_width], raster_bytes - raster_width);
+		memmove(raster_buffer, &raster_buffer[raster_width], raster_bytes - raster_width);
 
 		for (uint32_t i = 0; i < raster_width; i++) {
 			raster_buffer[raster_bytes - raster_width + i] = ' ';
 		}
 
+		// dirty lines move along, the exposed line is new
+		memmove(dirty_lines, &dirty_lines[1], raster_size.height - 1);
+		dirty_lines[raster_size.height - 1] = 1;
+		scrolled_lines++;
+
 		cursor_y--;
 	}
 
-	raster_lock.unlock();
-
-	repaint();
+	mark_line_dirty(cursor_y);
 }
 
 /**
@@ -493,6 +611,13 @@ void gui_screen_t::update_visible_buffer_size() {
 		raster_size = g_dimension(required_width, required_height);
 		memset(raster_buffer, 0, required_width * required_height);
 
+		if (dirty_lines) {
+			delete[] dirty_lines;
+		}
+		dirty_lines = new uint8_t[required_height];
+		memset(dirty_lines, 0, required_height);
+		repaint_all = true;
+
 		// Copy contents of old buffer and delete it
 		if (old_buffer) {
 			for (int y = 0; y < old_buffer_size.height; y++) {
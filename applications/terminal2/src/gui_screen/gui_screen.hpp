@@ -37,18 +37,9 @@
 #include <ghostuser/tasking/lock.hpp>
 #include <ghostuser/graphics/text/font_loader.hpp>
 #include <ghostuser/graphics/text/font.hpp>
+#include <ghostuser/graphics/text/glyph_atlas.hpp>
 #include <ghostuser/graphics/text/text_layouter.hpp>
 
-/**
- * Used to cache information about the layout of a specific character.
- */
-struct char_layout_t {
-	cairo_glyph_t* glyph_buffer = nullptr;
-	int glyph_count;
-	cairo_text_cluster_t* cluster_buffer = nullptr;
-	int cluster_count;
-};
-
 /**
  *
  */
@@ -61,6 +52,7 @@ private:
 	g_canvas* canvas;
 
 	g_font* font;
+	g_glyph_atlas* atlas = 0;
 
 	cairo_surface_t* existingSurface = 0;
 	uint8_t* existingSurfaceBuffer = 0;
@@ -86,11 +78,19 @@ private:
 	int cursor_x = 0;
 	int cursor_y = 0;
 
+	/**
+	 * Damage since the last paint, protected by the raster lock. Lines are
+	 * marked in the dirty list, scrolling is remembered as a line count so
+	 * that the painted canvas can be moved instead of repainted.
+	 */
+	uint8_t* dirty_lines = 0;
+	int scrolled_lines = 0;
+	bool repaint_all = true;
+	bool cursor_painted = false;
+
 	int char_width = 8;
 	int char_height = 12;
 
-	std::map<char, char_layout_t*> char_layout_cache;
-
 	/**
 	 * Prepares the canvas buffer for painting.
 	 *
@@ -115,9 +115,36 @@ private:
 	void paint();
 
 	/**
+	 * Repaints the band of the canvas that belongs to the raster "line".
+	 * Glyphs may reach into the neighbouring bands, so those lines are
+	 * painted as well, clipped to the band.
 	 *
+	 * @return whether the band is within the canvas
+	 */
+	bool paint_line(cairo_t* cr, int line, bool blink_on);
+
+	/**
+	 * Moves the painted canvas content up by "pixels" rows.
+	 */
+	void scroll_canvas(int pixels);
+
+	/**
+	 * Marks the raster "line" for repainting. Must be called while
+	 * holding the raster lock.
+	 */
+	void mark_line_dirty(int line);
+
+	/**
+	 * Puts the character "c" at the cursor and advances it. Must be called
+	 * while holding the raster lock.
+	 */
+	void put_char(char c);
+
+	/**
+	 * Moves the cursor, wrapping and scrolling as required. Must be called
+	 * while holding the raster lock.
 	 */
-	char_layout_t* get_char_layout(cairo_scaled_font_t* scaled_face, char c);
+	void move_cursor_locked(int x, int y);
 
 public:
 	/**
@@ -130,6 +157,7 @@ public:
 	g_key_info readInput();
 	void clean();
 	void writeChar(char c);
+	void writeString(const char* text, int length);
 	void moveCursor(int x, int y);
 	int getCursorX();
 	int getCursorY();
@@ -80,6 +80,17 @@ public:
 	virtual void clean() = 0;
 	virtual void backspace() = 0;
 	virtual void writeChar(char c) = 0;
+
+	/**
+	 * Writes a run of "length" characters. Screens that can place a whole run
+	 * cheaper than character by character override this.
+	 */
+	virtual void writeString(const char* text, int length) {
+		for (int i = 0; i < length; i++) {
+			writeChar(text[i]);
+		}
+	}
+
 	virtual void moveCursor(int x, int y) = 0;
 	virtual int getCursorX() = 0;
 	virtual int getCursorY() = 0;
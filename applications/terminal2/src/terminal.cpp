@@ -322,14 +322,31 @@ void terminal_t::output_routine(output_routine_startinfo_t* info) {
 
 		if (stat == G_FS_READ_SUCCESSFUL) {
 
-			for (int i = 0; i < r; i++) {
-				char c = buf[i];
+			// Process the whole buffer with the screen locked once
+			info->terminal->screen_lock.lock();
 
-				// Lock screen and set error color if required
-				info->terminal->screen_lock.lock();
-				info->terminal->process_output_character(&status, info->error_output, c);
-				info->terminal->screen_lock.unlock();
+			int i = 0;
+			while (i < r) {
+
+				// Hand runs of plain text to the screen at once
+				if (status.status == TERMINAL_STREAM_STATUS_TEXT) {
+					int end = i;
+					while (end < r && buf[end] != '\r' && buf[end] != '\t' && buf[end] != 27 /* ESC */) {
+						++end;
+					}
+
+					if (end > i) {
+						info->terminal->process_output_text(info->error_output, &buf[i], end - i);
+						i = end;
+						continue;
+					}
+				}
+
+				info->terminal->process_output_character(&status, info->error_output, buf[i]);
+				++i;
 			}
+
+			info->terminal->screen_lock.unlock();
 		} else {
 			break;
 		}
@@ -340,6 +357,21 @@ void terminal_t::output_routine(output_routine_startinfo_t* info) {
 	delete info;
 }
 
+/**
+ *
+ */
+void terminal_t::process_output_text(bool error_stream, const char* text, int length) {
+
+	int fg = screen->getColorForeground();
+	if (error_stream) {
+		screen->setColorForeground(SC_RED);
+	}
+	screen->writeString(text, length);
+	if (error_stream) {
+		screen->setColorForeground(fg);
+	}
+}
+
 /**
  *
  */
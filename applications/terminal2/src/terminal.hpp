@@ -118,6 +118,7 @@ public:
 	/**
 	 *
 	 */
+	void process_output_text(bool error_stream, const char* text, int length);
 	void process_output_character(stream_control_status_t* status, bool error_stream, char c);
 	void process_vt100_sequence(stream_control_status_t* status);
 	static screen_color_t convert_vt100_to_screen_color(int color);
@@ -220,6 +220,9 @@ int main(int argc, char** argv) {
 
 		// Get the surface ready and go:
 		if (surface == 0 || surfaceBuffer != bufferInfo.buffer) {
+			if (surface != 0) {
+				cairo_surface_destroy(surface);
+			}
 			surface = cairo_image_surface_create_for_data((uint8_t*) bufferInfo.buffer, CAIRO_FORMAT_ARGB32, bufferInfo.width, bufferInfo.height,
 					cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, bufferInfo.width));
 			surfaceBuffer = bufferInfo.buffer;
@@ -301,6 +304,7 @@ int main(int argc, char** argv) {
 		}
 
 		// Blit the content to screen
+		cairo_destroy(cr);
 		canvas->blit(g_rectangle(0, 0, bufferInfo.width, bufferInfo.height));
 
 		//g_sleep(100);
@@ -89,6 +89,24 @@ bool setVideoMode(uint32_t mode, bool flatFrameBuffer) {
 	return (out.ax == 0x4F);
 }
 
+/**
+ * Sets the pixel that is shown in the upper left corner, waiting for the
+ * vertical retrace so that switching between pages does not tear.
+ */
+bool setDisplayStart(uint16_t x, uint16_t y) {
+	g_vm86_registers out;
+	g_vm86_registers regs;
+
+	regs.ax = 0x4F07;
+	regs.bx = 0x0080;
+	regs.cx = x;
+	regs.dx = y;
+
+	g_call_vm86(0x10, &regs, &out);
+
+	return (out.ax == 0x4F);
+}
+
 /**
  *
  */
@@ -187,8 +205,15 @@ bool setVideoMode(uint32_t wantedWidth, uint32_t wantedHeight, uint32_t wantedBp
 				// Reloading successful?
 				if (couldReloadModeInfo) {
 
-					// Create MMIO mapping
-					void* area = g_map_mmio((void*) modeInfoBlock->lfbPhysicalBase, modeInfoBlock->linBytesPerScanline * modeInfoBlock->resolutionY);
+					// Use two pages for flipping if the video memory is large enough; the
+					// number of images field only exists for the LFB since VBE 3.0
+					uint32_t screenSize = modeInfoBlock->linBytesPerScanline * modeInfoBlock->resolutionY;
+					uint32_t videoMemory = vbeInfoBlock->memoryBlockCount * 0x10000;
+					uint32_t imagePages = (vbeInfoBlock->version >= 0x300) ? modeInfoBlock->linNumberOfImagePages : modeInfoBlock->imagePages;
+					uint32_t pages = (imagePages >= 1 && videoMemory >= screenSize * 2) ? 2 : 1;
+
+					// Create MMIO mapping, write-combined as the framebuffer is only written
+					void* area = g_map_mmio_f((void*) modeInfoBlock->lfbPhysicalBase, screenSize * pages, G_MMIO_FLAG_WRITE_COMBINING);
 
 					// Write out
 					result.resolutionX = modeInfoBlock->resolutionX;
@@ -196,6 +221,7 @@ bool setVideoMode(uint32_t wantedWidth, uint32_t wantedHeight, uint32_t wantedBp
 					result.bpp = modeInfoBlock->bpp;
 					result.bytesPerScanline = modeInfoBlock->linBytesPerScanline;
 					result.lfb = area;
+					result.pages = pages;
 					successful = true;
 				}
 			}
@@ -222,7 +248,9 @@ int main() {
 
 	g_logger::log("initialized");
 
-	size_t buflen = sizeof(g_message_header) + sizeof(g_vbe_set_mode_request);
+	size_t buflen = sizeof(g_message_header)
+			+ (sizeof(g_vbe_set_mode_request) > sizeof(g_vbe_set_display_start_request) ?
+					sizeof(g_vbe_set_mode_request) : sizeof(g_vbe_set_display_start_request));
 	uint8_t buf[buflen];
 
 	while (true) {
@@ -253,7 +281,7 @@ int main() {
 			klog("attempting to set video mode");
 			if (setVideoMode(resX, resY, bpp, result)) {
 				g_logger::log("changed video mode to %ix%ix%i", resX, resY, bpp);
-				uint32_t lfbSize = result.bytesPerScanline * result.resolutionY;
+				uint32_t lfbSize = result.bytesPerScanline * result.resolutionY * result.pages;
 				void* addressInRequestersSpace = g_share_mem(result.lfb, lfbSize, requester);
 
 				response.status = G_VBE_SET_MODE_STATUS_SUCCESS;
@@ -262,6 +290,7 @@ int main() {
 				response.mode_info.resY = result.resolutionY;
 				response.mode_info.bpp = (uint8_t) result.bpp;
 				response.mode_info.bpsl = (uint16_t) result.bytesPerScanline;
+				response.mode_info.pages = (uint16_t) result.pages;
 
 			} else {
 				g_logger::log("unable to switch to video resolution %ix%ix%i", resX, resY, bpp);
@@ -270,6 +299,18 @@ int main() {
 
 			// send response
 			g_send_message_t(header->sender, &response, sizeof(g_vbe_set_mode_response), header->transaction);
+
+		} else if (vbeheader->command == G_VBE_COMMAND_SET_DISPLAY_START) {
+			g_vbe_set_display_start_request* request = (g_vbe_set_display_start_request*) G_MESSAGE_CONTENT(buf);
+
+			g_vbe_set_display_start_response response;
+			if (setDisplayStart(request->x, request->y)) {
+				response.status = G_VBE_SET_DISPLAY_START_STATUS_SUCCESS;
+			} else {
+				response.status = G_VBE_SET_DISPLAY_START_STATUS_FAILED;
+			}
+			g_send_message_t(header->sender, &response, sizeof(g_vbe_set_display_start_response), header->transaction);
+
 		} else {
 			g_logger::log("received unknown command %i from task %i", vbeheader->command, header->sender);
 		}
@@ -118,6 +118,7 @@ struct VesaVideoInfo {
 	uint8_t bpp;
 	uint32_t bytesPerScanline;
 	void* lfb;
+	uint32_t pages;
 };
 
 #endif
@@ -22,7 +22,13 @@
 #include <string.h>
 #include <components/canvas.hpp>
 
-#define ALIGN_UP(value)		(value + value % 20)
+/**
+ * Buffers are allocated with some slack, so that resizing a window does not
+ * create a new buffer on every step. They are only replaced by a smaller one
+ * once less than half of the buffer is used.
+ */
+#define CANVAS_BUFFER_DIMENSION(value)	(((value) + (value) / 8 + 15) & ~15)
+
 /**
  *
  */
@@ -41,25 +47,23 @@ canvas_t::canvas_t(g_tid partnerThread) :
  */
 void canvas_t::handleBoundChange(g_rectangle oldBounds) {
 
+	// the surface lost its content, take the next frame completely
+	currentBuffer.presented = false;
 	checkBuffer();
 }
 
 /**
- * Checks whether the current buffer is still sufficient for the required amount of pixels.
+ * Checks whether the current buffer is still suitable for the required amount of pixels.
  *
- * If the buffer is not sufficient and was acknowledged, a new buffer is allocated and an event is
- * sent to the client so it knows the new buffer must be acknowledged.
+ * If the buffer is too small or mostly unused and was acknowledged, a new buffer is allocated
+ * and an event is sent to the client so it knows the new buffer must be acknowledged.
  *
- * If the buffer is not sufficient but was not yet acknowledged by the client, we wait until the current
+ * If the buffer is not suitable but was not yet acknowledged by the client, we wait until the current
  * one is acknowledged to then create a new buffer later on.
  */
 void canvas_t::checkBuffer() {
 
-	// calculate how many pages we need for the shared area
 	g_rectangle bounds = getBounds();
-	uint32_t requiredSize = G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE
-			+ cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, ALIGN_UP(bounds.width)) * ALIGN_UP(bounds.height);
-	uint16_t requiredPages = G_PAGE_ALIGN_UP(requiredSize) / G_PAGE_SIZE;
 
 	// if next buffer not yet acknowledged, ask client to acknowledge it
 	if (nextBuffer.localMapping != nullptr && !nextBuffer.acknowledged) {
@@ -70,14 +74,15 @@ void canvas_t::checkBuffer() {
 
 		// if there is no buffer yet, create one
 	} else if (currentBuffer.localMapping == nullptr) {
-		createNewBuffer(requiredPages);
+		createNewBuffer(bounds);
 
-		// if current buffer is acknowledged but too small, create a new one
+		// if current buffer is acknowledged but too small or too large, create a new one
 	} else if (currentBuffer.acknowledged) {
 
-		g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer.localMapping;
-		if (header->paintable_width < bounds.width || header->paintable_height < bounds.height) {
-			createNewBuffer(requiredPages);
+		bool tooSmall = currentBuffer.paintableWidth < bounds.width || currentBuffer.paintableHeight < bounds.height;
+		bool tooLarge = (uint32_t) bounds.width * bounds.height * 2 < (uint32_t) currentBuffer.paintableWidth * currentBuffer.paintableHeight;
+		if (tooSmall || tooLarge) {
+			createNewBuffer(bounds);
 		}
 	}
 
@@ -86,15 +91,27 @@ void canvas_t::checkBuffer() {
 /**
  *
  */
-void canvas_t::createNewBuffer(uint16_t requiredPages) {
+void canvas_t::createNewBuffer(g_rectangle bounds) {
 
-	g_rectangle bounds = getBounds();
+	// a pending buffer must be acknowledged first, otherwise it would leak
+	if (nextBuffer.localMapping != nullptr) {
+		mustCheckAgain = true;
+		return;
+	}
 
-	// TODO this is leaking memory when creating a buffer before the current "nextBuffer" was acknowledged
+	// calculate how many pages we need for the shared area
+	uint16_t paintableWidth = CANVAS_BUFFER_DIMENSION(bounds.width);
+	uint16_t paintableHeight = CANVAS_BUFFER_DIMENSION(bounds.height);
+	uint32_t bufferSize = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, paintableWidth) * paintableHeight;
+	uint32_t requiredSize = G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE + G_UI_CANVAS_BUFFER_COUNT * bufferSize;
+	uint32_t requiredPages = G_PAGE_ALIGN_UP(requiredSize) / G_PAGE_SIZE;
 
 	// create a new buffer
 	nextBuffer.acknowledged = false;
 	nextBuffer.pages = requiredPages;
+	nextBuffer.paintableWidth = paintableWidth;
+	nextBuffer.paintableHeight = paintableHeight;
+	nextBuffer.bufferSize = bufferSize;
 	nextBuffer.localMapping = (uint8_t*) g_alloc_mem(requiredPages * G_PAGE_SIZE);
 
 	if (nextBuffer.localMapping == 0) {
@@ -108,18 +125,24 @@ void canvas_t::createNewBuffer(uint16_t requiredPages) {
 	if (nextBuffer.remoteMapping == 0) {
 		klog("warning: failed to share a buffer for a canvas to proc %i", partnerProcess);
 		g_unmap(nextBuffer.localMapping);
+		nextBuffer.localMapping = nullptr;
 		return;
 	}
 
-	// initialize the header
+	// initialize the header, the client starts painting to the first buffer
 	g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) nextBuffer.localMapping;
-	header->paintable_width = ALIGN_UP(bounds.width);
-	header->paintable_height = ALIGN_UP(bounds.height);
-	header->blit_x = 0;
-	header->blit_y = 0;
-	header->blit_width = 0;
-	header->blit_height = 0;
-	header->ready = false;
+	header->paintable_width = paintableWidth;
+	header->paintable_height = paintableHeight;
+	header->buffer_size = bufferSize;
+	for (int i = 0; i < G_UI_CANVAS_BUFFER_COUNT; i++) {
+		header->buffers[i].frame = 0;
+		header->buffers[i].damage_count = 0;
+	}
+	header->present = 1;
+
+	nextBuffer.front = 2;
+	nextBuffer.frame = 0;
+	nextBuffer.presented = false;
 
 	requestClientToAcknowledgeNewBuffer();
 }
@@ -148,6 +171,10 @@ void canvas_t::requestClientToAcknowledgeNewBuffer() {
  */
 void canvas_t::clientHasAcknowledgedCurrentBuffer() {
 
+	if (nextBuffer.localMapping == nullptr) {
+		return;
+	}
+
 	// previous buffer can be deleted
 	if (currentBuffer.localMapping != nullptr) {
 		g_unmap(currentBuffer.localMapping);
@@ -158,9 +185,6 @@ void canvas_t::clientHasAcknowledgedCurrentBuffer() {
 	currentBuffer.acknowledged = true;
 	nextBuffer.localMapping = 0;
 
-	g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer.localMapping;
-	header->ready = false;
-
 	// if the window was resized during an un-acknowledged state, we must now create a new buffer
 	if (mustCheckAgain) {
 		mustCheckAgain = false;
@@ -182,22 +206,64 @@ void canvas_t::paint() {
 
 		g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer.localMapping;
 
-		if (header->ready) {
-			header->ready = false;
-
-			// make background empty
-			clearSurface();
+		// take the latest presented buffer, handing the previous one back
+		if (header->present & G_UI_CANVAS_PRESENT_NEW) {
+			uint32_t presented = __sync_lock_test_and_set(&header->present, currentBuffer.front);
+			currentBuffer.front = presented & G_UI_CANVAS_PRESENT_INDEX_MASK;
+			if (currentBuffer.front >= G_UI_CANVAS_BUFFER_COUNT) {
+				return;
+			}
+
+			// the client may change the header at any time, so each value is read only once
+			g_ui_canvas_buffer_header* frame = &header->buffers[currentBuffer.front];
+			uint32_t frameNumber = *((volatile uint32_t*) &frame->frame);
+			uint32_t damageCount = *((volatile uint16_t*) &frame->damage_count);
+			g_ui_canvas_damage_rect damage[G_UI_CANVAS_MAXIMUM_DAMAGE];
+			if (damageCount <= G_UI_CANVAS_MAXIMUM_DAMAGE) {
+				memcpy(damage, frame->damage, damageCount * sizeof(g_ui_canvas_damage_rect));
+			}
+
+			// the damage is only complete if no frame was skipped
+			bool complete = !currentBuffer.presented || frameNumber != currentBuffer.frame + 1 || damageCount > G_UI_CANVAS_MAXIMUM_DAMAGE;
+			currentBuffer.frame = frameNumber;
+			currentBuffer.presented = true;
 
 			// create a cairo surface from the buffer
-			uint8_t* bufferContent = (uint8_t*) (currentBuffer.localMapping + G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE);
-			cairo_surface_t* bufferSurface = cairo_image_surface_create_for_data(bufferContent, CAIRO_FORMAT_ARGB32, header->paintable_width,
-					header->paintable_height, cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, header->paintable_width));
+			uint16_t paintableWidth = currentBuffer.paintableWidth;
+			uint16_t paintableHeight = currentBuffer.paintableHeight;
+			uint8_t* bufferContent = currentBuffer.localMapping + G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE + currentBuffer.front * currentBuffer.bufferSize;
+			cairo_surface_t* bufferSurface = cairo_image_surface_create_for_data(bufferContent, CAIRO_FORMAT_ARGB32, paintableWidth, paintableHeight,
+					cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, paintableWidth));
+			cairo_save(cr);
 			cairo_set_source_surface(cr, bufferSurface, 0, 0);
 			cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-			cairo_paint(cr);
 
-			// mark painted area as dirty
-			markDirty(g_rectangle(header->blit_x, header->blit_y, header->blit_width, header->blit_height));
+			if (complete) {
+				clearSurface();
+				cairo_paint(cr);
+				markDirty(g_rectangle(0, 0, bounds.width, bounds.height));
+
+			} else {
+				// copy and mark only the damaged areas
+				for (uint32_t i = 0; i < damageCount; i++) {
+					g_rectangle rect(damage[i].x, damage[i].y, damage[i].width, damage[i].height);
+					if (rect.x >= paintableWidth || rect.y >= paintableHeight) {
+						continue;
+					}
+					if (rect.x + rect.width > paintableWidth) {
+						rect.width = paintableWidth - rect.x;
+					}
+					if (rect.y + rect.height > paintableHeight) {
+						rect.height = paintableHeight - rect.y;
+					}
+					cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+					markDirty(rect);
+				}
+				cairo_fill(cr);
+			}
+
+			cairo_restore(cr);
+			cairo_surface_destroy(bufferSurface);
 		}
 	}
 }
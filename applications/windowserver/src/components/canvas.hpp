@@ -29,8 +29,24 @@
 struct buffer_info_t {
 	uint8_t* localMapping;
 	uint8_t* remoteMapping;
-	uint16_t pages;
+	uint32_t pages;
 	bool acknowledged;
+
+	/**
+	 * Dimensions of the buffers as created by the window server. The header
+	 * is writable by the client, so it is never used for these.
+	 */
+	uint16_t paintableWidth;
+	uint16_t paintableHeight;
+	uint32_t bufferSize;
+
+	/**
+	 * Index of the buffer that the window server currently reads from and
+	 * the number of the frame it contains.
+	 */
+	uint8_t front;
+	uint32_t frame;
+	bool presented;
 };
 
 /**
@@ -56,13 +72,13 @@ public:
 
 	virtual void handleBoundChange(g_rectangle oldBounds);
 
-	void createNewBuffer(uint16_t requiredPages);
 	void clientHasAcknowledgedCurrentBuffer();
 	void requestClientToAcknowledgeNewBuffer();
 	void blit();
 
 private:
 	void checkBuffer();
+	void createNewBuffer(g_rectangle bounds);
 };
 
 #endif
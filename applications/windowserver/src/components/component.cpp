@@ -54,7 +54,7 @@ void component_t::setBounds(const g_rectangle& newBounds) {
 	g_rectangle oldBounds = bounds;
 
 	// Mark area of old bounds as dirty
-	markDirty();
+	markDirtyInParent();
 
 	// Write new bounds value
 	bounds = newBounds;
@@ -66,7 +66,7 @@ void component_t::setBounds(const g_rectangle& newBounds) {
 	}
 
 	// Mark area of new bounds as dirty
-	markDirty();
+	markDirtyInParent();
 
 	// If either width or height have changed, resize buffer
 	if (oldBounds.width != bounds.width || oldBounds.height != bounds.height) {
@@ -126,10 +126,6 @@ void component_t::markDirty(g_rectangle rect) {
 void component_t::blit(g_graphics* out, g_rectangle absClip, g_point position) {
 
 	if (this->visible) {
-		if (graphics.getContext() != 0) {
-			graphics.blitTo(out, absClip, position);
-		}
-
 		g_rectangle ownAbsBounds = getBounds();
 		ownAbsBounds.x = position.x;
 		ownAbsBounds.y = position.y;
@@ -138,7 +134,16 @@ void component_t::blit(g_graphics* out, g_rectangle absClip, g_point position) {
 		int newLeft = absClip.getLeft() > ownAbsBounds.getLeft() ? absClip.getLeft() : ownAbsBounds.getLeft();
 		int newRight = absClip.getRight() < ownAbsBounds.getRight() ? absClip.getRight() : ownAbsBounds.getRight();
 
+		// Components (and their children) outside the damaged area are skipped
+		if (newRight <= newLeft || newBottom <= newTop) {
+			return;
+		}
+
 		g_rectangle thisClip = g_rectangle(newLeft, newTop, newRight - newLeft, newBottom - newTop);
+		if (graphics.getContext() != 0) {
+			graphics.blitTo(out, thisClip, position);
+		}
+
 		children_lock.lock();
 
 		for (auto& c : children) {
@@ -449,12 +454,16 @@ void component_t::resolveRequirement(component_requirement_t req) {
 
 	if (childRequirements & req) {
 		children_lock.lock();
+
+		// cleared before resolving, so requirements that are placed meanwhile
+		// remain for the next frame; hidden children mark their parent again
+		// once they become visible
+		childRequirements &= ~req;
 		for (auto& child : children) {
 			if (child.component->visible) {
 				child.component->resolveRequirement(req);
 			}
 		}
-		childRequirements &= ~COMPONENT_REQUIREMENT_NONE;
 		children_lock.unlock();
 	}
 
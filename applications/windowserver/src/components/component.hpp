@@ -81,8 +81,6 @@ class component_t: public bounds_event_component_t {
 private:
 	g_rectangle bounds;
 	component_t* parent;
-	std::vector<component_child_reference_t> children;
-	g_lock children_lock;
 
 
 	g_dimension minimumSize;
@@ -97,6 +95,9 @@ private:
 	int z_index = 1000;
 
 protected:
+	std::vector<component_child_reference_t> children;
+	g_lock children_lock;
+
 	layout_manager_t* layoutManager;
 	g_graphics graphics;
 
@@ -225,7 +226,16 @@ public:
 	 * @param absClip	absolute bounds that may not be exceeded
 	 * @param position	absolute screen position to blit to
 	 */
-	void blit(g_graphics* out, g_rectangle absClip, g_point position);
+	virtual void blit(g_graphics* out, g_rectangle absClip, g_point position);
+
+	/**
+	 * Returns the area (relative to the component) that is completely covered
+	 * by opaque pixels once the component and its children are blitted. Things
+	 * behind this area are not visible and are skipped when compositing.
+	 */
+	virtual g_rectangle getOpaqueArea() {
+		return g_rectangle();
+	}
 
 	/**
 	 * Adds the given component as a child to this component
@@ -321,6 +331,23 @@ public:
 		markDirty(g_rectangle(0, 0, bounds.width, bounds.height));
 	}
 
+	/**
+	 * Whether this component or any of its children has unresolved requirements.
+	 */
+	bool hasRequirements() const {
+		return ((requirements | childRequirements) & (COMPONENT_REQUIREMENT_UPDATE | COMPONENT_REQUIREMENT_LAYOUT | COMPONENT_REQUIREMENT_PAINT)) != 0;
+	}
+
+	/**
+	 * Marks the area that the component covers in its parent as dirty, without
+	 * invalidating the content of the component itself (like when it is moved).
+	 */
+	void markDirtyInParent() {
+		if (parent) {
+			parent->markDirty(bounds);
+		}
+	}
+
 	/**
 	 * Places the flag for the given requirement on the parent component (if non-null).
 	 */
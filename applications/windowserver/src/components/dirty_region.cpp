@@ -0,0 +1,186 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <components/dirty_region.hpp>
+
+/**
+ *
+ */
+static int area(const g_rectangle& rect) {
+	return rect.width * rect.height;
+}
+
+/**
+ *
+ */
+static bool contains(const g_rectangle& outer, const g_rectangle& inner) {
+	return inner.getLeft() >= outer.getLeft() && inner.getTop() >= outer.getTop() && inner.getRight() <= outer.getRight()
+			&& inner.getBottom() <= outer.getBottom();
+}
+
+/**
+ *
+ */
+static g_rectangle unite(const g_rectangle& a, const g_rectangle& b) {
+	int left = a.getLeft() < b.getLeft() ? a.getLeft() : b.getLeft();
+	int top = a.getTop() < b.getTop() ? a.getTop() : b.getTop();
+	int right = a.getRight() > b.getRight() ? a.getRight() : b.getRight();
+	int bottom = a.getBottom() > b.getBottom() ? a.getBottom() : b.getBottom();
+	return g_rectangle(left, top, right - left, bottom - top);
+}
+
+/**
+ *
+ */
+void dirty_region_t::remove(int index) {
+	rectangles[index] = rectangles[--count];
+}
+
+/**
+ *
+ */
+void dirty_region_t::add(g_rectangle rect) {
+
+	if (rect.width <= 0 || rect.height <= 0) {
+		return;
+	}
+
+	for (int i = 0; i < count;) {
+		g_rectangle& existing = rectangles[i];
+		if (contains(existing, rect)) {
+			return;
+		}
+
+		// merge if the union wastes at most a quarter of the covered area;
+		// the merged rectangle may now touch others, so start over
+		g_rectangle united = unite(existing, rect);
+		if (area(united) * 4 <= (area(existing) + area(rect)) * 5) {
+			remove(i);
+			rect = united;
+			i = 0;
+			continue;
+		}
+		i++;
+	}
+
+	if (count == DIRTY_REGION_MAXIMUM_RECTANGLES) {
+		int best = 0;
+		int bestGrowth = -1;
+		for (int i = 0; i < count; i++) {
+			int growth = area(unite(rectangles[i], rect)) - area(rectangles[i]);
+			if (bestGrowth == -1 || growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+
+		g_rectangle united = unite(rectangles[best], rect);
+		remove(best);
+		add(united);
+		return;
+	}
+
+	rectangles[count++] = rect;
+}
+
+/**
+ *
+ */
+void dirty_region_t::clip(g_rectangle bounds) {
+
+	for (int i = 0; i < count;) {
+		g_rectangle& rect = rectangles[i];
+		int left = rect.getLeft() > bounds.getLeft() ? rect.getLeft() : bounds.getLeft();
+		int top = rect.getTop() > bounds.getTop() ? rect.getTop() : bounds.getTop();
+		int right = rect.getRight() < bounds.getRight() ? rect.getRight() : bounds.getRight();
+		int bottom = rect.getBottom() < bounds.getBottom() ? rect.getBottom() : bounds.getBottom();
+
+		if (right <= left || bottom <= top) {
+			remove(i);
+			continue;
+		}
+
+		rect = g_rectangle(left, top, right - left, bottom - top);
+		i++;
+	}
+}
+
+/**
+ *
+ */
+void dirty_region_t::subtract(g_rectangle cut) {
+
+	if (cut.width <= 0 || cut.height <= 0) {
+		return;
+	}
+
+	g_rectangle result[DIRTY_REGION_MAXIMUM_RECTANGLES];
+	int resultCount = 0;
+
+	for (int i = 0; i < count; i++) {
+		const g_rectangle& rect = rectangles[i];
+		int left = rect.getLeft() > cut.getLeft() ? rect.getLeft() : cut.getLeft();
+		int top = rect.getTop() > cut.getTop() ? rect.getTop() : cut.getTop();
+		int right = rect.getRight() < cut.getRight() ? rect.getRight() : cut.getRight();
+		int bottom = rect.getBottom() < cut.getBottom() ? rect.getBottom() : cut.getBottom();
+
+		// split into the parts above, below, left and right of the overlap
+		g_rectangle pieces[4];
+		int pieceCount = 0;
+		if (right <= left || bottom <= top) {
+			pieces[pieceCount++] = rect;
+		} else {
+			pieces[pieceCount++] = g_rectangle(rect.x, rect.y, rect.width, top - rect.y);
+			pieces[pieceCount++] = g_rectangle(rect.x, bottom, rect.width, rect.getBottom() - bottom);
+			pieces[pieceCount++] = g_rectangle(rect.x, top, left - rect.x, bottom - top);
+			pieces[pieceCount++] = g_rectangle(right, top, rect.getRight() - right, bottom - top);
+		}
+
+		for (int p = 0; p < pieceCount; p++) {
+			if (pieces[p].width <= 0 || pieces[p].height <= 0) {
+				continue;
+			}
+			if (resultCount == DIRTY_REGION_MAXIMUM_RECTANGLES) {
+				return;
+			}
+			result[resultCount++] = pieces[p];
+		}
+	}
+
+	for (int i = 0; i < resultCount; i++) {
+		rectangles[i] = result[i];
+	}
+	count = resultCount;
+}
+
+/**
+ *
+ */
+bool dirty_region_t::intersects(g_rectangle other) const {
+
+	for (int i = 0; i < count; i++) {
+		const g_rectangle& rect = rectangles[i];
+		if (rect.getLeft() < other.getRight() && other.getLeft() < rect.getRight() && rect.getTop() < other.getBottom()
+				&& other.getTop() < rect.getBottom()) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __DIRTY_REGION__
+#define __DIRTY_REGION__
+
+#include <ghostuser/graphics/metrics/rectangle.hpp>
+
+/**
+ * Maximum number of rectangles in a region. If more areas are damaged, the
+ * rectangles that grow the least when united are merged.
+ */
+#define DIRTY_REGION_MAXIMUM_RECTANGLES	16
+
+/**
+ * A small set of rectangles describing the damaged areas of the screen.
+ * Rectangles that overlap or lie close to each other are merged when added,
+ * so that distant damage (like a caret and a clock in opposite corners) does
+ * not invalidate everything in between.
+ */
+class dirty_region_t {
+private:
+	g_rectangle rectangles[DIRTY_REGION_MAXIMUM_RECTANGLES];
+	int count;
+
+	void remove(int index);
+
+public:
+	dirty_region_t() :
+			count(0) {
+	}
+
+	/**
+	 * Adds the rectangle to the region, merging it with existing rectangles
+	 * if the united rectangle does not cover much more area than both.
+	 */
+	void add(g_rectangle rect);
+
+	/**
+	 * Cuts all rectangles to the given bounds.
+	 */
+	void clip(g_rectangle bounds);
+
+	/**
+	 * Cuts the given rectangle out of the region. If the remaining pieces do
+	 * not fit into the region, it is left unchanged; it may then cover more
+	 * than necessary but never less.
+	 */
+	void subtract(g_rectangle cut);
+
+	/**
+	 * Checks whether any rectangle of the region overlaps the given one.
+	 */
+	bool intersects(g_rectangle other) const;
+
+	/**
+	 *
+	 */
+	void clear() {
+		count = 0;
+	}
+
+	/**
+	 *
+	 */
+	bool isEmpty() const {
+		return count == 0;
+	}
+
+	/**
+	 *
+	 */
+	int getCount() const {
+		return count;
+	}
+
+	/**
+	 *
+	 */
+	g_rectangle get(int index) const {
+		return rectangles[index];
+	}
+};
+
+#endif
@@ -25,33 +25,100 @@
  */
 void screen_t::markDirty(g_rectangle rect) {
 
-	// Mark area as invalid
-	if (invalid.x == 0 && invalid.y == 0 && invalid.width == 0 && invalid.height == 0) {
-		invalid = rect;
+	invalid_lock.lock();
+	invalid.add(rect);
+	invalid.clip(g_rectangle(0, 0, getBounds().width, getBounds().height));
+	invalid_lock.unlock();
+}
+
+/**
+ *
+ */
+bool screen_t::hasInvalid() {
+
+	invalid_lock.lock();
+	bool result = !invalid.isEmpty();
+	invalid_lock.unlock();
+	return result;
+}
 
-	} else {
-		int top = rect.getTop() < invalid.getTop() ? rect.getTop() : invalid.getTop();
-		int left = rect.getLeft() < invalid.getLeft() ? rect.getLeft() : invalid.getLeft();
-		int bottom = rect.getBottom() > invalid.getBottom() ? rect.getBottom() : invalid.getBottom();
-		int right = rect.getRight() > invalid.getRight() ? rect.getRight() : invalid.getRight();
+/**
+ *
+ */
+dirty_region_t screen_t::grabInvalid() {
+
+	invalid_lock.lock();
+	dirty_region_t ret = invalid;
+	invalid.clear();
+	invalid_lock.unlock();
+	return ret;
+}
 
-		invalid = g_rectangle(left, top, right - left, bottom - top);
+/**
+ *
+ */
+void screen_t::blit(g_graphics* out, g_rectangle absClip, g_point position) {
+
+	if (!visible) {
+		return;
 	}
 
-	// Fix invalid area
-	if (invalid.x < 0) {
-		invalid.width += invalid.x;
-		invalid.x = 0;
+	g_rectangle bounds = getBounds();
+	dirty_region_t remaining;
+	remaining.add(absClip);
+	remaining.clip(g_rectangle(position.x, position.y, bounds.width, bounds.height));
+	if (remaining.isEmpty()) {
+		return;
 	}
-	if (invalid.y < 0) {
-		invalid.height += invalid.y;
-		invalid.y = 0;
+
+	if (graphics.getContext() != 0) {
+		graphics.blitTo(out, remaining.get(0), position);
 	}
-	if (invalid.x + invalid.width > getBounds().width) {
-		invalid.width = getBounds().width - invalid.x;
+
+	children_lock.lock();
+
+	// walk from front to back and cut the opaque area of each child out of
+	// the region that is visible to the children behind it
+	int count = children.size();
+	std::vector<dirty_region_t> visibleRegions(count);
+	int first = 0;
+	for (int i = count - 1; i >= 0; i--) {
+		component_t* child = children[i].component;
+		if (!child->isVisible()) {
+			continue;
+		}
+
+		g_rectangle childBounds = child->getBounds();
+		childBounds.x += position.x;
+		childBounds.y += position.y;
+
+		visibleRegions[i] = remaining;
+		visibleRegions[i].clip(childBounds);
+
+		g_rectangle opaque = child->getOpaqueArea();
+		opaque.x += childBounds.x;
+		opaque.y += childBounds.y;
+		remaining.subtract(opaque);
+
+		if (remaining.isEmpty()) {
+			first = i;
+			break;
+		}
+	}
+
+	// blit from back to front, each child only where it is visible
+	for (int i = first; i < count; i++) {
+		component_t* child = children[i].component;
+		if (!child->isVisible()) {
+			continue;
+		}
+
+		g_rectangle childBounds = child->getBounds();
+		g_point childPosition(position.x + childBounds.x, position.y + childBounds.y);
+		for (int r = 0; r < visibleRegions[i].getCount(); r++) {
+			child->blit(out, visibleRegions[i].get(r), childPosition);
+		}
 	}
-	if (invalid.y + invalid.height > getBounds().height) {
-		invalid.height = getBounds().height - invalid.y;
-	}
 
+	children_lock.unlock();
 }
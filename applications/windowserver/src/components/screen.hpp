@@ -22,7 +22,9 @@
 #define SCREEN_HPP_
 
 #include <components/component.hpp>
+#include <components/dirty_region.hpp>
 #include <ghostuser/graphics/metrics/rectangle.hpp>
+#include <ghostuser/tasking/lock.hpp>
 
 /**
  *
@@ -30,9 +32,11 @@
 class screen_t: public component_t {
 private:
 	/**
-	 * Area that is invalid and needs to be copied to the video output.
+	 * Areas that are invalid and need to be recomposited and copied to the
+	 * video output, in screen coordinates.
 	 */
-	g_rectangle invalid;
+	dirty_region_t invalid;
+	g_lock invalid_lock;
 
 public:
 	/**
@@ -48,13 +52,22 @@ public:
 	virtual void markDirty(g_rectangle rect);
 
 	/**
-	 *
+	 * Returns the invalid areas and resets them.
 	 */
-	g_rectangle grabInvalid() {
-		g_rectangle ret = invalid;
-		invalid = g_rectangle();
-		return ret;
-	}
+	dirty_region_t grabInvalid();
+
+	/**
+	 * Whether any area is invalid.
+	 */
+	bool hasInvalid();
+
+	/**
+	 * Blits the children like the default implementation, but first computes
+	 * which part of each child is visible: children that are fully covered by
+	 * opaque children in front of them are skipped, the others are only
+	 * blitted in their visible parts.
+	 */
+	virtual void blit(g_graphics* out, g_rectangle absClip, g_point position);
 };
 
 #endif
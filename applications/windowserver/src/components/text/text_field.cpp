@@ -135,7 +135,8 @@ void text_field_t::paint() {
 		}
 	}
 
-	// Paint glyphs
+	// Paint glyphs from the glyph cache
+	g_glyph_atlas* atlas = font ? font->getAtlas(fontSize) : 0;
 	pos = 0;
 	for (g_positioned_glyph& g : viewModel->positions) {
 
@@ -145,12 +146,13 @@ void text_field_t::paint() {
 			color = RGB(255, 255, 255);
 		}
 
-		cairo_save(cr);
-		cairo_set_source_rgba(cr, G_COLOR_ARGB_TO_FPARAMS(color));
-		cairo_translate(cr, onView.x - g.glyph->x, onView.y - g.glyph->y); // TODO?
-		cairo_glyph_path(cr, g.glyph, g.glyph_count);
-		cairo_fill(cr);
-		cairo_restore(cr);
+		if (atlas) {
+			cairo_set_source_rgba(cr, G_COLOR_ARGB_TO_FPARAMS(color));
+			for (int i = 0; i < g.glyph_count; i++) {
+				g_atlas_glyph* cached = atlas->getGlyph(g.glyph[i].index);
+				g_glyph_atlas::paint(cr, cached, onView.x + g.glyph[i].x - g.glyph->x, onView.y + g.glyph[i].y - g.glyph->y);
+			}
+		}
 		++pos;
 	}
 
@@ -144,9 +144,88 @@ void window_t::paint() {
  *
  */
 void window_t::handleBoundChange(g_rectangle oldBounds) {
+	g_rectangle bounds = getBounds();
+	composite.resize(bounds.width, bounds.height);
+	markDirty();
 	markFor(COMPONENT_REQUIREMENT_PAINT);
 }
 
+/**
+ *
+ */
+void window_t::markDirty(g_rectangle rect) {
+	composite_lock.lock();
+	composite_damage.add(rect);
+	composite_lock.unlock();
+
+	component_t::markDirty(rect);
+}
+
+/**
+ *
+ */
+void window_t::updateComposite() {
+
+	g_rectangle bounds = getBounds();
+
+	composite_lock.lock();
+	dirty_region_t damage = composite_damage;
+	composite_damage.clear();
+	composite_lock.unlock();
+
+	damage.clip(g_rectangle(0, 0, bounds.width, bounds.height));
+
+	cairo_t* cr = composite.getContext();
+	for (int i = 0; i < damage.getCount(); i++) {
+		g_rectangle area = damage.get(i);
+
+		cairo_save(cr);
+		cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+		cairo_rectangle(cr, area.x, area.y, area.width, area.height);
+		cairo_fill(cr);
+		cairo_restore(cr);
+
+		component_t::blit(&composite, area, g_point(0, 0));
+	}
+}
+
+/**
+ *
+ */
+void window_t::blit(g_graphics* out, g_rectangle absClip, g_point position) {
+
+	if (!visible) {
+		return;
+	}
+
+	g_rectangle bounds = getBounds();
+	int left = absClip.getLeft() > position.x ? absClip.getLeft() : position.x;
+	int top = absClip.getTop() > position.y ? absClip.getTop() : position.y;
+	int right = absClip.getRight() < position.x + bounds.width ? absClip.getRight() : position.x + bounds.width;
+	int bottom = absClip.getBottom() < position.y + bounds.height ? absClip.getBottom() : position.y + bounds.height;
+	if (right <= left || bottom <= top) {
+		return;
+	}
+
+	updateComposite();
+	composite.blitTo(out, g_rectangle(left, top, right - left, bottom - top), position);
+}
+
+/**
+ *
+ */
+g_rectangle window_t::getOpaqueArea() {
+
+	if (!focused) {
+		return g_rectangle();
+	}
+
+	// the top corners are rounded
+	g_rectangle bounds = getBounds();
+	int cornerRadius = 5;
+	return g_rectangle(shadowSize, shadowSize + cornerRadius, bounds.width - 2 * shadowSize, bounds.height - 2 * shadowSize - cornerRadius);
+}
+
 /**
  *
  */
@@ -25,6 +25,8 @@
 #include <components/label.hpp>
 #include <components/titled_component.hpp>
 #include <components/panel.hpp>
+#include <components/dirty_region.hpp>
+#include <ghostuser/tasking/lock.hpp>
 
 /**
  * constants for border sizes
@@ -68,6 +70,17 @@ private:
 	int shadowSize;
 	g_rectangle crossBounds;
 
+	/**
+	 * The window with all of its children composited, so that the screen can
+	 * blit the window in one step. Areas that are marked dirty within the
+	 * window are recomposited before the next blit.
+	 */
+	g_graphics composite;
+	dirty_region_t composite_damage;
+	g_lock composite_lock;
+
+	void updateComposite();
+
 public:
 	window_t();
 
@@ -151,6 +164,23 @@ public:
 	 */
 	virtual void setLayoutManager(layout_manager_t* layoutManager);
 
+	/**
+	 *
+	 */
+	using component_t::markDirty;
+	virtual void markDirty(g_rectangle rect);
+
+	/**
+	 * Blits the retained composite of the window.
+	 */
+	virtual void blit(g_graphics* out, g_rectangle absClip, g_point position);
+
+	/**
+	 * The area within the shadow is opaque while the window is focused,
+	 * otherwise the background is translucent.
+	 */
+	virtual g_rectangle getOpaqueArea();
+
 	/**
 	 * @return whether this type of component is a window.
 	 */
@@ -83,24 +83,34 @@ void event_processor_t::process() {
 	command_message_buffer_lock.lock();
 	while (command_message_buffer.size() > 0) {
 
-		// take next message from buffer
-		void* request_buffer = command_message_buffer.back();
-		command_message_buffer.pop_back();
+		// take next message from buffer, in the order they were received
+		void* request_buffer = command_message_buffer.front();
+		command_message_buffer.pop_front();
 
 		g_message_header* message = (g_message_header*) request_buffer;
+		g_ui_message_header* request_header = (g_ui_message_header*) G_MESSAGE_CONTENT(request_buffer);
 
-		// prepare response
-		command_message_response_t buf_response;
-		buf_response.target = message->sender;
-		buf_response.transaction = message->transaction;
-		buf_response.message = 0;
+		if (request_header->id == G_UI_PROTOCOL_BATCH) {
+			process_batch(message->sender, (g_ui_batch_request*) request_header, message->length);
 
-		// process the actual action
-		process_command(message->sender, (g_ui_message_header*) G_MESSAGE_CONTENT(request_buffer), buf_response);
-
-		// add generated response to queue
-		if (buf_response.message != 0) {
-			windowserver_t::instance()->responder_thread->send_response(buf_response);
+		} else {
+			// prepare response
+			command_message_response_t buf_response;
+			buf_response.target = message->sender;
+			buf_response.transaction = message->transaction;
+			buf_response.message = 0;
+
+			// process the actual action
+			process_command(message->sender, request_header, buf_response);
+
+			// add generated response to queue, unless nobody waits for it
+			if (buf_response.message != 0) {
+				if (message->transaction == G_MESSAGE_TRANSACTION_NONE) {
+					delete (g_message_header*) buf_response.message;
+				} else {
+					windowserver_t::instance()->responder_thread->send_response(buf_response);
+				}
+			}
 		}
 
 		// delete request buffer
@@ -109,6 +119,45 @@ void event_processor_t::process() {
 	command_message_buffer_lock.unlock();
 }
 
+/**
+ *
+ */
+void event_processor_t::process_batch(g_tid sender_tid, g_ui_batch_request* batch, uint32_t length) {
+
+	uint8_t* content = (uint8_t*) batch;
+	uint32_t offset = sizeof(g_ui_batch_request);
+
+	for (int i = 0; i < batch->count; i++) {
+
+		// validate the entry against the message length
+		if (offset + sizeof(g_ui_batch_entry_header) > length) {
+			klog("batch from thread %i is shorter than announced", sender_tid);
+			break;
+		}
+		g_ui_batch_entry_header* entry = (g_ui_batch_entry_header*) &content[offset];
+		offset += sizeof(g_ui_batch_entry_header);
+
+		if (entry->length < sizeof(g_ui_message_header) || offset + entry->length > length) {
+			klog("batch from thread %i contains an invalid entry", sender_tid);
+			break;
+		}
+
+		// process the request, batched requests are never answered
+		g_ui_message_header* request_header = (g_ui_message_header*) &content[offset];
+		if (request_header->id != G_UI_PROTOCOL_BATCH) {
+			command_message_response_t response;
+			response.message = 0;
+			process_command(sender_tid, request_header, response);
+
+			if (response.message != 0) {
+				delete (g_message_header*) response.message;
+			}
+		}
+
+		offset += entry->length;
+	}
+}
+
 /**
  *
  */
@@ -386,6 +435,13 @@ void event_processor_t::process_command(g_tid sender_tid, g_ui_message_header* r
 
 		response_out.message = response;
 		response_out.length = sizeof(g_ui_get_screen_dimension_response);
+
+	} else if (request_header->id == G_UI_PROTOCOL_GET_FRAME_STATISTICS) {
+		g_ui_get_frame_statistics_response* response = new g_ui_get_frame_statistics_response;
+		response->statistics = windowserver_t::instance()->getStatistics();
+
+		response_out.message = response;
+		response_out.length = sizeof(g_ui_get_frame_statistics_response);
 	}
 
 }
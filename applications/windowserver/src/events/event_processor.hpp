@@ -50,6 +50,7 @@ public:
 
 	void process();
 	void process_command(g_tid sender_tid, g_ui_message_header* request_header, command_message_response_t& response_out);
+	void process_batch(g_tid sender_tid, g_ui_batch_request* batch, uint32_t length);
 
 	void translateKeyEvent(g_key_info& info);
 	void processMouseState();
@@ -0,0 +1,216 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "pixel_conversion.hpp"
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <string.h>
+
+#define SSE2_FUNCTION	__attribute__((target("sse2")))
+
+bool pixel_conversion_t::sse2 = false;
+
+/**
+ *
+ */
+void pixel_conversion_t::initialize() {
+
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		sse2 = (edx & bit_SSE2) != 0;
+	}
+}
+
+/**
+ *
+ */
+pixel_row_converter_t pixel_conversion_t::getConverter(uint16_t bpp) {
+
+	if (bpp == 32) {
+		return sse2 ? toRgb32Sse2 : toRgb32;
+	} else if (bpp == 24) {
+		return sse2 ? toRgb24Sse2 : toRgb24;
+	} else if (bpp == 16) {
+		return sse2 ? toRgb16Sse2 : toRgb16;
+	}
+	return 0;
+}
+
+/**
+ *
+ */
+void pixel_conversion_t::toRgb32(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+	memcpy(target, source, pixels * 4);
+}
+
+/**
+ *
+ */
+void pixel_conversion_t::toRgb24(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+
+	for (uint32_t i = 0; i < pixels; i++) {
+		uint32_t color = source[i];
+		target[0] = color & 0xFF;
+		target[1] = (color >> 8) & 0xFF;
+		target[2] = (color >> 16) & 0xFF;
+		target += 3;
+	}
+}
+
+/**
+ *
+ */
+void pixel_conversion_t::toRgb16(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+
+	uint16_t* target2 = (uint16_t*) target;
+	for (uint32_t i = 0; i < pixels; i++) {
+		uint32_t color = source[i];
+		target2[i] = ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+	}
+}
+
+/**
+ *
+ */
+SSE2_FUNCTION void pixel_conversion_t::toRgb32Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+
+	uint32_t* target4 = (uint32_t*) target;
+	if (((uintptr_t) target4) & 3) {
+		toRgb32(source, target, pixels);
+		return;
+	}
+
+	// copy single pixels until the target is aligned for streaming stores
+	uint32_t i = 0;
+	for (; i < pixels && (((uintptr_t) &target4[i]) & 15); i++) {
+		target4[i] = source[i];
+	}
+
+	for (; i + 16 <= pixels; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*) &source[i]);
+		__m128i b = _mm_loadu_si128((const __m128i*) &source[i + 4]);
+		__m128i c = _mm_loadu_si128((const __m128i*) &source[i + 8]);
+		__m128i d = _mm_loadu_si128((const __m128i*) &source[i + 12]);
+		_mm_stream_si128((__m128i*) &target4[i], a);
+		_mm_stream_si128((__m128i*) &target4[i + 4], b);
+		_mm_stream_si128((__m128i*) &target4[i + 8], c);
+		_mm_stream_si128((__m128i*) &target4[i + 12], d);
+	}
+	for (; i + 4 <= pixels; i += 4) {
+		_mm_stream_si128((__m128i*) &target4[i], _mm_loadu_si128((const __m128i*) &source[i]));
+	}
+	for (; i < pixels; i++) {
+		target4[i] = source[i];
+	}
+
+	_mm_sfence();
+}
+
+/**
+ * Packs four ARGB pixels into the lower twelve bytes as BGR triplets.
+ */
+static inline SSE2_FUNCTION __m128i packRgb24(__m128i pixels) {
+
+	// drop alpha and move each odd pixel down next to the even one, so every
+	// 64 bit lane holds two pixels in its lower six bytes
+	__m128i even = _mm_and_si128(pixels, _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF));
+	__m128i odd = _mm_and_si128(pixels, _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0));
+	__m128i lanes = _mm_or_si128(even, _mm_srli_epi64(odd, 8));
+
+	// close the gap between the two lanes
+	return _mm_or_si128(_mm_move_epi64(lanes), _mm_slli_si128(_mm_srli_si128(lanes, 8), 6));
+}
+
+/**
+ *
+ */
+SSE2_FUNCTION void pixel_conversion_t::toRgb24Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+
+	// convert single pixels until the target is aligned for streaming stores,
+	// as three is coprime to sixteen this takes at most fifteen pixels
+	uint32_t i = 0;
+	for (; i < pixels && (((uintptr_t) target) & 15); i++) {
+		uint32_t color = source[i];
+		target[0] = color & 0xFF;
+		target[1] = (color >> 8) & 0xFF;
+		target[2] = (color >> 16) & 0xFF;
+		target += 3;
+	}
+
+	// sixteen pixels make exactly three vectors of output
+	for (; i + 16 <= pixels; i += 16) {
+		__m128i a = packRgb24(_mm_loadu_si128((const __m128i*) &source[i]));
+		__m128i b = packRgb24(_mm_loadu_si128((const __m128i*) &source[i + 4]));
+		__m128i c = packRgb24(_mm_loadu_si128((const __m128i*) &source[i + 8]));
+		__m128i d = packRgb24(_mm_loadu_si128((const __m128i*) &source[i + 12]));
+
+		_mm_stream_si128((__m128i*) target, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+		_mm_stream_si128((__m128i*) (target + 16), _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+		_mm_stream_si128((__m128i*) (target + 32), _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+		target += 48;
+	}
+
+	_mm_sfence();
+
+	toRgb24(&source[i], target, pixels - i);
+}
+
+/**
+ * Converts four ARGB pixels to RGB565, each in the lower half of its 32 bit
+ * lane and sign-extended so that a signed saturating pack keeps the bits.
+ */
+static inline SSE2_FUNCTION __m128i packRgb16(__m128i pixels) {
+
+	__m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32(0xF800));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x07E0));
+	__m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 3), _mm_set1_epi32(0x001F));
+	__m128i color = _mm_or_si128(_mm_or_si128(r, g), b);
+	return _mm_srai_epi32(_mm_slli_epi32(color, 16), 16);
+}
+
+/**
+ *
+ */
+SSE2_FUNCTION void pixel_conversion_t::toRgb16Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels) {
+
+	if (((uintptr_t) target) & 1) {
+		toRgb16(source, target, pixels);
+		return;
+	}
+
+	uint32_t i = 0;
+	uint32_t head = 0;
+	while (head < pixels && (((uintptr_t) (target + head * 2)) & 15)) {
+		head++;
+	}
+	toRgb16(source, target, head);
+	i = head;
+
+	for (; i + 8 <= pixels; i += 8) {
+		__m128i a = packRgb16(_mm_loadu_si128((const __m128i*) &source[i]));
+		__m128i b = packRgb16(_mm_loadu_si128((const __m128i*) &source[i + 4]));
+		_mm_stream_si128((__m128i*) (target + i * 2), _mm_packs_epi32(a, b));
+	}
+
+	_mm_sfence();
+
+	toRgb16(&source[i], target + i * 2, pixels - i);
+}
@@ -0,0 +1,67 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __PIXEL_CONVERSION__
+#define __PIXEL_CONVERSION__
+
+#include <stdint.h>
+
+/**
+ * Converts a row of ARGB pixels to the target pixel format.
+ */
+typedef void (*pixel_row_converter_t)(const uint32_t* source, uint8_t* target, uint32_t pixels);
+
+/**
+ * Row converters from the compositing buffer format (32 bit ARGB) to the
+ * pixel formats of a linear framebuffer. The SSE2 variants write with
+ * non-temporal stores, which go straight to the (usually write-combined)
+ * framebuffer instead of polluting the cache with data that is never read.
+ *
+ * This file does not depend on anything in the system, so that it can
+ * also be built on the host for benchmarking.
+ */
+class pixel_conversion_t {
+public:
+	/**
+	 * Whether the processor supports SSE2, filled by initialize.
+	 */
+	static bool sse2;
+
+	/**
+	 * Detects the processor features via CPUID.
+	 */
+	static void initialize();
+
+	/**
+	 * Returns the best converter for the given bits per pixel, or 0 if the
+	 * format is not supported.
+	 */
+	static pixel_row_converter_t getConverter(uint16_t bpp);
+
+	static void toRgb32(const uint32_t* source, uint8_t* target, uint32_t pixels);
+	static void toRgb24(const uint32_t* source, uint8_t* target, uint32_t pixels);
+	static void toRgb16(const uint32_t* source, uint8_t* target, uint32_t pixels);
+
+	static void toRgb32Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels);
+	static void toRgb24Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels);
+	static void toRgb16Sse2(const uint32_t* source, uint8_t* target, uint32_t pixels);
+};
+
+#endif
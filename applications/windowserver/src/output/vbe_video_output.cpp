@@ -19,12 +19,30 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "vbe_video_output.hpp"
+#include <stdio.h>
 
 /**
  *
  */
 bool vbe_video_output_t::initialize_with_settings(uint32_t width, uint32_t height, uint32_t bits) {
-	return g_vbe::setMode(width, height, bits, video_mode_information);
+
+	if (!g_vbe::setMode(width, height, bits, video_mode_information)) {
+		return false;
+	}
+
+	pixel_conversion_t::initialize();
+	converter = pixel_conversion_t::getConverter(video_mode_information.bpp);
+	if (converter == 0) {
+		klog("video mode has unsupported pixel format with %i bits per pixel", video_mode_information.bpp);
+		return false;
+	}
+
+	// with a second page, draw to the one that is not shown
+	if (video_mode_information.pages >= 2 && g_vbe::setDisplayStart(0, 0)) {
+		flipping = true;
+		back_page = 1;
+	}
+	return true;
 }
 
 /**
@@ -32,31 +50,58 @@ bool vbe_video_output_t::initialize_with_settings(uint32_t width, uint32_t heigh
  */
 void vbe_video_output_t::blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source) {
 
-	uint16_t bpp = video_mode_information.bpp;
-	uint8_t* position = ((uint8_t*) video_mode_information.lfb) + (invalid.y * video_mode_information.bpsl);
-
-	uint32_t right = invalid.x + invalid.width;
-	uint32_t bottom = invalid.y + invalid.height;
-
-	if (bpp == 32) {
-		for (int y = invalid.y; y < bottom; y++) {
-			uint32_t* position4 = (uint32_t*) position;
-			for (int x = invalid.x; x < right; x++) {
-				position4[x] = source[y * sourceSize.width + x];
-			}
-			position += video_mode_information.bpsl;
-		}
-
-	} else if (bpp == 24) {
-		for (int y = invalid.y; y < bottom; y++) {
-			for (int x = invalid.x; x < right; x++) {
-				g_color_argb color = source[y * sourceSize.width + x];
-				position[x * 3] = color & 0xFF;
-				position[x * 3 + 1] = (color >> 8) & 0xFF;
-				position[x * 3 + 2] = (color >> 16) & 0xFF;
-			}
-			position += video_mode_information.bpsl;
-		}
+	if (converter == 0 || invalid.width <= 0 || invalid.height <= 0) {
+		return;
+	}
+
+	if (flipping) {
+		presented.add(invalid);
+		presented_source_size = sourceSize;
+		presented_source = source;
+	}
+	write(back_page, invalid, sourceSize, source);
+}
+
+/**
+ *
+ */
+void vbe_video_output_t::present() {
+
+	if (!flipping || presented.isEmpty()) {
+		return;
+	}
+
+	// if switching fails, stay on the shown page and write there from now on
+	if (g_vbe::setDisplayStart(0, back_page * video_mode_information.resY)) {
+		back_page = 1 - back_page;
+	} else {
+		klog("failed to switch display page, disabling page flipping");
+		flipping = false;
+		back_page = 1 - back_page;
+	}
+
+	// the now hidden page is a frame behind
+	for (int i = 0; i < presented.getCount(); i++) {
+		write(back_page, presented.get(i), presented_source_size, presented_source);
+	}
+	presented.clear();
+}
+
+/**
+ *
+ */
+void vbe_video_output_t::write(uint32_t page, g_rectangle area, g_rectangle sourceSize, g_color_argb* source) {
+
+	// convert row by row, the converter was chosen for the mode on initialization
+	uint32_t bytesPerPixel = (video_mode_information.bpp + 7) / 8;
+	uint8_t* position = ((uint8_t*) video_mode_information.lfb) + (page * video_mode_information.resY + area.y) * video_mode_information.bpsl
+			+ area.x * bytesPerPixel;
+	const g_color_argb* row = source + area.y * sourceSize.width + area.x;
+
+	for (int y = 0; y < area.height; y++) {
+		converter(row, position, area.width);
+		position += video_mode_information.bpsl;
+		row += sourceSize.width;
 	}
 }
 
@@ -22,6 +22,8 @@
 #define __VBE_VIDEO_OUTPUT__
 
 #include "configuration_based_video_output.hpp"
+#include "pixel_conversion.hpp"
+#include "components/dirty_region.hpp"
 #include <ghostuser/graphics/vbe.hpp>
 
 /**
@@ -31,6 +33,27 @@ class vbe_video_output_t: public configuration_based_video_output_t {
 private:
 	g_vbe_mode_info video_mode_information;
 
+	/**
+	 * Converter for the pixel format of the current mode.
+	 */
+	pixel_row_converter_t converter = 0;
+
+	/**
+	 * If the mode has two pages, output is written to the page that is not
+	 * shown and the pages are switched on present. The areas written during a
+	 * frame are remembered, as the other page must receive them after the switch.
+	 */
+	bool flipping = false;
+	uint32_t back_page = 0;
+	dirty_region_t presented;
+	g_rectangle presented_source_size;
+	g_color_argb* presented_source = 0;
+
+	/**
+	 * Converts the area of the source into the given page.
+	 */
+	void write(uint32_t page, g_rectangle area, g_rectangle sourceSize, g_color_argb* source);
+
 public:
 	/**
 	 * @see base
@@ -42,6 +65,11 @@ public:
 	 */
 	virtual void blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source);
 
+	/**
+	 * @see base
+	 */
+	virtual void present();
+
 	/**
 	 * @see base
 	 */
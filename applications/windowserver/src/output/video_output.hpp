@@ -53,6 +53,13 @@ public:
 	 */
 	virtual void blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source) = 0;
 
+	/**
+	 * Called after all invalid rectangles of a frame were written, so that
+	 * outputs with a back buffer can show the frame in one step.
+	 */
+	virtual void present() {
+	}
+
 	/**
 	 * Returns the initialized resolution.
 	 */
@@ -41,6 +41,7 @@
 
 #include <iostream>
 #include <stdio.h>
+#include <string.h>
 #include <algorithm>
 
 #include <ghostuser/tasking/lock.hpp>
@@ -51,13 +52,6 @@
 static windowserver_t* server;
 static g_lock dispatch_lock;
 
-#if BENCHMARKING
-static uint64_t rounds = 0;
-static uint64_t total_event_processing = 0;
-static uint64_t total_component_processing = 0;
-static uint64_t total_blitting = 0;
-#endif
-
 /**
  *
  */
@@ -122,15 +116,19 @@ void windowserver_t::launch() {
 	mainLoop(screenBounds);
 }
 
-static uint64_t render_start;
+static volatile uint64_t render_start;
+static volatile bool rendering = false;
 
 /**
  *
  */
 void lockcheck() {
 
+	// the loop is idle while nothing happens, so only a frame that takes
+	// too long or a requested frame that does not start is a freeze
+	windowserver_t* instance = windowserver_t::instance();
 	while (true) {
-		if (g_millis() - render_start > 3000) {
+		if ((rendering || !instance->render_atom) && g_millis() - render_start > 3000) {
 			g_log("window server has frozen");
 		}
 		g_sleep(1000);
@@ -148,91 +146,116 @@ void windowserver_t::mainLoop(g_rectangle screenBounds) {
 
 	cursor_t::nextPosition = g_point(screenBounds.width / 2, screenBounds.height / 2);
 
-	// intially set rendering atom
+	// intially set rendering atom, the first frame is rendered right away
 	render_atom = true;
+	memset(&statistics, 0, sizeof(g_ui_frame_statistics));
 
-	uint64_t render_time;
+	uint64_t last_frame_start = 0;
 
 	while (true) {
-		render_start = g_millis();
-		event_processor->processMouseState();
+		// pace frames to the refresh interval while active
+		uint64_t since_last_frame = g_millis() - last_frame_start;
+		if (since_last_frame < FRAME_INTERVAL) {
+			g_sleep(FRAME_INTERVAL - since_last_frame);
+		}
 
-#if BENCHMARKING
-		rounds++;
-#endif
+		render_start = g_millis();
+		last_frame_start = render_start;
+		rendering = true;
 
 		// do event processing
-#if BENCHMARKING
-		uint64_t time_event_processing = g_millis();
-#endif
+		event_processor->processMouseState();
 		event_processor->process();
-#if BENCHMARKING
-		total_event_processing += (g_millis() - time_event_processing);
-#endif
+		uint64_t time_event_processing = g_millis();
 
-		// render the screen
-#if BENCHMARKING
-		uint64_t time_component_processing = g_millis();
-#endif
 		// make the root component resolve all requirements
 		screen->resolveRequirement(COMPONENT_REQUIREMENT_UPDATE);
 		screen->resolveRequirement(COMPONENT_REQUIREMENT_LAYOUT);
 		screen->resolveRequirement(COMPONENT_REQUIREMENT_PAINT);
 
-		// blit the root component to the buffer
-		screen->blit(&global, screenBounds, g_point(0, 0));
-#if BENCHMARKING
-		total_component_processing += (g_millis() - time_component_processing);
-#endif
+		// the cursor is painted on top of the composited buffer, so if it is
+		// partially damaged it must be recomposited completely
+		dirty_region_t damage = screen->grabInvalid();
+		if (damage.intersects(cursor_t::getArea())) {
+			damage.add(cursor_t::getArea());
+			damage.clip(screenBounds);
+		}
+
+		// blit the damaged areas of the root component to the buffer
+		for (int i = 0; i < damage.getCount(); i++) {
+			screen->blit(&global, damage.get(i), g_point(0, 0));
+		}
 
 		// paint the cursor
 		cursor_t::paint(&global);
+		uint64_t time_component_processing = g_millis();
 
 		// blit output
-		blit(&global);
-
-		// limit to 60 fps
-		render_time = g_millis() - render_start;
-		if (render_time < (1000 / 60)) {
-			g_sleep((1000 / 60) - render_time);
-		}
+		blit(&global, damage);
+		uint64_t time_blitting = g_millis();
 
-		g_atomic_lock_to(&render_atom, 1000);
+		rendering = false;
+		recordFrame(time_blitting - render_start, time_event_processing - render_start, time_component_processing - time_event_processing,
+				time_blitting - time_component_processing);
 
-		// print output
-#if BENCHMARKING
-		if (rounds % 100 == 0) {
-			klog("benchmark results (1/1000): eventProcessing=%i, componentProcessing=%i, blitting=%i", (total_event_processing * 1000 / rounds),
-					(total_component_processing * 1000 / rounds), (total_blitting * 1000 / rounds));
+		// sleep until the next input or damage, unless this frame left work
+		if (!screen->hasRequirements() && !screen->hasInvalid()) {
+			g_atomic_lock(&render_atom);
 		}
-#endif
 	}
 }
 
 /**
  *
  */
-void windowserver_t::blit(g_graphics* graphics) {
+void windowserver_t::blit(g_graphics* graphics, const dirty_region_t& damage) {
+
+	if (damage.isEmpty()) {
+		return;
+	}
 
 	g_dimension resolution = video_output->getResolution();
 	g_rectangle screenBounds(0, 0, resolution.width, resolution.height);
 	g_color_argb* buffer = (g_color_argb*) cairo_image_surface_get_data(graphics->getSurface());
 
-	// get invalid output
-	g_rectangle invalid = screen->grabInvalid();
+	// do blitting, only the damaged rectangles are copied
+	for (int i = 0; i < damage.getCount(); i++) {
+		video_output->blit(damage.get(i), screenBounds, buffer);
+	}
+	video_output->present();
+}
 
-	if (invalid.width == 0 && invalid.height == 0) {
-		return;
+/**
+ *
+ */
+void windowserver_t::recordFrame(uint32_t frameTime, uint32_t eventProcessing, uint32_t componentProcessing, uint32_t blitting) {
+
+	uint32_t bucket = 0;
+	while (bucket < G_UI_FRAME_HISTOGRAM_BUCKETS - 1 && frameTime >= (1u << bucket)) {
+		bucket++;
+	}
+
+	statistics_lock.lock();
+	statistics.frames++;
+	statistics.histogram[bucket]++;
+	if (frameTime > statistics.longest_frame) {
+		statistics.longest_frame = frameTime;
 	}
+	statistics.total_event_processing += eventProcessing;
+	statistics.total_component_processing += componentProcessing;
+	statistics.total_blitting += blitting;
+	statistics_lock.unlock();
+}
+
+/**
+ *
+ */
+g_ui_frame_statistics windowserver_t::getStatistics() {
 
-	// do blitting
-#if BENCHMARKING
-	uint64_t time_blitting = g_millis();
-#endif
-	video_output->blit(invalid, screenBounds, buffer);
-#if BENCHMARKING
-	total_blitting += (g_millis() - time_blitting);
-#endif
+	statistics_lock.lock();
+	g_ui_frame_statistics copy = statistics;
+	statistics_lock.unlock();
+	return copy;
 }
 
 /**
@@ -27,8 +27,14 @@
 #include <events/event_processor.hpp>
 #include "output/video_output.hpp"
 #include "interface/command_message_responder_thread.hpp"
+#include <ghostuser/tasking/lock.hpp>
+#include <ghostuser/ui/interface_specification.hpp>
 
-#define BENCHMARKING 0
+/**
+ * Minimum time between the start of two frames. Input that arrives while
+ * waiting is handled together in the next frame.
+ */
+#define FRAME_INTERVAL		(1000 / 60)
 
 /**
  *
@@ -41,6 +47,12 @@ public:
 	command_message_responder_thread_t* responder_thread;
 	uint8_t render_atom;
 
+	/**
+	 * Frame time statistics, can be queried by clients.
+	 */
+	g_ui_frame_statistics statistics;
+	g_lock statistics_lock;
+
 	/**
 	 * Sets up the windowing system by configuring a video output, setting up the
 	 * event processor and running the main loop. Each step of the main loop includes
@@ -54,9 +66,9 @@ public:
 	void mainLoop(g_rectangle screenBounds);
 
 	/**
-	 * Blits the component state.
+	 * Blits the damaged areas of the composited buffer to the video output.
 	 */
-	void blit(g_graphics* graphics);
+	void blit(g_graphics* graphics, const dirty_region_t& damage);
 
 	/**
 	 * Dispatches the given event to the component.
@@ -88,10 +100,20 @@ public:
 	void loadCursor();
 
 	/**
-	 *
+	 * Requests a frame. The main loop only renders after damage or input.
 	 */
 	void triggerRender();
 
+	/**
+	 * Adds a rendered frame to the statistics.
+	 */
+	void recordFrame(uint32_t frameTime, uint32_t eventProcessing, uint32_t componentProcessing, uint32_t blitting);
+
+	/**
+	 * Returns a copy of the frame statistics.
+	 */
+	g_ui_frame_statistics getStatistics();
+
 };
 
 #endif
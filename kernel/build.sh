@@ -160,7 +160,7 @@ target_link() {
 #
 target_ramdisk() {
 	headline "building ramdisk"
-	$RAMDISK_WRITER "$SYSROOT" "$RAMDISK"
+	$RAMDISK_WRITER "$SYSROOT" "$RAMDISK" --compress
 	failOnError
 }
 
@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_GLOBAL_ASYNC
+#define GHOST_GLOBAL_ASYNC
+
+#include "ghost/common.h"
+#include "ghost/stdint.h"
+
+__BEGIN_C
+
+// status for setting up asynchronous calls
+typedef int g_async_setup_status;
+#define G_ASYNC_SETUP_STATUS_SUCCESSFUL ((g_async_setup_status) 0)
+#define G_ASYNC_SETUP_STATUS_INVALID_SIZE ((g_async_setup_status) 1)
+#define G_ASYNC_SETUP_STATUS_ALREADY_SET_UP ((g_async_setup_status) 2)
+
+// status of a completed asynchronous call
+typedef uint8_t g_async_completion_status;
+#define G_ASYNC_COMPLETION_STATUS_DONE ((g_async_completion_status) 0)
+#define G_ASYNC_COMPLETION_STATUS_UNSUPPORTED ((g_async_completion_status) 1)
+
+// bounds for the number of ring entries, must be a power of two
+#define G_ASYNC_MAXIMUM_ENTRIES			1024
+
+/**
+ * A system call that is submitted for asynchronous execution. The call structure
+ * must stay valid until the call is completed, the result is written to it like
+ * for a synchronous call.
+ */
+typedef struct {
+	uint32_t call;
+	void* data;
+	uint32_t user_data;
+}__attribute__((packed)) g_async_submission;
+
+/**
+ * Posted by the kernel once an asynchronous call has finished.
+ */
+typedef struct {
+	uint32_t user_data;
+	uint32_t call;
+	g_async_completion_status status;
+	uint8_t padding[3];
+}__attribute__((packed)) g_async_completion;
+
+/**
+ * Header of the submission and completion rings of a process. The header is followed
+ * by the array of submissions and then by the array of completions, each with
+ * <entries> elements. Heads and tails are free-running counters.
+ *
+ * The process produces submissions and consumes completions, the kernel consumes
+ * submissions once the process enters it and produces completions from its workers.
+ */
+typedef struct {
+	volatile uint32_t submission_head;
+	uint8_t padding_submission_head[60];
+
+	volatile uint32_t submission_tail;
+	uint8_t padding_submission_tail[60];
+
+	volatile uint32_t completion_head;
+	uint8_t padding_completion_head[60];
+
+	volatile uint32_t completion_tail;
+	uint8_t padding_completion_tail[60];
+
+	uint32_t entries;
+	uint8_t padding_info[60];
+}__attribute__((packed)) g_async_ring;
+
+#define G_ASYNC_SUBMISSIONS(ring)			((g_async_submission*) (((uint8_t*) ring) + sizeof(g_async_ring)))
+#define G_ASYNC_COMPLETIONS(ring)			((g_async_completion*) (G_ASYNC_SUBMISSIONS(ring) + (ring)->entries))
+#define G_ASYNC_RING_SIZE(entries)			(sizeof(g_async_ring) + (entries) * (sizeof(g_async_submission) + sizeof(g_async_completion)))
+
+__END_C
+
+#endif
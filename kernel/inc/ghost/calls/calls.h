@@ -29,6 +29,7 @@
 #include "ghost/calls/calls_tasking.hpp"
 #include "ghost/calls/calls_vm86.hpp"
 #include "ghost/calls/calls_filesystem.hpp"
+#include "ghost/calls/calls_async.hpp"
 
 __BEGIN_C
 
@@ -57,6 +58,10 @@ __BEGIN_C
 #define G_SYSCALL_GET_PARENT_PROCESS_ID			25
 #define G_SYSCALL_TASK_GET_TLS                  27
 #define G_SYSCALL_PROCESS_GET_INFO              28
+#define G_SYSCALL_BATCH							29
+#define G_SYSCALL_ASYNC_SETUP					30
+#define G_SYSCALL_ASYNC_SUBMIT					31
+#define G_SYSCALL_ASYNC_WAIT					32
 
 #define G_SYSCALL_CALL_VM86						50
 #define G_SYSCALL_LOWER_MEMORY_ALLOCATE			51
@@ -90,11 +95,15 @@ __BEGIN_C
 #define G_SYSCALL_FS_SEEK						129
 #define G_SYSCALL_FS_TELL						130
 #define G_SYSCALL_FS_REGISTER_AS_DELEGATE		131
-#define G_SYSCALL_FS_SET_TRANSACTION_STATUS		132
 #define G_SYSCALL_FS_CREATE_NODE				133
 #define G_SYSCALL_FS_OPEN_DIRECTORY				134
 #define G_SYSCALL_FS_READ_DIRECTORY				135
 #define G_SYSCALL_FS_CLOSE_DIRECTORY			136
+#define G_SYSCALL_FS_READV						137
+#define G_SYSCALL_FS_WRITEV						138
+#define G_SYSCALL_FS_UNLINK						139
+#define G_SYSCALL_FS_FLUSH						140
+#define G_SYSCALL_FS_POLL						141
 
 #define G_SYSCALL_MAX							150
 
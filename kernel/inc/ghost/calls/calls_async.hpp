@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_CALLS_ASYNC_CALLS
+#define GHOST_API_CALLS_ASYNC_CALLS
+
+#include "ghost/async.h"
+
+/**
+ * @field ring
+ * 		rings to use for the process, must be at least
+ * 		{G_ASYNC_RING_SIZE} bytes large
+ *
+ * @field entries
+ * 		number of entries in each ring, a power of two
+ *
+ * @field status
+ * 		one of the {g_async_setup_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_async_ring* ring;
+	uint32_t entries;
+
+	g_async_setup_status status;
+}__attribute__((packed)) g_syscall_async_setup;
+
+/**
+ * Takes calls from the submission ring and hands them to the kernel workers of
+ * the process. Calls are only taken as long as the completion ring is guaranteed
+ * to have space for their completion.
+ *
+ * @field submitted
+ * 		number of calls that were taken from the ring
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	uint32_t submitted;
+}__attribute__((packed)) g_syscall_async_submit;
+
+/**
+ * @field minimum
+ * 		number of completions to wait for
+ *
+ * @field available
+ * 		number of completions that are available in the ring
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	uint32_t minimum;
+
+	uint32_t available;
+}__attribute__((packed)) g_syscall_async_wait;
+
+#endif
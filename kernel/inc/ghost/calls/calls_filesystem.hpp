@@ -100,6 +100,122 @@ typedef struct {
 	int64_t result;
 }__attribute__((packed)) g_syscall_fs_write;
 
+/**
+ * @field path
+ * 		buffer containing the file path
+ *
+ * @field status
+ * 		one of the {g_fs_unlink_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	char* path;
+
+	g_fs_unlink_status status;
+}__attribute__((packed)) g_syscall_fs_unlink;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field status
+ * 		one of the {g_fs_flush_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+
+	g_fs_flush_status status;
+}__attribute__((packed)) g_syscall_fs_flush;
+
+/**
+ * @field entries
+ * 		file descriptors to poll, the revents of each entry are filled
+ *
+ * @field count
+ * 		number of entries
+ *
+ * @field messages
+ * 		whether to also wait for a message to arrive in the message queue of the calling task
+ *
+ * @field timeout
+ * 		maximum number of milliseconds to wait, zero to not wait at all
+ * 		or {G_FS_POLL_INFINITE} to wait until any source is ready
+ *
+ * @field messages_ready
+ * 		whether a message is available in the message queue
+ *
+ * @field result
+ * 		number of entries that are ready, including the message queue
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fs_poll_entry* entries;
+	uint32_t count;
+	g_bool messages;
+	int32_t timeout;
+
+	g_bool messages_ready;
+	int32_t result;
+}__attribute__((packed)) g_syscall_fs_poll;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vector
+ * 		buffers to read to
+ *
+ * @field count
+ * 		number of buffers in the vector
+ *
+ * @field status
+ * 		one of the {g_fs_read_status} codes
+ *
+ * @field result
+ * 		total number of bytes read
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	g_fs_iovec* vector;
+	int32_t count;
+
+	g_fs_read_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_readv;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vector
+ * 		buffers to write from
+ *
+ * @field count
+ * 		number of buffers in the vector
+ *
+ * @field status
+ * 		one of the {g_fs_write_status} codes
+ *
+ * @field result
+ * 		total number of bytes written
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	g_fs_iovec* vector;
+	int32_t count;
+
+	g_fs_write_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_writev;
+
 /**
  * @field fd
  * 		file descriptor
@@ -338,8 +454,8 @@ typedef struct {
  * @field mountpoint_id
  * 		contains the mountpoint id on success
  *
- * @field transaction_storage
- * 		contains the transaction storage address on success
+ * @field ring
+ * 		contains the address of the request ring on success
  *
  * @security-level DRIVER
  */
@@ -348,24 +464,10 @@ typedef struct {
 	g_fs_phys_id phys_mountpoint_id;
 
 	g_fs_virt_id mountpoint_id;
-	g_address transaction_storage;
+	g_fs_tasked_delegate_ring* ring;
 	g_fs_register_as_delegate_status result;
 }__attribute__((packed)) g_syscall_fs_register_as_delegate;
 
-/**
- * @field transaction
- * 		the transaction to set the status for
- *
- * @field status
- * 		the status to set
- *
- * @security-level DRIVER
- */
-typedef struct {
-	g_fs_transaction_id transaction;
-	g_fs_transaction_status status;
-}__attribute__((packed)) g_syscall_fs_set_transaction_status;
-
 /**
  * @field parent_id
  * 		id of the parent node
@@ -414,18 +516,35 @@ typedef struct {
 }__attribute__((packed)) g_syscall_fs_open_directory;
 
 /**
- * @field iterator
- * 		pointer to the iterator
+ * @field node_id
+ * 		id of the directory, as filled by opening it
+ *
+ * @field cursor
+ * 		position to continue from, zero to start at the first entry; is
+ * 		updated to continue after the last entry that was written
+ *
+ * @field buffer
+ * 		buffer to write the {g_fs_directory_record} entries to
+ *
+ * @field length
+ * 		length of the buffer
+ *
+ * @field result
+ * 		number of bytes that were written
  *
  * @field status
- * 		one of the {g_fs_directory_refresh_status} codes
+ * 		one of the {g_fs_read_directory_status} codes
  *
  * @security-level APPLICATION
  */
 typedef struct {
-	g_fs_directory_iterator* iterator;
+	g_fs_virt_id node_id;
+	uint64_t cursor;
+	uint8_t* buffer;
+	uint32_t length;
 
-	g_fs_directory_refresh_status status;
+	uint32_t result;
+	g_fs_read_directory_status status;
 }__attribute__((packed)) g_syscall_fs_read_directory;
 
 /**
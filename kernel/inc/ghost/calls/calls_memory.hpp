@@ -23,6 +23,7 @@
 
 #include "ghost/stdint.h"
 #include "ghost/kernel.h"
+#include "ghost/memory.h"
 #include "ghost/types.h"
 
 /**
@@ -73,6 +74,10 @@ typedef struct {
  * @field size
  * 		the minimum size to map
  *
+ * @field flags
+ * 		mapping flags, G_MMIO_FLAG_WRITE_COMBINING maps the area as
+ * 		write-combining if the processor supports it (for framebuffers)
+ *
  * @field virtualAddress
  * 		the resulting page-aligned virtual address in the current
  * 		processes address space. if mapping fails, this field is 0.
@@ -82,6 +87,7 @@ typedef struct {
 typedef struct {
 	g_physical_address physicalAddress;
 	uint32_t size;
+	g_mmio_flags flags;
 
 	void* virtualAddress;
 }__attribute__((packed)) g_syscall_map_mmio;
@@ -68,4 +68,47 @@ typedef struct {
 	g_kernquery_status status;
 }__attribute__((packed)) g_syscall_kernquery;
 
+/**
+ * @field call
+ * 		id of the system call to execute
+ *
+ * @field data
+ * 		call structure that is passed to the system call
+ *
+ * @field executed
+ * 		whether the call was executed
+ */
+typedef struct {
+	uint32_t call;
+	void* data;
+
+	uint8_t executed;
+}__attribute__((packed)) g_syscall_batch_entry;
+
+/**
+ * Only system calls that never have to be processed in a kernel thread may be
+ * part of a batch. Entries are executed in order. The batch stops after the first
+ * call that has to wait, this call is completed before returning. It also stops
+ * before the first call that can't be executed within the batch, like a call
+ * that is not batchable or would have to be processed in a kernel thread. The
+ * remaining entries are not executed and can be performed by the caller.
+ *
+ * @field entries
+ * 		calls to execute
+ *
+ * @field count
+ * 		number of entries
+ *
+ * @field executed
+ * 		number of executed entries
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_syscall_batch_entry* entries;
+	uint32_t count;
+
+	uint32_t executed;
+}__attribute__((packed)) g_syscall_batch;
+
 #endif
@@ -41,6 +41,7 @@ typedef uint64_t g_fs_phys_id; // a physical filesystem node identifier
  */
 #define G_PATH_MAX		4096
 #define G_FILENAME_MAX	512
+#define G_FD_MAX		65536 // file descriptor ids are below this
 
 /**
  * File mode flags
@@ -77,6 +78,15 @@ typedef int g_fs_node_type;
 #define G_FS_NODE_TYPE_FILE ((g_fs_node_type) 4)
 #define G_FS_NODE_TYPE_PIPE ((g_fs_node_type) 5)
 
+/**
+ * Buffer description for vectored reading and writing, has the same
+ * layout as the POSIX <iovec>
+ */
+typedef struct {
+	void* buffer;
+	size_t length;
+} g_fs_iovec;
+
 /**
  * Stat attributes
  */
@@ -92,20 +102,6 @@ typedef int32_t g_fs_register_as_delegate_status;
 #define G_FS_REGISTER_AS_DELEGATE_FAILED_EXISTING ((g_fs_register_as_delegate_status) 1)
 #define G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION ((g_fs_register_as_delegate_status) 2)
 
-/**
- * Transaction IDs
- */
-typedef uint64_t g_fs_transaction_id;
-#define G_FS_TRANSACTION_NO_REPEAT_ID ((g_fs_transaction_id) -1)
-
-/**
- * Status codes for transactions
- */
-typedef int g_fs_transaction_status;
-#define G_FS_TRANSACTION_WAITING ((g_fs_transaction_status) 0) // transaction is waiting for the delegate
-#define G_FS_TRANSACTION_FINISHED ((g_fs_transaction_status) 1) // transaction is finished
-#define G_FS_TRANSACTION_REPEAT ((g_fs_transaction_status) 2) // transaction must call handler again
-
 /**
  * Status codes for the {g_fs_create_node} system call
  */
@@ -124,7 +120,7 @@ typedef int g_fs_discovery_status;
 #define G_FS_DISCOVERY_ERROR ((g_fs_discovery_status) 3)
 
 /**
- * Types of request messages that the kernel might send to a tasked fs delegate
+ * Types of requests that the kernel might post to a tasked fs delegate
  */
 typedef int g_fs_tasked_delegate_request_type;
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER ((g_fs_tasked_delegate_request_type) 0)
@@ -134,6 +130,8 @@ typedef int g_fs_tasked_delegate_request_type;
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY ((g_fs_tasked_delegate_request_type) 4)
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN ((g_fs_tasked_delegate_request_type) 5)
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE ((g_fs_tasked_delegate_request_type) 6)
+#define G_FS_TASKED_DELEGATE_REQUEST_TYPE_CREATE ((g_fs_tasked_delegate_request_type) 7)
+#define G_FS_TASKED_DELEGATE_REQUEST_TYPE_TRUNCATE ((g_fs_tasked_delegate_request_type) 8)
 
 /**
  * Status codes for the {g_fs_open} system call
@@ -180,6 +178,46 @@ typedef int g_fs_seek_status;
 #define G_FS_SEEK_INVALID_FD ((g_fs_seek_status) 1)
 #define G_FS_SEEK_ERROR ((g_fs_seek_status) 2)
 
+/**
+ * Status codes for the {g_fs_unlink} system call
+ */
+typedef int g_fs_unlink_status;
+#define G_FS_UNLINK_SUCCESSFUL ((g_fs_unlink_status) 0)
+#define G_FS_UNLINK_NOT_FOUND ((g_fs_unlink_status) 1)
+#define G_FS_UNLINK_NOT_SUPPORTED ((g_fs_unlink_status) 2)
+#define G_FS_UNLINK_ERROR ((g_fs_unlink_status) 3)
+
+/**
+ * Status codes for the {g_flush} system call
+ */
+typedef int g_fs_flush_status;
+#define G_FS_FLUSH_SUCCESSFUL ((g_fs_flush_status) 0)
+#define G_FS_FLUSH_INVALID_FD ((g_fs_flush_status) 1)
+#define G_FS_FLUSH_ERROR ((g_fs_flush_status) 2)
+
+/**
+ * Readiness events for the {g_poll} system call
+ */
+typedef uint16_t g_fs_poll_events;
+#define G_FS_POLL_READ ((g_fs_poll_events) 1)
+#define G_FS_POLL_WRITE ((g_fs_poll_events) 2)
+#define G_FS_POLL_INVALID ((g_fs_poll_events) 4)
+
+/**
+ * Timeout for the {g_poll} system call to wait until any source is ready
+ */
+#define G_FS_POLL_INFINITE (-1)
+
+/**
+ * A file descriptor to poll. The events field holds the events of interest, the
+ * kernel fills the revents field with the events that are ready.
+ */
+typedef struct {
+	g_fd fd;
+	g_fs_poll_events events;
+	g_fs_poll_events revents;
+}__attribute__((packed)) g_fs_poll_entry;
+
 /**
  * Status codes for the {g_fs_tell} system call
  */
@@ -247,78 +285,99 @@ typedef int g_fs_directory_refresh_status;
 #define G_FS_DIRECTORY_REFRESH_ERROR ((g_fs_directory_refresh_status) 1)
 #define G_FS_DIRECTORY_REFRESH_BUSY ((g_fs_directory_refresh_status) 2)
 
+/**
+ * A single entry as written by the {g_read_directory_entries} system call. Records
+ * are placed one after another, each is followed by its null-terminated name and
+ * padded so that the next record is aligned to four bytes.
+ */
+typedef struct {
+	uint16_t record_length;
+	uint16_t name_length;
+	g_fs_node_type type;
+	g_fs_virt_id node_id;
+	uint64_t length;
+}__attribute__((packed)) g_fs_directory_record;
+
+#define G_FS_DIRECTORY_RECORD_NAME(record)		(((char*) record) + sizeof(g_fs_directory_record))
+#define G_FS_DIRECTORY_RECORD_LENGTH(nameLength)	((sizeof(g_fs_directory_record) + (nameLength) + 1 + 3) & ~3)
+
+/**
+ * Size of the record buffer of a directory iterator
+ */
+#define G_FS_DIRECTORY_ITERATOR_BUFFER_SIZE		4096
+
 typedef struct {
 	g_fs_virt_id node_id;
 	g_fs_node_type type;
+	uint64_t length;
 	char* name;
 } g_fs_directory_entry;
 
+/**
+ * The iterator keeps the records of the last call in its buffer and hands them
+ * out one by one, the cursor is only interpreted by the kernel.
+ */
 typedef struct {
 	g_fs_virt_id node_id;
-	int position;
+	uint64_t cursor;
 	g_fs_directory_entry entry_buffer;
+
+	uint8_t* records;
+	uint32_t records_length;
+	uint32_t records_offset;
+	g_bool finished;
 } g_fs_directory_iterator;
 
 /**
- * Transaction storage structures (NOTE limited to 1 page!)
+ * Number of requests that can be pending on a tasked delegate at the same time
  */
-typedef struct {
-	g_fs_phys_id parent_phys_fs_id;
-	char name[G_FILENAME_MAX];
-
-	g_fs_discovery_status result_status;
-} g_fs_tasked_delegate_transaction_storage_discovery;
-
-typedef struct {
-	g_fs_phys_id phys_fs_id;
-	void* mapped_buffer;
-	int64_t offset;
-	int64_t length;
-	g_virtual_address mapping_start;
-	int32_t mapping_pages;
-
-	int64_t result_read;
-	g_fs_read_status result_status;
-} g_fs_tasked_delegate_transaction_storage_read;
+#define G_FS_TASKED_DELEGATE_REQUESTS		16
 
+/**
+ * A request of the kernel to a tasked delegate. For discovery and creation, the
+ * node fields refer to the parent and the driver returns the physical id and type
+ * of the child. For reading and writing, <buffer> points to the pages of the
+ * requesting task, which are mapped into the driver until the request is completed.
+ * The driver writes the results and then sets <completed>.
+ */
 typedef struct {
+	g_fs_tasked_delegate_request_type type;
 	g_fs_phys_id phys_fs_id;
-	void* mapped_buffer;
+	g_fs_virt_id virt_fs_id;
 	int64_t offset;
 	int64_t length;
-	g_virtual_address mapping_start;
-	int32_t mapping_pages;
-
-	int64_t result_write;
-	g_fs_read_status result_status;
-} g_fs_tasked_delegate_transaction_storage_write;
-
-typedef struct {
-	g_fs_phys_id phys_fs_id;
+	void* buffer;
+	char name[G_FILENAME_MAX];
 
+	int32_t result_status;
 	int64_t result_length;
-	g_fs_read_status result_status;
-} g_fs_tasked_delegate_transaction_storage_get_length;
+	g_fs_phys_id result_phys_fs_id;
+	g_fs_node_type result_type;
 
-typedef struct {
-	g_fs_phys_id parent_phys_fs_id;
-	g_fs_phys_id parent_virt_fs_id;
-
-	g_fs_directory_refresh_status result_status;
-} g_fs_tasked_delegate_transaction_storage_directory_refresh;
+	volatile uint32_t completed;
+}__attribute__((packed)) g_fs_tasked_delegate_request;
 
+/**
+ * Request ring of a tasked delegate, shared between the kernel and the driver.
+ * The kernel posts the index of each request to the queue and advances the head,
+ * the driver takes requests by advancing the tail. Head and tail are free-running.
+ *
+ * If the driver has nothing to do, it sets its wait atom and blocks on it; the
+ * kernel clears it when it posts a request.
+ */
 typedef struct {
-	g_fs_phys_id phys_fs_id;
-	char name[G_FILENAME_MAX];
+	volatile uint32_t head;
+	uint8_t padding_head[60];
 
-	g_fs_open_status result_status;
-} g_fs_tasked_delegate_transaction_storage_open;
+	volatile uint32_t tail;
+	uint8_t padding_tail[60];
 
-typedef struct {
-	g_fs_phys_id phys_fs_id;
+	volatile g_atom driver_waiting;
+	uint8_t padding_info[63];
 
-	g_fs_close_status result_status;
-} g_fs_tasked_delegate_transaction_storage_close;
+	uint32_t queue[G_FS_TASKED_DELEGATE_REQUESTS];
+	g_fs_tasked_delegate_request requests[G_FS_TASKED_DELEGATE_REQUESTS];
+}__attribute__((packed)) g_fs_tasked_delegate_ring;
 
 __END_C
 
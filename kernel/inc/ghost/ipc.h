@@ -24,6 +24,7 @@
 #include "ghost/common.h"
 #include "ghost/kernel.h"
 #include "ghost/stdint.h"
+#include "ghost/types.h"
 
 __BEGIN_C
 
@@ -73,6 +74,34 @@ typedef int g_message_receive_status;
 #define G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE ((g_message_receive_status) 5)
 #define G_MESSAGE_RECEIVE_STATUS_INTERRUPTED ((g_message_receive_status) 6)
 
+/**
+ * Header of a single-producer/single-consumer message ring. The ring lives in
+ * memory that is shared between the two tasks, the content area directly follows
+ * this header. Head and tail are free-running byte counters, the content area
+ * size is a power of two.
+ *
+ * The kernel is only involved if one side must block. The waiting side sets its
+ * wait atom and blocks on it, the other side clears it once it made progress.
+ */
+typedef struct {
+	volatile uint32_t head;
+	uint8_t padding_head[60];
+
+	volatile uint32_t tail;
+	uint8_t padding_tail[60];
+
+	uint32_t capacity;
+	volatile g_atom reader_waiting;
+	volatile g_atom writer_waiting;
+	uint8_t padding_info[58];
+}__attribute__((packed)) g_ring_header;
+
+#define G_RING_CONTENT(ring)				(((uint8_t*) ring) + sizeof(g_ring_header))
+
+// each message in a ring is prefixed with its length and padded to four bytes,
+// the length must not exceed the ring capacity or the result may overflow
+#define G_RING_RECORD_LENGTH(length)		(sizeof(uint32_t) + (((length) + 3) & ~3))
+
 __END_C
 
 #endif
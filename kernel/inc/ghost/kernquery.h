@@ -44,6 +44,10 @@ typedef int g_kernquery_status;
 #define G_KERNQUERY_TASK_LIST			0x601
 #define G_KERNQUERY_TASK_GET_BY_ID		0x602
 
+#define G_KERNQUERY_MESSAGE_QUEUE_GET_BY_ID	0x700
+
+#define G_KERNQUERY_SYSCALL_GET_STATISTICS	0x800
+
 /**
  * PCI
  */
@@ -104,6 +108,41 @@ typedef struct {
 	g_virtual_address memory_used;
 }__attribute__((packed)) g_kernquery_task_get_data;
 
+/**
+ * Used in the {G_KERNQUERY_MESSAGE_QUEUE_GET_BY_ID} query to retrieve
+ * statistics about the message queue of a task.
+ */
+typedef struct {
+	g_tid id;
+	uint8_t found;
+
+	uint32_t depth;
+	uint32_t bytes;
+	uint32_t drops;
+}__attribute__((packed)) g_kernquery_message_queue_get_data;
+
+/**
+ * Number of buckets in a system call latency histogram. Bucket n counts the
+ * calls that took less than 2^(n+1) processor cycles, the last bucket counts
+ * all calls above.
+ */
+#define G_KERNQUERY_SYSCALL_LATENCY_BUCKETS		32
+
+/**
+ * Used in the {G_KERNQUERY_SYSCALL_GET_STATISTICS} query to retrieve
+ * how often a system call was executed and how long it took. Calls that
+ * may be threaded are counted separately depending on whether they could
+ * complete without a kernel thread.
+ */
+typedef struct {
+	uint32_t call;
+	uint8_t found;
+
+	uint32_t inlined;
+	uint32_t threaded;
+	uint32_t latency[G_KERNQUERY_SYSCALL_LATENCY_BUCKETS];
+}__attribute__((packed)) g_kernquery_syscall_statistics_data;
+
 __END_C
 
 #endif
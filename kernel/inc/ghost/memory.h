@@ -22,6 +22,7 @@
 #define __GHOST_MEMORY__
 
 #include "ghost/common.h"
+#include "ghost/stdint.h"
 
 __BEGIN_C
 
@@ -40,6 +41,13 @@ __BEGIN_C
 #define G_TABLE_IN_DIRECTORY_INDEX(address)	((uint32_t)((address / G_PAGE_SIZE) / 1024))
 #define G_PAGE_IN_TABLE_INDEX(address)		((uint32_t)((address / G_PAGE_SIZE) % 1024))
 
+/**
+ * Flags for mapping MMIO areas
+ */
+typedef uint32_t g_mmio_flags;
+#define G_MMIO_FLAG_NONE					((g_mmio_flags) 0)
+#define G_MMIO_FLAG_WRITE_COMBINING			((g_mmio_flags) 1)
+
 __END_C
 
 #endif
@@ -22,6 +22,7 @@
 #define __GHOST_SYS_RAMDISK__
 
 #include "ghost/common.h"
+#include "ghost/stdint.h"
 
 __BEGIN_C
 
@@ -38,6 +39,62 @@ typedef int g_ramdisk_entry_type;
 
 typedef uint32_t g_ramdisk_id;
 
+/**
+ * Ramdisk images in the indexed format start with this header. It is followed by
+ * the entry table, the names (each null-terminated) and the file contents, which
+ * each start on a page boundary. Images without the magic are in the original
+ * sequential format.
+ *
+ * In the compressed version, the table has extended entries and the contents of
+ * files that are flagged as compressed are split into blocks that are compressed
+ * individually. Such contents start with a table of block offsets (relative to the
+ * contents, one more than there are blocks), followed by the blocks in LZ4 block
+ * format. A block that is stored with its raw length is not compressed.
+ */
+#define G_RAMDISK_MAGIC_0			'G'
+#define G_RAMDISK_MAGIC_1			'R'
+#define G_RAMDISK_MAGIC_2			'D'
+#define G_RAMDISK_MAGIC_3			'X'
+#define G_RAMDISK_FORMAT_VERSION	2
+#define G_RAMDISK_FORMAT_VERSION_COMPRESSED	3
+
+#define G_RAMDISK_BLOCK_SIZE		0x10000
+#define G_RAMDISK_BLOCK_COUNT(length)	(((length) + G_RAMDISK_BLOCK_SIZE - 1) / G_RAMDISK_BLOCK_SIZE)
+
+typedef struct {
+	uint8_t magic[4];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t namesOffset;
+	uint32_t namesLength;
+	uint32_t dataOffset;
+}__attribute__((packed)) g_ramdisk_header;
+
+/**
+ * Entry in the table of an indexed image. Offsets are relative to the image start,
+ * except for the name offset which is relative to the names.
+ */
+typedef struct {
+	g_ramdisk_id id;
+	g_ramdisk_id parentId;
+	uint32_t type;
+	uint32_t nameOffset;
+	uint32_t dataOffset;
+	uint32_t dataLength;
+}__attribute__((packed)) g_ramdisk_table_entry;
+
+#define G_RAMDISK_ENTRY_FLAG_COMPRESSED		1
+
+/**
+ * Entry in the table of a compressed image. The stored length is the length of
+ * the contents within the image, the data length is the uncompressed length.
+ */
+typedef struct {
+	g_ramdisk_table_entry entry;
+	uint32_t storedLength;
+	uint32_t flags;
+}__attribute__((packed)) g_ramdisk_compressed_table_entry;
+
 /**
  * Ramdisk entry information struct used within system calls
  */
@@ -21,6 +21,9 @@
 #ifndef __KERNEL_SYSCALLS__
 #define __KERNEL_SYSCALLS__
 
+#include "ghost/calls/calls.h"
+#include "ghost/kernquery.h"
+
 struct g_task;
 
 /**
@@ -28,13 +31,30 @@ struct g_task;
  */
 typedef void (*g_syscall_handler)(g_task*, void*);
 
+/**
+ * Type of an inline handler for a threaded system call. It is executed directly in the
+ * context of the caller and must never block. Returns false if the call could not be
+ * completed without blocking, without having had any effect; the call is then
+ * processed by the threaded handler.
+ */
+typedef bool (*g_syscall_inline_handler)(g_task*, void*);
+
 /**
  * Registration structure
  */
 struct g_syscall_registration
 {
 	g_syscall_handler handler;
+	g_syscall_inline_handler inlineHandler;
 	bool threaded;
+	bool batchable;
+
+	struct
+	{
+		uint32_t inlined;
+		uint32_t threaded;
+		uint32_t latency[G_KERNQUERY_SYSCALL_LATENCY_BUCKETS];
+	} statistics;
 };
 
 /**
@@ -43,7 +63,7 @@ struct g_syscall_registration
  *
  * Depending on the call registration, it is then processed either synchronously by
  * calling the respective handler or a thread is created and the source task is put
- * to waiting state.
+ * to waiting state. If a threaded call has an inline handler, this is tried first.
  */
 void syscallHandle(g_task* task);
 
@@ -60,9 +80,35 @@ void syscallRunThreaded(g_syscall_handler handler, g_task* caller, void* syscall
 void syscallThreadEntry();
 
 /**
- * Creates a system call registration.
+ * Executes the entries of a batch one after another within the calling task. Only calls
+ * that are registered as batchable are executed, threaded calls only if their inline
+ * handler can handle them. When a call puts the task to waiting,
+ * the batch stops after this call.
+ */
+void syscallBatch(g_task* task, g_syscall_batch* data);
+
+/**
+ * @return the registration of a system call or null if the call does not exist
+ */
+g_syscall_registration* syscallGetRegistration(uint32_t call);
+
+/**
+ * Creates a system call registration. A batchable call that is threaded must also have
+ * an inline handler.
+ */
+void syscallRegister(int call, g_syscall_handler handler, bool threaded, bool batchable = false);
+
+/**
+ * Adds an inline handler to the registration of a threaded system call.
+ */
+void syscallRegisterInline(int call, g_syscall_inline_handler inlineHandler);
+
+/**
+ * Fills the statistics of a system call.
+ *
+ * @return whether the call exists
  */
-void syscallRegister(int call, g_syscall_handler handler, bool threaded);
+bool syscallQueryStatistics(uint32_t call, g_kernquery_syscall_statistics_data* out);
 
 /**
  * Creates the system call table.
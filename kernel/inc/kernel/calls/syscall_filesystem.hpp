@@ -26,15 +26,40 @@
 
 void syscallFsOpen(g_task* task, g_syscall_fs_open* data);
 
+/**
+ * Transfers of up to this size are attempted inline before using a kernel thread.
+ */
+#define G_SYSCALL_INLINE_MAXIMUM_TRANSFER	0x4000
+
 void syscallFsSeek(g_task* task, g_syscall_fs_seek* data);
+bool syscallFsSeekInline(g_task* task, g_syscall_fs_seek* data);
 
 void syscallFsRead(g_task* task, g_syscall_fs_read* data);
+bool syscallFsReadInline(g_task* task, g_syscall_fs_read* data);
 
 void syscallFsWrite(g_task* task, g_syscall_fs_write* data);
+bool syscallFsWriteInline(g_task* task, g_syscall_fs_write* data);
+
+void syscallFsReadv(g_task* task, g_syscall_fs_readv* data);
+
+void syscallFsWritev(g_task* task, g_syscall_fs_writev* data);
 
 void syscallFsClose(g_task* task, g_syscall_fs_close* data);
+bool syscallFsCloseInline(g_task* task, g_syscall_fs_close* data);
+
+void syscallFsUnlink(g_task* task, g_syscall_fs_unlink* data);
+
+void syscallFsFlush(g_task* task, g_syscall_fs_flush* data);
+
+void syscallFsPoll(g_task* task, g_syscall_fs_poll* data);
+
+void syscallFsOpenDirectory(g_task* task, g_syscall_fs_open_directory* data);
+
+void syscallFsReadDirectory(g_task* task, g_syscall_fs_read_directory* data);
+bool syscallFsPollInline(g_task* task, g_syscall_fs_poll* data);
 
 void syscallFsLength(g_task* task, g_syscall_fs_length* data);
+bool syscallFsLengthInline(g_task* task, g_syscall_fs_length* data);
 
 void syscallFsTell(g_task* task, g_syscall_fs_tell* data);
 
@@ -46,5 +71,9 @@ void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data);
 
 void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data);
 
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data);
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data);
+
 #endif
 
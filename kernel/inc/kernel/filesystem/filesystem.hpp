@@ -28,6 +28,8 @@
 struct g_fs_node;
 struct g_fs_node_entry;
 struct g_fs_delegate;
+struct g_fs_cache_page;
+struct g_file_descriptor;
 
 /**
  * A node on the virtual file system.
@@ -40,12 +42,40 @@ struct g_fs_node
 
 	char* name;
 	g_fs_node* parent;
+
+	/**
+	 * Children in the order they were added. New children are appended, so a
+	 * directory cursor stays valid while children are added. The entry of this
+	 * node in its parent's list lets a directory read continue from it.
+	 */
 	g_fs_node_entry* children;
+	g_fs_node_entry* childrenTail;
+	g_fs_node_entry* parentEntry;
 
 	g_fs_delegate* delegate;
 
 	bool blocking;
+
+	/**
+	 * Whether all children of this folder are in the tree, see refreshDirectory.
+	 */
 	bool upToDate;
+
+	/**
+	 * Number of descriptors that refer to this node. An unlinked node is freed
+	 * once its last descriptor is closed.
+	 */
+	uint32_t openDescriptors;
+	bool unlinked;
+
+	/**
+	 * Page cache state, only used if the delegate is cached.
+	 */
+	g_fs_cache_page* cachePages;
+	uint32_t cacheDirtyPages;
+	uint64_t cacheNextOffset;
+	uint32_t cacheReadAhead;
+	uint64_t cacheWrittenEnd;
 };
 
 /**
@@ -64,6 +94,30 @@ struct g_fs_delegate
 {
 	g_mutex lock;
 
+	/**
+	 * Whether reads and writes on nodes of this delegate go through the page cache.
+	 * Only useful for delegates that are slow to access, like user-space drivers.
+	 */
+	bool cached;
+
+	/**
+	 * Whether the handlers may wait for a user-space driver. This is only possible
+	 * within kernel threads, so calls on such nodes are never handled inline.
+	 */
+	bool threaded;
+
+	/**
+	 * Whether names that could not be discovered may be remembered as not found.
+	 * Only delegates that see every change to their folders can allow this; a
+	 * user-space driver may create files without the kernel noticing.
+	 */
+	bool cacheMisses;
+
+	/**
+	 * State of delegates that exist more than once, like tasked delegates.
+	 */
+	void* data;
+
 	g_fs_open_status (*open)(g_fs_node* node);
 	g_fs_open_status (*discover)(g_fs_node* parent, const char* name, g_fs_node** outNode);
 	g_fs_read_status (*read)(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
@@ -72,6 +126,21 @@ struct g_fs_delegate
 	g_fs_open_status (*create)(g_fs_node* parent, const char* name, g_fs_node** outFile);
 	g_fs_open_status (*truncate)(g_fs_node* file);
 	g_fs_close_status (*close)(g_fs_node* node);
+	g_fs_unlink_status (*unlink)(g_fs_node* node);
+
+	/**
+	 * Optional, adds all children of the folder to the tree so that it can be listed.
+	 * Delegates that add each child when it is created don't need to implement this.
+	 */
+	g_fs_directory_refresh_status (*refreshDirectory)(g_fs_node* folder);
+
+	/**
+	 * Optional readiness check used by polling. Returns which of the events are ready;
+	 * if none is and a subscriber is given, subscribes it to be notified on changes.
+	 * Delegates without these handlers are always considered ready.
+	 */
+	g_fs_poll_events (*poll)(g_fs_node* node, g_fs_poll_events events, g_tid subscriber);
+	void (*unpoll)(g_fs_node* node, g_tid subscriber);
 
 	/**
 	 * When resolvers used when a task needs to wait for a file.
@@ -101,8 +170,9 @@ g_fs_virt_id filesystemGetNextNodeId();
 g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name);
 
 /**
- * Searches for an existing node in the parent, otherwise asks the delegate of the
- * parent for this child.
+ * Searches for a child in the dentry cache, otherwise asks the delegate of the
+ * parent for this child. Names that the delegate could not find are remembered
+ * as negative entries until a child with that name is added.
  */
 g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild);
 
@@ -119,7 +189,8 @@ g_fs_open_status filesystemFind(g_fs_node* parent, const char* path, g_fs_node**
 g_fs_node* filesystemGetNode(g_fs_virt_id id);
 
 /**
- * Adds a child node to a parent.
+ * Adds a child node to a parent and puts it into the dentry cache. Delegates must
+ * add all children that they create or discover through this function.
  */
 void filesystemAddChild(g_fs_node* parent, g_fs_node* child);
 
@@ -135,6 +206,11 @@ g_fs_delegate* filesystemCreateDelegate();
  */
 g_fs_node* filesystemGetRoot();
 
+/**
+ * Returns the folder that contains all mountpoints.
+ */
+g_fs_node* filesystemGetMountFolder();
+
 /**
  * Searches for the delegate responsible for this node.
  */
@@ -146,22 +222,74 @@ g_fs_delegate* filesystemFindDelegate(g_fs_node* node);
 g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd);
 g_fs_open_status filesystemOpen(g_fs_node* file, g_file_flag_mode flags, g_task* task, g_fd* outFd);
 
+/**
+ * Clones a file descriptor into another process. The node is opened once more
+ * so that the delegate sees one open for each descriptor. A descriptor that
+ * already exists with the target id is closed first.
+ */
+g_file_descriptor* filesystemCloneDescriptor(g_file_descriptor* source, g_process* targetProcess, g_fd targetFd);
+
+/**
+ * Resolves the path of a directory that should be listed.
+ */
+g_fs_open_directory_status filesystemOpenDirectory(g_task* task, const char* path, g_fs_virt_id* outFolderId);
+
+/**
+ * Writes as many {g_fs_directory_record} entries of the folder to the buffer as fit,
+ * starting at the cursor position. The cursor is advanced behind the last entry.
+ */
+g_fs_read_directory_status filesystemReadDirectory(g_fs_virt_id folderId, uint64_t* cursor, uint8_t* buffer, uint32_t length, uint32_t* outWritten);
+
 /**
  * Reads bytes from a file.
  */
 g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outRead);
 g_fs_read_status filesystemRead(g_fs_node* file, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
 
+/**
+ * Attempts to read bytes from a file without blocking. If the read would have to block,
+ * false is returned and nothing was read.
+ */
+bool filesystemTryRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, g_fs_read_status* outStatus, int64_t* outRead);
+
 /**
  * Writes bytes to a file.
  */
 g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outWrote);
 g_fs_write_status filesystemWrite(g_fs_node* file, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
 
+/**
+ * Attempts to write bytes to a file without blocking, see filesystemTryRead.
+ */
+bool filesystemTryWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, g_fs_write_status* outStatus, int64_t* outWrote);
+
+/**
+ * Reads into multiple buffers, filling each before continuing with the next. The descriptor
+ * is resolved only once. Stops at the first short read; only blocks while nothing was read yet.
+ */
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vector, int32_t count, int64_t* outRead);
+
+/**
+ * Writes from multiple buffers in order, see filesystemReadVector.
+ */
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vector, int32_t count, int64_t* outWrote);
+
+/**
+ * Returns whether operations on the descriptor may have to wait for a user-space
+ * delegate and therefore must run in a kernel thread.
+ */
+bool filesystemNeedsThread(g_task* task, g_fd fd);
+
 /**
  * Closes a file descriptor.
  */
-g_fs_close_status filesystemClose(g_pid process, g_fd fd, g_bool removeDescriptor);
+g_fs_close_status filesystemClose(g_process* process, g_fd fd, g_bool removeDescriptor);
+
+/**
+ * Lets the delegate close the node once a descriptor was closed and frees the node
+ * if it was unlinked and this was its last descriptor.
+ */
+g_fs_close_status filesystemCloseNode(g_fs_node* file);
 
 /**
  * Seeks in a file.
@@ -184,6 +312,34 @@ g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_
  */
 g_fs_open_status filesystemTruncate(g_fs_node* file);
 
+/**
+ * Removes a file from its parent. The delegate decides when the contents are freed,
+ * descriptors that are still open keep referring to the node.
+ */
+g_fs_unlink_status filesystemUnlink(g_fs_node* file);
+
+/**
+ * Writes data of the file that is held in the page cache back to its delegate.
+ */
+g_fs_flush_status filesystemFlush(g_task* task, g_fd fd);
+
+/**
+ * Checks which of the events are ready on the file descriptor, see the poll handler
+ * of the delegate. Returns {G_FS_POLL_INVALID} if the descriptor is not valid.
+ */
+g_fs_poll_events filesystemPollDescriptor(g_process* process, g_fd fd, g_fs_poll_events events, g_tid subscriber);
+
+/**
+ * Removes the subscription that was made when polling the file descriptor.
+ */
+void filesystemUnpollDescriptor(g_process* process, g_fd fd, g_tid subscriber);
+
+/**
+ * Returns the node that a path is resolved from, which is the working directory of
+ * the process for relative paths and the root otherwise.
+ */
+g_fs_node* filesystemGetPathOrigin(g_task* task, const char* path);
+
 /**
  * The task just tried to write to this file but the file was busy. This puts a waiter on the task
  * which lets the task wait until it can write to the file again.
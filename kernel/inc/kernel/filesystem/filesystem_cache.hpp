@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_CACHE__
+#define __KERNEL_FILESYSTEM_CACHE__
+
+#include "ghost/fs.h"
+#include "kernel/filesystem/filesystem.hpp"
+
+/**
+ * Limits of the page cache. Clean pages are evicted in least-recently-used order
+ * once the cache is full or the physical allocator runs low; a node is written
+ * back once it has too many dirty pages. A single request to the delegate fills
+ * at most G_FS_CACHE_MAXIMUM_FILL pages.
+ */
+#define G_FS_CACHE_MAXIMUM_PAGES		2048
+#define G_FS_CACHE_MINIMUM_FREE_PAGES	256
+#define G_FS_CACHE_MAXIMUM_DIRTY_PAGES	256
+#define G_FS_CACHE_MAXIMUM_READ_AHEAD	32
+#define G_FS_CACHE_MAXIMUM_FILL			64
+
+/**
+ * A cached page of a file. The valid length is the number of bytes that exist in
+ * the file, it is only less than a page at the end of the file.
+ */
+struct g_fs_cache_page
+{
+	g_fs_node* node;
+	uint32_t index;
+	g_virtual_address data;
+	uint32_t valid;
+
+	bool dirty;
+	bool busy;
+
+	/**
+	 * Set if the page was dropped while it was busy, it is freed once the
+	 * write-back has finished.
+	 */
+	bool dropped;
+
+	g_fs_cache_page* lruPrevious;
+	g_fs_cache_page* lruNext;
+	g_fs_cache_page* nodePrevious;
+	g_fs_cache_page* nodeNext;
+};
+
+/**
+ * Initializes the page cache.
+ */
+void filesystemCacheInitialize();
+
+/**
+ * Reads from a node through the page cache. Missing pages are read from the delegate,
+ * on sequential access multiple pages ahead are read at once. If filling is not
+ * allowed, a read that misses the cache returns G_FS_READ_BUSY.
+ */
+g_fs_read_status filesystemCacheRead(g_fs_delegate* delegate, g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead,
+		bool allowFill = true);
+
+/**
+ * Writes to a node through the page cache. Data is only written to the delegate
+ * when the node is flushed or its pages are evicted.
+ */
+g_fs_write_status filesystemCacheWrite(g_fs_delegate* delegate, g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+/**
+ * Writes all dirty pages of the node back to its delegate.
+ */
+g_fs_write_status filesystemCacheFlush(g_fs_node* node);
+
+/**
+ * Discards all cached pages of the node without writing them back.
+ */
+void filesystemCacheDrop(g_fs_node* node);
+
+/**
+ * Hands the close of a node to the page cache worker. Used when dirty pages must
+ * be written back but the calling thread can't wait for the delegate, like when
+ * the descriptors of an exiting process are closed. The worker flushes the node
+ * and then closes it with <filesystemCloseNode>.
+ */
+void filesystemCacheDeferClose(g_fs_node* node);
+
+/**
+ * Whether closes are waiting for the page cache worker.
+ */
+bool filesystemCacheHasWork();
+
+#endif
@@ -38,6 +38,10 @@ g_fs_length_status filesystemPipeDelegateGetLength(g_fs_node* node, uint64_t* ou
 
 g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file);
 
+g_fs_poll_events filesystemPipeDelegatePoll(g_fs_node* node, g_fs_poll_events events, g_tid subscriber);
+
+void filesystemPipeDelegateUnpoll(g_fs_node* node, g_tid subscriber);
+
 bool filesystemPipeDelegateWaitResolverRead(g_task* task);
 
 bool filesystemPipeDelegateWaitResolverWrite(g_task* task);
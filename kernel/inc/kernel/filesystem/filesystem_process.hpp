@@ -23,64 +23,72 @@
 
 #include "ghost/kernel.h"
 #include "ghost/fs.h"
-#include "kernel/utils/hashmap.hpp"
 #include "kernel/filesystem/filesystem.hpp"
 
 /**
- * Structure of a file descriptor.
+ * Structure of a file descriptor. The node is cached so that I/O on the
+ * descriptor does not need to look it up.
  */
 struct g_file_descriptor
 {
 	g_fd id;
 	uint64_t offset;
 	g_fs_virt_id nodeId;
+	g_fs_node* node;
 	g_file_flag_mode openFlags;
 };
 
 /**
- * Per-process file system information structure.
+ * Table of file descriptors, indexed by descriptor id. Tables are never resized
+ * in place; when a larger table is required, the old one is kept in the list of
+ * previous tables until the process is removed, so lookups need no lock.
  */
-struct g_filesystem_process
+struct g_file_descriptor_table
 {
-	g_fd nextDescriptor;
-	g_mutex nextDescriptorLock;
-	g_hashmap<g_fd, g_file_descriptor*>* descriptors;
+	g_fd capacity;
+	g_file_descriptor** descriptors;
+	g_file_descriptor_table* previous;
 };
 
 /**
- * Initializes this unit.
+ * Per-process file system information structure.
  */
-void filesystemProcessInitialize();
+struct g_filesystem_process
+{
+	g_mutex lock;
+	g_file_descriptor_table* table;
+};
 
 /**
  * Creates a file system information structure for a process.
  */
-void filesystemProcessCreate(g_pid pid);
+void filesystemProcessCreate(g_process* process);
 
 /**
  * Removes file system information for a process. Closes all file descriptors of this process.
  */
-void filesystemProcessRemove(g_pid pid);
+void filesystemProcessRemove(g_process* process);
 
 /**
- * Creates a file descriptor opening a node.
+ * Creates a file descriptor opening a node. Without an explicit descriptor id, the
+ * lowest unused id after stdin, stdout and stderr is taken.
  */
-g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeId, g_file_flag_mode flags,
+g_fs_open_status filesystemProcessCreateDescriptor(g_process* process, g_fs_node* node, g_file_flag_mode flags,
 		g_file_descriptor** outDescriptor, g_fd optionalFd = G_FD_NONE);
 
 /**
  * Finds a file descriptor.
  */
-g_file_descriptor* filesystemProcessGetDescriptor(g_pid pid, g_fd fd);
+g_file_descriptor* filesystemProcessGetDescriptor(g_process* process, g_fd fd);
 
 /**
  * Closes a file descriptor.
  */
-void filesystemProcessRemoveDescriptor(g_pid pid, g_fd fd);
+void filesystemProcessRemoveDescriptor(g_process* process, g_fd fd);
 
 /**
  * Clones a file descriptor.
  */
-g_file_descriptor* filesystemProcessCloneDescriptor(g_file_descriptor* descriptor, g_pid targetPid, g_fd targetFd);
+g_file_descriptor* filesystemProcessCloneDescriptor(g_file_descriptor* descriptor, g_process* targetProcess, g_fd targetFd);
 
 #endif
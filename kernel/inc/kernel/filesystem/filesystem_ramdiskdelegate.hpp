@@ -31,6 +31,8 @@ g_fs_close_status filesystemRamdiskDelegateClose(g_fs_node* node);
 
 g_fs_open_status filesystemRamdiskDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode);
 
+g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDirectory(g_fs_node* folder);
+
 g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
 
 g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
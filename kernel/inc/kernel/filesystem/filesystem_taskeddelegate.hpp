@@ -0,0 +1,104 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+#define __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+
+#include "ghost/fs.h"
+#include "shared/system/mutex.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+
+/**
+ * Kernel-side state of a request slot. Buffers of read and write requests are
+ * mapped into the driver while the request is pending. Detached requests have no
+ * task waiting for them and are released once the driver completed them.
+ */
+struct g_fs_tasked_delegate_slot
+{
+	bool used;
+	bool detached;
+
+	g_virtual_address mapping;
+	uint32_t mappingPages;
+};
+
+/**
+ * A delegate that is implemented by a user-space driver. Requests are passed to the
+ * driver through a ring in kernel memory that is also mapped into the driver; the
+ * requesting task waits until the driver marks its request as completed.
+ */
+struct g_fs_tasked_delegate
+{
+	g_mutex lock;
+
+	/**
+	 * The driver process, null once it has exited.
+	 */
+	g_process* process;
+	g_fs_delegate* delegate;
+
+	g_fs_tasked_delegate_ring* ring;
+	g_virtual_address ringMapping;
+	uint32_t ringPages;
+
+	g_fs_tasked_delegate_slot slots[G_FS_TASKED_DELEGATE_REQUESTS];
+
+	g_fs_tasked_delegate* next;
+};
+
+void filesystemTaskedDelegateInitialize();
+
+/**
+ * Registers the process of the task as a delegate and creates a mountpoint with
+ * the given name in the mount folder.
+ */
+g_fs_register_as_delegate_status filesystemTaskedDelegateRegister(g_task* task, const char* name, g_fs_phys_id physMountpointId,
+		g_fs_virt_id* outMountpointId, g_fs_tasked_delegate_ring** outRing);
+
+/**
+ * Creates or updates a node below a parent that belongs to a delegate of the process
+ * of the task. Used by drivers to populate directories.
+ */
+g_fs_create_node_status filesystemTaskedDelegateCreateNode(g_task* task, g_fs_virt_id parentId, const char* name, g_fs_node_type type,
+		g_fs_phys_id physicalId, g_fs_virt_id* outCreatedId);
+
+/**
+ * Detaches all delegates of a process that is being removed. Pending requests fail,
+ * the mountpoints stay but all further requests fail.
+ */
+void filesystemTaskedDelegateProcessRemoved(g_process* process);
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node);
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node);
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode);
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength);
+
+g_fs_open_status filesystemTaskedDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile);
+
+g_fs_open_status filesystemTaskedDelegateTruncate(g_fs_node* file);
+
+#endif
@@ -0,0 +1,79 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_TMP_DELEGATE__
+#define __KERNEL_FILESYSTEM_TMP_DELEGATE__
+
+#include "ghost/fs.h"
+#include "shared/system/mutex.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+
+/**
+ * A file on the tmpfs. The contents are kept in pages that are allocated when they
+ * are first written to; pages that were never written are holes and read as zeros.
+ * Growing a file only grows the page table, contents are never copied.
+ *
+ * Reads and writes copy without holding the tmpfs lock. While they do, the file is
+ * busy: pages that are dropped by a truncate are retired instead of freed, and
+ * the file itself is kept, until the last copy has finished.
+ */
+struct g_fs_tmp_retired_pages
+{
+	g_virtual_address* pages;
+	uint32_t pageCapacity;
+	g_fs_tmp_retired_pages* next;
+};
+
+struct g_fs_tmp_file
+{
+	g_fs_phys_id id;
+	uint64_t length;
+
+	g_virtual_address* pages;
+	uint32_t pageCapacity;
+
+	int32_t openCount;
+	bool unlinked;
+
+	uint32_t busy;
+	g_fs_tmp_retired_pages* retired;
+};
+
+void filesystemTmpDelegateInitialize();
+
+g_fs_open_status filesystemTmpDelegateOpen(g_fs_node* node);
+
+g_fs_close_status filesystemTmpDelegateClose(g_fs_node* node);
+
+g_fs_open_status filesystemTmpDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode);
+
+g_fs_read_status filesystemTmpDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
+
+g_fs_write_status filesystemTmpDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+g_fs_length_status filesystemTmpDelegateGetLength(g_fs_node* node, uint64_t* outLength);
+
+g_fs_open_status filesystemTmpDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile);
+
+g_fs_open_status filesystemTmpDelegateTruncate(g_fs_node* file);
+
+g_fs_unlink_status filesystemTmpDelegateUnlink(g_fs_node* file);
+
+#endif
@@ -32,6 +32,12 @@ struct g_ramdisk
 	g_ramdisk_entry* firstEntry;
 	g_ramdisk_entry* root;
 	uint32_t nextUnusedId = 0;
+
+	/**
+	 * Entries indexed by their id, the root is at index 0.
+	 */
+	g_ramdisk_entry** entries;
+	uint32_t entriesCapacity;
 };
 
 extern g_ramdisk* ramdiskMain;
@@ -45,6 +51,10 @@ extern g_ramdisk* ramdiskMain;
  */
 void ramdiskLoadFromModule(g_multiboot_module* module);
 
+/**
+ * Parses the ramdisk contents and builds the id index and the child tables
+ * of each folder.
+ */
 void ramdiskParseContents(g_multiboot_module* module);
 
 /**
@@ -98,6 +108,28 @@ uint32_t ramdiskGetChildCount(g_ramdisk_id id);
  */
 g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index);
 
+/**
+ * Reads file contents of an entry. Contents of compressed files are decompressed
+ * block-wise on demand.
+ *
+ * @param entry		the file entry
+ * @param offset	offset within the file
+ * @param buffer	target buffer
+ * @param length	number of bytes to read
+ * @return the number of bytes read
+ */
+uint32_t ramdiskReadData(g_ramdisk_entry* entry, uint32_t offset, uint8_t* buffer, uint32_t length);
+
+/**
+ * Replaces the contents of a file that are stored in the image with the given
+ * copy. Decompressed blocks of a compressed file are released; readers that
+ * are still copying out of them are waited for.
+ *
+ * @param entry		the file entry
+ * @param data		copy of the file contents
+ */
+void ramdiskReleaseBlocks(g_ramdisk_entry* entry, uint8_t* data);
+
 /**
  * Returns the root.
  */
@@ -0,0 +1,37 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_RAMDISK_COMPRESSION__
+#define __KERNEL_RAMDISK_COMPRESSION__
+
+#include "ghost/stdint.h"
+
+/**
+ * Decompresses a single block in LZ4 block format.
+ *
+ * @param source		compressed block
+ * @param sourceLength	length of the compressed block
+ * @param target		buffer for the decompressed data
+ * @param targetLength	capacity of the buffer
+ * @return the number of decompressed bytes or -1 if the block is malformed
+ */
+int32_t ramdiskDecompressBlock(const uint8_t* source, uint32_t sourceLength, uint8_t* target, uint32_t targetLength);
+
+#endif
@@ -23,6 +23,26 @@
 
 #include "ghost/stdint.h"
 #include "ghost/ramdisk.h"
+#include "kernel/utils/hashmap.hpp"
+
+struct g_ramdisk_entry;
+
+/**
+ * A decompressed block of a compressed file. Readers pin the block while they
+ * copy out of it; unpinned blocks are evicted in least-recently-used order.
+ */
+struct g_ramdisk_block
+{
+	g_ramdisk_entry* entry;
+	uint32_t index;
+	uint8_t* data;
+
+	uint32_t references;
+	bool cached;
+
+	g_ramdisk_block* lruPrevious;
+	g_ramdisk_block* lruNext;
+};
 
 /**
  * Struct of a ramdisk entry
@@ -41,6 +61,24 @@ struct g_ramdisk_entry
 
 	bool dataOnRamdisk;
 	uint32_t notOnRdBufferLength;
+
+	/**
+	 * Only used for compressed files, data is then null. The stored contents
+	 * stay within the image, blocks are decompressed on access and kept in the
+	 * block table until they are evicted.
+	 */
+	bool compressed;
+	uint8_t* storedData;
+	g_ramdisk_block** blocks;
+
+	/**
+	 * Only used for folders. Children are kept in an array for iteration and
+	 * in a map for lookup by name, the map does not copy the names.
+	 */
+	g_ramdisk_entry** children;
+	uint32_t childCount;
+	uint32_t childCapacity;
+	g_hashmap<const char*, g_ramdisk_entry*>* childrenByName;
 };
 
 #endif
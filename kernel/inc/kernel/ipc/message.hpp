@@ -23,13 +23,47 @@
 
 #include "ghost.h"
 #include "shared/system/mutex.hpp"
+#include "kernel/ipc/poll.hpp"
+
+/**
+ * Number of buckets in the transaction index of each message queue.
+ */
+#define G_MESSAGE_QUEUE_TRANSACTION_BUCKETS     16
+
+/**
+ * Kernel-side wrapper of a message. The entry is linked in the queue and,
+ * if the message has a transaction, in the bucket of its transaction. The
+ * header is followed by the message content.
+ */
+struct g_message_entry
+{
+    g_message_entry* previous;
+    g_message_entry* next;
+
+    g_message_entry* previousInTransaction;
+    g_message_entry* nextInTransaction;
+
+    g_message_header header;
+};
+
+struct g_message_transaction_bucket
+{
+    g_message_entry* head;
+    g_message_entry* tail;
+};
 
 struct g_message_queue
 {
     g_mutex lock;
-    g_message_header* head;
-    g_message_header* tail;
+    g_message_entry* head;
+    g_message_entry* tail;
+    g_message_transaction_bucket transactions[G_MESSAGE_QUEUE_TRANSACTION_BUCKETS];
+
     uint32_t size;
+    uint32_t count;
+    uint32_t drops;
+
+    g_poll_subscription* pollers;
 };
 
 /**
@@ -38,15 +72,34 @@ struct g_message_queue
 void messageInitialize();
 
 /**
- * Sends a message.
+ * Sends a message. The mode is only used to decide whether a rejected
+ * message counts as dropped or will be retried by the sender.
  */
-g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, uint32_t length, g_message_transaction tx);
+g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, uint32_t length, g_message_transaction tx, g_message_send_mode mode);
 
 /**
  * Receives a message.
  */
 g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, uint32_t max, g_message_transaction tx);
 
+/**
+ * Returns whether a message is waiting in the queue of the receiver. If not and a
+ * subscriber is given, it is notified once a message is sent to the receiver.
+ */
+bool messagePoll(g_tid receiver, g_tid subscriber);
+
+/**
+ * Removes a subscription that was made by <messagePoll>.
+ */
+void messageUnpoll(g_tid receiver, g_tid subscriber);
+
+/**
+ * Fills the given query structure with the statistics of a tasks message queue.
+ *
+ * @return whether the task has a message queue
+ */
+bool messageQueryQueue(g_tid task, g_kernquery_message_queue_get_data* out);
+
 /**
  * When a task is removed, this function is called to cleanup any occupied memory.
  */
@@ -23,6 +23,7 @@
 
 #include "ghost.h"
 #include "shared/system/mutex.hpp"
+#include "kernel/ipc/poll.hpp"
 
 /**
  * Entry in the reference list of a pipe.
@@ -47,6 +48,11 @@ struct g_pipeline
 	uint32_t capacity;
 
 	uint16_t references;
+
+	/**
+	 * Tasks that poll this pipe, notified whenever data is written or read.
+	 */
+	g_poll_subscription* pollers;
 };
 
 /**
@@ -79,6 +85,17 @@ void pipeAddReference(g_fs_phys_id pipeId);
  */
 void pipeRemoveReference(g_fs_phys_id pipeId);
 
+/**
+ * Returns which of the events are ready on the pipe. If none is ready and a
+ * subscriber is given, it is notified once the pipe was written or read.
+ */
+g_fs_poll_events pipePoll(g_fs_phys_id pipeId, g_fs_poll_events events, g_tid subscriber);
+
+/**
+ * Removes a subscription that was made by <pipePoll>.
+ */
+void pipeUnpoll(g_fs_phys_id pipeId, g_tid subscriber);
+
 g_fs_read_status pipeRead(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
 
 g_fs_write_status pipeWrite(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
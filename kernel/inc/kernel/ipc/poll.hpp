@@ -0,0 +1,69 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_IPC_POLL__
+#define __KERNEL_IPC_POLL__
+
+#include "ghost.h"
+#include "ghost/calls/calls.h"
+#include "kernel/tasking/tasking.hpp"
+
+/**
+ * A task that waits for a source to become ready. Each source that can be polled
+ * holds a list of these subscriptions and notifies them whenever its readiness may
+ * have changed. Subscriptions refer to the task by id so that a list never points
+ * to a task that was already removed; such subscriptions are dropped on notify.
+ */
+struct g_poll_subscription
+{
+	g_tid task;
+	g_poll_subscription* next;
+};
+
+/**
+ * Adds the task to the subscription list, if it is not subscribed yet. The caller
+ * must hold the lock of the source that owns the list.
+ */
+void pollSubscribe(g_poll_subscription** list, g_tid task);
+
+/**
+ * Removes the task from the subscription list. The caller must hold the lock of
+ * the source that owns the list.
+ */
+void pollUnsubscribe(g_poll_subscription** list, g_tid task);
+
+/**
+ * Notifies all subscribed tasks that the source might have become ready. The caller
+ * must hold the lock of the source that owns the list.
+ */
+void pollNotify(g_poll_subscription** list);
+
+/**
+ * Notifies all subscribed tasks and frees the list, used when the source is removed.
+ */
+void pollClear(g_poll_subscription** list);
+
+/**
+ * Waits until any of the polled file descriptors or the message queue of the task
+ * is ready or the timeout has elapsed. Must be called from a syscall thread.
+ */
+void pollWait(g_task* task, g_syscall_fs_poll* data);
+
+#endif
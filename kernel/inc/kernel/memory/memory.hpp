@@ -40,4 +40,31 @@ void memoryInitializePhysicalAllocator(g_setup_information* setupInformation);
 
 void memoryUnmapSetupMemory();
 
+/**
+ * Allocates a single zeroed page in the kernel address space, backed by a page taken
+ * directly from the physical allocator instead of the heap.
+ *
+ * @return the virtual address of the page or 0 if out of memory
+ */
+g_virtual_address memoryAllocateKernelPage();
+
+/**
+ * Frees a page that was allocated with memoryAllocateKernelPage.
+ */
+void memoryFreeKernelPage(g_virtual_address page);
+
+/**
+ * Allocates a virtually contiguous range of zeroed pages in the kernel address space,
+ * like memoryAllocateKernelPage. Unlike heap memory, the range shares its pages with
+ * nothing else, so they can be mapped into a user process.
+ *
+ * @return the virtual address of the range or 0 if out of memory
+ */
+g_virtual_address memoryAllocateKernelRange(uint32_t pages);
+
+/**
+ * Frees a range that was allocated with memoryAllocateKernelRange.
+ */
+void memoryFreeKernelRange(g_virtual_address range);
+
 #endif
@@ -78,4 +78,15 @@ g_physical_address pagingGetCurrentSpace();
  */
 g_physical_address pagingVirtualToPhysical(g_virtual_address addr);
 
+/**
+ * Reads for a given virtual address (which must exist in the currently mapped
+ * address space) the flags of the page entry.
+ *
+ * @param addr
+ * 		the address to resolve
+ *
+ * @return the page flags or 0 if the page is not mapped
+ */
+uint32_t pagingGetPageFlags(g_virtual_address addr);
+
 #endif
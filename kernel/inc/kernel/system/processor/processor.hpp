@@ -103,6 +103,20 @@ enum class g_cpuid_extended_ecx_feature
 #define IA32_APIC_BASE_MSR			0x1B
 #define IA32_APIC_BASE_MSR_BSP		0x100
 #define IA32_APIC_BASE_MSR_ENABLE	0x800
+#define IA32_PAT_MSR				0x277
+
+/**
+ * Memory types in the page attribute table
+ */
+#define G_PAT_MEMORY_TYPE_UNCACHEABLE		0x00u
+#define G_PAT_MEMORY_TYPE_WRITE_COMBINING	0x01u
+
+/**
+ * The page attribute table entry that is programmed to write-combining. Entry 7
+ * is selected by setting the PAT, PCD and PWT bits on a page; by default it is
+ * uncacheable and it is not used by the kernel otherwise.
+ */
+#define G_PAT_ENTRY_WRITE_COMBINING			7
 
 struct g_processor
 {
@@ -202,6 +216,17 @@ void processorPrintInformation();
  */
 void processorEnableSSE();
 
+/**
+ * Programs the page attribute table of the current processor so that pages
+ * can be mapped as write-combining (see G_PAGE_WRITE_COMBINING_FLAGS).
+ */
+void processorEnablePat();
+
+/**
+ * Whether pages can be mapped as write-combining.
+ */
+bool processorSupportsWriteCombining();
+
 /**
  * Returns the CPU's vendor. "out" must be a pointer to a
  * buffer of at least 12 bytes.
@@ -223,4 +248,9 @@ void processorWriteMsr(uint32_t msr, uint32_t lo, uint32_t hi);
  */
 uint32_t processorReadEflags();
 
+/**
+ * Reads the time stamp counter.
+ */
+uint64_t processorReadTimestamp();
+
 #endif
@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_ASYNC__
+#define __KERNEL_ASYNC__
+
+#include "ghost/calls/calls.h"
+#include "kernel/tasking/tasking.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Maximum number of kernel workers that execute asynchronous calls for a single process.
+ */
+#define G_ASYNC_MAXIMUM_WORKERS		4
+
+/**
+ * A call that was taken from the submission ring and waits for a worker.
+ */
+struct g_async_operation
+{
+	g_tid source;
+	uint32_t call;
+	void* data;
+	uint32_t userData;
+
+	g_async_operation* next;
+};
+
+/**
+ * Asynchronous call state of a process.
+ */
+struct g_async_context
+{
+	g_mutex lock;
+	g_async_ring* ring;
+
+	g_async_operation* head;
+	g_async_operation* tail;
+	uint32_t queued;
+
+	/**
+	 * Number of calls that were taken from the submission ring but are not yet
+	 * completed. Together with the unconsumed completions this may never exceed
+	 * the ring size, so a worker always finds a free completion slot.
+	 */
+	uint32_t pending;
+
+	int workers;
+	int busyWorkers;
+};
+
+/**
+ * Sets up asynchronous calls for the process of the task using the given rings.
+ */
+g_async_setup_status asyncSetup(g_task* task, g_async_ring* ring, uint32_t entries);
+
+/**
+ * Takes calls from the submission ring of the tasks process and queues them for the
+ * workers. Starts new workers if necessary.
+ *
+ * @return the number of calls taken
+ */
+uint32_t asyncSubmit(g_task* task);
+
+/**
+ * @return the number of completions that are available to the process
+ */
+uint32_t asyncAvailableCompletions(g_process* process);
+
+/**
+ * Entry of a worker thread.
+ */
+void asyncWorkerEntry();
+
+/**
+ * Frees the asynchronous call state of a process that is being removed.
+ */
+void asyncProcessRemoved(g_process* process);
+
+#endif
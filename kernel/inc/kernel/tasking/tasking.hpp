@@ -35,6 +35,9 @@ struct g_process;
 struct g_task;
 struct g_tasking_local;
 struct g_elf_object;
+struct g_async_context;
+struct g_fs_node;
+struct g_filesystem_process;
 
 typedef bool (*g_wait_resolver)(g_task*);
 
@@ -130,6 +133,7 @@ struct g_task
 
 	/**
 	 * For all syscalls (threaded and non-threaded) the handler and data field are filled.
+	 * The call id and start time stamp are used for the call statistics.
 	 *
 	 * When the task issues a long-running syscall, a kernel task is created to execute it.
 	 * In the executing task, the processingTask field is filled with the task that processes the
@@ -140,6 +144,9 @@ struct g_task
 		g_syscall_handler handler;
 		void* data;
 
+		uint32_t call;
+		uint64_t start;
+
 		g_task* processingTask;
 		g_task* sourceTask;
 	} syscall;
@@ -151,6 +158,11 @@ struct g_task
 	g_wait_resolver waitResolver;
 	void* waitData;
 
+	/**
+	 * Set by polled sources when their readiness may have changed, see <pollNotify>.
+	 */
+	volatile bool pollNotified;
+
 	/**
 	 * If the task gets interrupted by a signal or an IRQ, the current state is stored in this
 	 * structure and later restored from it.
@@ -287,9 +299,24 @@ struct g_process
 		const char* arguments;
 		const char* executablePath;
 		char* workingDirectory;
+
+		/**
+		 * Node of the working directory, relative paths are resolved from here.
+		 */
+		g_fs_node* workingDirectoryNode;
 	} environment;
 
 	g_process_info* userProcessInfo;
+
+	/**
+	 * Only filled once the process has set up asynchronous calls.
+	 */
+	g_async_context* async;
+
+	/**
+	 * File system information, including the descriptor table.
+	 */
+	g_filesystem_process* filesystem;
 };
 
 /**
@@ -71,6 +71,44 @@ void waitForMessageSend(g_task* task);
  */
 void waitForMessageReceive(g_task* task);
 
+/**
+ * Lets an asynchronous call worker wait until calls are queued for its process.
+ */
+void waitForAsyncWork(g_task* task);
+
+/**
+ * Lets the task wait until the given number of completions is available in the
+ * completion ring of its process.
+ * 
+ * @note uses the <syscall.data> on the task directly
+ */
+void waitForAsyncCompletion(g_task* task, uint32_t minimum);
+
+/**
+ * Like <waitForMessageSend> and <waitForMessageReceive>, but used by asynchronous call
+ * workers that send or receive on behalf of the source task.
+ *
+ * @note uses the <syscall.data> on the task directly
+ */
+void waitForAsyncMessageSend(g_task* task, g_tid source);
+void waitForAsyncMessageReceive(g_task* task, g_tid source);
+
+/**
+ * Lets the task wait until a tasked filesystem delegate has completed a request.
+ */
+void waitForDelegateRequest(g_task* task, volatile uint32_t* completed);
+
+/**
+ * Lets the page cache worker wait until closes are deferred to it.
+ */
+void waitForCacheWork(g_task* task);
+
+/**
+ * Lets the task wait until a polled source notifies it or the timeout, counted from
+ * the given start time, has elapsed. A negative timeout waits for a notification only.
+ */
+void waitForPoll(g_task* task, uint32_t startTime, int32_t timeout);
+
 /**
  * Makes the task wait for the VM86 task and then copies the data from the <registerStore>
  * into the source tasks syscall data.
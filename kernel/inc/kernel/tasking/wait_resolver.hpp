@@ -47,6 +47,27 @@ struct g_wait_resolver_join_data
 	g_tid joinedTaskId;
 };
 
+struct g_wait_resolver_async_completion_data
+{
+	uint32_t minimum;
+};
+
+struct g_wait_resolver_async_message_data
+{
+	g_tid source;
+};
+
+struct g_wait_resolver_delegate_request_data
+{
+	volatile uint32_t* completed;
+};
+
+struct g_wait_resolver_poll_data
+{
+	uint32_t startTime;
+	int32_t timeout;
+};
+
 struct g_wait_vm86_data
 {
 	g_tid vm86TaskId;
@@ -63,6 +84,20 @@ bool waitResolverSendMessage(g_task* task);
 
 bool waitResolverReceiveMessage(g_task* task);
 
+bool waitResolverAsyncWork(g_task* task);
+
+bool waitResolverAsyncCompletion(g_task* task);
+
+bool waitResolverAsyncSendMessage(g_task* task);
+
+bool waitResolverAsyncReceiveMessage(g_task* task);
+
+bool waitResolverDelegateRequest(g_task* task);
+
+bool waitResolverCacheWork(g_task* task);
+
+bool waitResolverPoll(g_task* task);
+
 bool waitResolverVm86(g_task* task);
 
 #endif
@@ -40,12 +40,20 @@ const uint32_t G_PAGE_CACHE_DISABLED = 16;
 const uint32_t G_PAGE_ACCESSED = 32;
 const uint32_t G_PAGE_DIRTY = 64;
 const uint32_t G_PAGE_GLOBAL = 128;
+const uint32_t G_PAGE_ATTRIBUTE_TABLE = 128;
 
 #define DEFAULT_KERNEL_TABLE_FLAGS (G_PAGE_TABLE_PRESENT | G_PAGE_TABLE_READWRITE)
 #define DEFAULT_KERNEL_PAGE_FLAGS (G_PAGE_PRESENT | G_PAGE_READWRITE | G_PAGE_GLOBAL)
 #define DEFAULT_USER_TABLE_FLAGS (G_PAGE_TABLE_PRESENT | G_PAGE_TABLE_READWRITE | G_PAGE_TABLE_USERSPACE)
 #define DEFAULT_USER_PAGE_FLAGS (G_PAGE_PRESENT | G_PAGE_READWRITE | G_PAGE_USERSPACE)
 
+/**
+ * Bits of a page entry that select the page attribute table entry. Setting all
+ * of them selects the entry that the kernel programs to write-combining.
+ */
+#define G_PAGE_CACHE_ATTRIBUTE_MASK (G_PAGE_ATTRIBUTE_TABLE | G_PAGE_CACHE_DISABLED | G_PAGE_WRITETHROUGH)
+#define G_PAGE_WRITE_COMBINING_FLAGS (G_PAGE_ATTRIBUTE_TABLE | G_PAGE_CACHE_DISABLED | G_PAGE_WRITETHROUGH)
+
 typedef volatile uint32_t* g_page_directory;
 typedef volatile uint32_t* g_page_table;
 
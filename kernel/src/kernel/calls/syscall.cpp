@@ -22,6 +22,7 @@
 #include "kernel/calls/syscall.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/tasking/tasking.hpp"
+#include "kernel/system/processor/processor.hpp"
 #include "kernel/kernel.hpp"
 
 #include "kernel/calls/syscall_general.hpp"
@@ -30,9 +31,21 @@
 #include "kernel/calls/syscall_filesystem.hpp"
 #include "kernel/calls/syscall_vm86.hpp"
 #include "kernel/calls/syscall_messaging.hpp"
+#include "kernel/calls/syscall_async.hpp"
 
 static g_syscall_registration* syscallRegistrations = 0;
 
+static void syscallRecordLatency(g_syscall_registration* reg, uint64_t start)
+{
+	uint64_t cycles = processorReadTimestamp() - start;
+
+	int bucket = 0;
+	while(bucket < G_KERNQUERY_SYSCALL_LATENCY_BUCKETS - 1 && (cycles >> (bucket + 1)) > 0)
+		++bucket;
+
+	__sync_fetch_and_add(&reg->statistics.latency[bucket], 1);
+}
+
 void syscallHandle(g_task* task)
 {
 	uint32_t callId = task->state->eax;
@@ -54,11 +67,26 @@ void syscallHandle(g_task* task)
 	// Store call information
 	task->syscall.handler = reg->handler;
 	task->syscall.data = syscallData;
+	task->syscall.call = callId;
+	task->syscall.start = processorReadTimestamp();
 
 	if(reg->threaded)
+	{
+		if(reg->inlineHandler && reg->inlineHandler(task, syscallData))
+		{
+			__sync_fetch_and_add(&reg->statistics.inlined, 1);
+			syscallRecordLatency(reg, task->syscall.start);
+			return;
+		}
+
+		__sync_fetch_and_add(&reg->statistics.threaded, 1);
 		syscallRunThreaded(reg->handler, task, syscallData);
-	else
+	} else
+	{
 		reg->handler(task, syscallData);
+		__sync_fetch_and_add(&reg->statistics.inlined, 1);
+		syscallRecordLatency(reg, task->syscall.start);
+	}
 }
 
 void syscallRunThreaded(g_syscall_handler handler, g_task* caller, void* syscallData)
@@ -98,6 +126,7 @@ void syscallThreadEntry()
 
 	// Call handler
 	sourceTask->syscall.handler(sourceTask, sourceTask->syscall.data);
+	syscallRecordLatency(&syscallRegistrations[sourceTask->syscall.call], sourceTask->syscall.start);
 
 	// Switch back to source task
 	mutexAcquire(&local->lock);
@@ -109,25 +138,90 @@ void syscallThreadEntry()
 	taskingKernelThreadYield();
 }
 
-void syscallRegister(int callId, g_syscall_handler handler, bool threaded)
+void syscallBatch(g_task* task, g_syscall_batch* data)
+{
+	data->executed = 0;
+	for(uint32_t i = 0; i < data->count; i++)
+		data->entries[i].executed = false;
+
+	for(uint32_t i = 0; i < data->count; i++)
+	{
+		g_syscall_batch_entry* entry = &data->entries[i];
+
+		// Entries run in order, so the batch stops at the first one that can't run
+		if(entry->call >= G_SYSCALL_MAX)
+			break;
+
+		g_syscall_registration* reg = &syscallRegistrations[entry->call];
+		if(reg->handler == 0 || !reg->batchable)
+			break;
+
+		// Wait resolvers work on the data of the call that made the task wait
+		task->syscall.handler = reg->handler;
+		task->syscall.data = entry->data;
+		if(reg->threaded)
+		{
+			// Threaded calls are only batched if they can be handled inline
+			if(!reg->inlineHandler || !reg->inlineHandler(task, entry->data))
+				break;
+		} else
+		{
+			reg->handler(task, entry->data);
+		}
+
+		entry->executed = true;
+		data->executed++;
+
+		if(task->status != G_THREAD_STATUS_RUNNING)
+			break;
+	}
+}
+
+g_syscall_registration* syscallGetRegistration(uint32_t call)
+{
+	if(call >= G_SYSCALL_MAX || syscallRegistrations[call].handler == 0)
+		return 0;
+	return &syscallRegistrations[call];
+}
+
+void syscallRegister(int callId, g_syscall_handler handler, bool threaded, bool batchable)
 {
 	if(callId > G_SYSCALL_MAX)
 	{
 		kernelPanic("%! tried to register syscall with id %i, maximum is %i", "syscall", callId, G_SYSCALL_MAX);
 	}
-
 	syscallRegistrations[callId].handler = handler;
 	syscallRegistrations[callId].threaded = threaded;
+	syscallRegistrations[callId].batchable = batchable;
 }
 
-void syscallRegisterAll()
+void syscallRegisterInline(int callId, g_syscall_inline_handler inlineHandler)
 {
-	syscallRegistrations = (g_syscall_registration*) heapAllocate(sizeof(g_syscall_registration) * G_SYSCALL_MAX);
-	for(int i = 0; i < G_SYSCALL_MAX; i++)
+	if(callId > G_SYSCALL_MAX || !syscallRegistrations[callId].threaded)
 	{
-		syscallRegistrations[i].handler = 0;
+		kernelPanic("%! tried to register inline handler for syscall %i that is not threaded", "syscall", callId);
 	}
 
+	syscallRegistrations[callId].inlineHandler = inlineHandler;
+}
+
+bool syscallQueryStatistics(uint32_t call, g_kernquery_syscall_statistics_data* out)
+{
+	g_syscall_registration* reg = syscallGetRegistration(call);
+	if(!reg)
+		return false;
+
+	out->inlined = reg->statistics.inlined;
+	out->threaded = reg->statistics.threaded;
+	for(int i = 0; i < G_KERNQUERY_SYSCALL_LATENCY_BUCKETS; i++)
+		out->latency[i] = reg->statistics.latency[i];
+	return true;
+}
+
+void syscallRegisterAll()
+{
+	syscallRegistrations = (g_syscall_registration*) heapAllocateClear(sizeof(g_syscall_registration) * G_SYSCALL_MAX);
+
 	syscallRegister(G_SYSCALL_EXIT, (g_syscall_handler) syscallExit, false);
 	syscallRegister(G_SYSCALL_YIELD, (g_syscall_handler) syscallYield, false);
 	syscallRegister(G_SYSCALL_GET_PROCESS_ID, (g_syscall_handler) syscallGetProcessId, false);
@@ -137,7 +231,7 @@ void syscallRegisterAll()
 	syscallRegister(G_SYSCALL_JOIN, (g_syscall_handler) syscallJoin, false);
 	syscallRegister(G_SYSCALL_SLEEP, (g_syscall_handler) syscallSleep, false);
 	syscallRegister(G_SYSCALL_ATOMIC_LOCK, (g_syscall_handler) syscallAtomicLock, false);
-	syscallRegister(G_SYSCALL_LOG, (g_syscall_handler) syscallLog, false);
+	syscallRegister(G_SYSCALL_LOG, (g_syscall_handler) syscallLog, false, true);
 	syscallRegister(G_SYSCALL_SET_VIDEO_LOG, (g_syscall_handler) syscallSetVideoLog, false);
 	syscallRegister(G_SYSCALL_TEST, (g_syscall_handler) syscallTest, false);
 	syscallRegister(G_SYSCALL_RELEASE_CLI_ARGUMENTS, (g_syscall_handler) syscallReleaseCliArguments, false);
@@ -153,6 +247,10 @@ void syscallRegisterAll()
 	syscallRegister(G_SYSCALL_GET_PARENT_PROCESS_ID, (g_syscall_handler) syscallGetParentProcessId, false);
 	syscallRegister(G_SYSCALL_TASK_GET_TLS, (g_syscall_handler) syscallTaskGetTls, false);
 	syscallRegister(G_SYSCALL_PROCESS_GET_INFO, (g_syscall_handler) syscallProcessGetInfo, false);
+	syscallRegister(G_SYSCALL_BATCH, (g_syscall_handler) syscallBatch, false);
+	syscallRegister(G_SYSCALL_ASYNC_SETUP, (g_syscall_handler) syscallAsyncSetup, false);
+	syscallRegister(G_SYSCALL_ASYNC_SUBMIT, (g_syscall_handler) syscallAsyncSubmit, false, true);
+	syscallRegister(G_SYSCALL_ASYNC_WAIT, (g_syscall_handler) syscallAsyncWait, false);
 
 	syscallRegister(G_SYSCALL_CALL_VM86, (g_syscall_handler) syscallCallVm86, false);
 	syscallRegister(G_SYSCALL_LOWER_MEMORY_ALLOCATE, (g_syscall_handler) syscallLowerMemoryAllocate, false);
@@ -169,8 +267,8 @@ void syscallRegisterAll()
 	
 	syscallRegister(G_SYSCALL_REGISTER_TASK_IDENTIFIER, (g_syscall_handler) syscallRegisterTaskIdentifier, false);
 	syscallRegister(G_SYSCALL_GET_TASK_FOR_IDENTIFIER, (g_syscall_handler) syscallGetTaskForIdentifier, false);
-	syscallRegister(G_SYSCALL_MESSAGE_SEND, (g_syscall_handler) syscallMessageSend, false);
-	syscallRegister(G_SYSCALL_MESSAGE_RECEIVE, (g_syscall_handler) syscallMessageReceive, false);
+	syscallRegister(G_SYSCALL_MESSAGE_SEND, (g_syscall_handler) syscallMessageSend, false, true);
+	syscallRegister(G_SYSCALL_MESSAGE_RECEIVE, (g_syscall_handler) syscallMessageReceive, false, true);
 
 	syscallRegister(G_SYSCALL_GET_MILLISECONDS, (g_syscall_handler) syscallGetMilliseconds, false);
 
@@ -178,12 +276,28 @@ void syscallRegisterAll()
 	syscallRegister(G_SYSCALL_FS_SEEK, (g_syscall_handler) syscallFsSeek, true);
 	syscallRegister(G_SYSCALL_FS_READ, (g_syscall_handler) syscallFsRead, true);
 	syscallRegister(G_SYSCALL_FS_WRITE, (g_syscall_handler) syscallFsWrite, true);
-	syscallRegister(G_SYSCALL_FS_CLOSE, (g_syscall_handler) syscallFsClose, false);
-	syscallRegister(G_SYSCALL_FS_CLONEFD, (g_syscall_handler) syscallFsCloneFd, false);
+	syscallRegister(G_SYSCALL_FS_CLOSE, (g_syscall_handler) syscallFsClose, true, true);
+	syscallRegister(G_SYSCALL_FS_CLONEFD, (g_syscall_handler) syscallFsCloneFd, false, true);
 	syscallRegister(G_SYSCALL_FS_LENGTH, (g_syscall_handler) syscallFsLength, true);
-	syscallRegister(G_SYSCALL_FS_TELL, (g_syscall_handler) syscallFsTell, false);
+	syscallRegister(G_SYSCALL_FS_TELL, (g_syscall_handler) syscallFsTell, false, true);
 	syscallRegister(G_SYSCALL_FS_STAT, (g_syscall_handler) syscallFsStat, true);
 	syscallRegister(G_SYSCALL_FS_FSTAT, (g_syscall_handler) syscallFsFstat, true);
 	syscallRegister(G_SYSCALL_FS_PIPE, (g_syscall_handler) syscallFsPipe, true);
+	syscallRegister(G_SYSCALL_FS_READV, (g_syscall_handler) syscallFsReadv, true);
+	syscallRegister(G_SYSCALL_FS_WRITEV, (g_syscall_handler) syscallFsWritev, true);
+	syscallRegister(G_SYSCALL_FS_UNLINK, (g_syscall_handler) syscallFsUnlink, true);
+	syscallRegister(G_SYSCALL_FS_FLUSH, (g_syscall_handler) syscallFsFlush, true);
+	syscallRegister(G_SYSCALL_FS_POLL, (g_syscall_handler) syscallFsPoll, true);
+	syscallRegister(G_SYSCALL_FS_OPEN_DIRECTORY, (g_syscall_handler) syscallFsOpenDirectory, true);
+	syscallRegister(G_SYSCALL_FS_READ_DIRECTORY, (g_syscall_handler) syscallFsReadDirectory, true);
+	syscallRegister(G_SYSCALL_FS_REGISTER_AS_DELEGATE, (g_syscall_handler) syscallFsRegisterAsDelegate, false);
+	syscallRegister(G_SYSCALL_FS_CREATE_NODE, (g_syscall_handler) syscallFsCreateNode, false);
+
+	syscallRegisterInline(G_SYSCALL_FS_SEEK, (g_syscall_inline_handler) syscallFsSeekInline);
+	syscallRegisterInline(G_SYSCALL_FS_READ, (g_syscall_inline_handler) syscallFsReadInline);
+	syscallRegisterInline(G_SYSCALL_FS_WRITE, (g_syscall_inline_handler) syscallFsWriteInline);
+	syscallRegisterInline(G_SYSCALL_FS_LENGTH, (g_syscall_inline_handler) syscallFsLengthInline);
+	syscallRegisterInline(G_SYSCALL_FS_CLOSE, (g_syscall_inline_handler) syscallFsCloseInline);
+	syscallRegisterInline(G_SYSCALL_FS_POLL, (g_syscall_inline_handler) syscallFsPollInline);
 }
 
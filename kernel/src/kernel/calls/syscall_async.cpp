@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/calls/syscall_async.hpp"
+#include "kernel/tasking/async.hpp"
+#include "kernel/tasking/wait.hpp"
+
+void syscallAsyncSetup(g_task* task, g_syscall_async_setup* data)
+{
+	data->status = asyncSetup(task, data->ring, data->entries);
+}
+
+void syscallAsyncSubmit(g_task* task, g_syscall_async_submit* data)
+{
+	data->submitted = asyncSubmit(task);
+}
+
+void syscallAsyncWait(g_task* task, g_syscall_async_wait* data)
+{
+	data->available = asyncAvailableCompletions(task->process);
+	if(!task->process->async)
+		return;
+
+	// more completions than the ring holds can never become available
+	uint32_t minimum = data->minimum;
+	uint32_t entries = task->process->async->ring->entries;
+	if(minimum > entries)
+		minimum = entries;
+
+	if(data->available < minimum)
+	{
+		waitForAsyncCompletion(task, minimum);
+		taskingSchedule();
+	}
+}
@@ -1,157 +1,309 @@
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- *                                                                           *
- *  Ghost, a micro-kernel based operating system for the x86 architecture    *
- *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
- *                                                                           *
- *  This program is free software: you can redistribute it and/or modify     *
- *  it under the terms of the GNU General Public License as published by     *
- *  the Free Software Foundation, either version 3 of the License, or        *
- *  (at your option) any later version.                                      *
- *                                                                           *
- *  This program is distributed in the hope that it will be useful,          *
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
- *  GNU General Public License for more details.                             *
- *                                                                           *
- *  You should have received a copy of the GNU General Public License        *
- *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
- *                                                                           *
- * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-
-#include "kernel/calls/syscall_filesystem.hpp"
-#include "kernel/filesystem/filesystem.hpp"
-#include "kernel/filesystem/filesystem_process.hpp"
-#include "shared/logger/logger.hpp"
-
-void syscallFsOpen(g_task* task, g_syscall_fs_open* data)
-{
-	g_fd fd;
-	data->status = filesystemOpen(data->path, data->flags, task, &fd);
-	if(data->status == G_FS_OPEN_SUCCESSFUL)
-	{
-		data->fd = fd;
-	} else
-	{
-		data->fd = G_FD_NONE;
-	}
-}
-
-void syscallFsSeek(g_task* task, g_syscall_fs_seek* data)
-{
-	data->status = filesystemSeek(task, data->fd, data->mode, data->amount, &data->result);
-}
-
-void syscallFsRead(g_task* task, g_syscall_fs_read* data)
-{
-	data->status = filesystemRead(task, data->fd, data->buffer, data->length, &data->result);
-	if(data->status != G_FS_READ_SUCCESSFUL)
-	{
-		data->result = G_FD_NONE;
-	}
-}
-
-void syscallFsWrite(g_task* task, g_syscall_fs_write* data)
-{
-	data->status = filesystemWrite(task, data->fd, data->buffer, data->length, &data->result);
-	if(data->status != G_FS_WRITE_SUCCESSFUL)
-	{
-		data->result = G_FD_NONE;
-	}
-}
-
-void syscallFsClose(g_task* task, g_syscall_fs_close* data)
-{
-	data->status = filesystemClose(task->process->id, data->fd, true);
-}
-
-void syscallFsLength(g_task* task, g_syscall_fs_length* data)
-{
-	uint64_t length;
-	data->status = filesystemGetLength(task, data->fd, &length);
-	data->length = length;
-}
-
-void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data)
-{
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(data->source_pid, data->source_fd);
-	if(!descriptor)
-	{
-		data->status = G_FS_CLONEFD_INVALID_SOURCE_FD;
-		data->result = G_FD_NONE;
-		return;
-	}
-
-	g_file_descriptor* clone = filesystemProcessCloneDescriptor(descriptor, data->target_pid, data->target_fd);
-	if(!clone)
-	{
-		data->result = G_FD_NONE;
-		data->status = G_FS_CLONEFD_ERROR;
-		return;
-	}
-
-	data->result = clone->id;
-	data->status = G_FS_CLONEFD_SUCCESSFUL;
-}
-
-void syscallFsTell(g_task* task, g_syscall_fs_tell* data)
-{
-
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, data->fd);
-	if(!descriptor)
-	{
-		data->status = G_FS_TELL_INVALID_FD;
-		data->result = G_FD_NONE;
-		return;
-	}
-
-	data->result = descriptor->offset;
-	data->status = G_FS_TELL_SUCCESSFUL;
-}
-
-void syscallFsStat(g_task* task, g_syscall_fs_stat* data)
-{
-	logInfo("%! stat not implemented", "syscall");
-}
-
-void syscallFsFstat(g_task* task, g_syscall_fs_fstat* data)
-{
-	logInfo("%! fstat not implemented", "syscall");
-}
-
-void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
-{
-	g_fs_node* pipeNode;
-	data->status = filesystemCreatePipe(data->blocking, &pipeNode);
-
-	if(data->status != G_FS_PIPE_SUCCESSFUL)
-	{
-		logInfo("%! failed to create pipe for task %i with status %i", "filesystem", task->id, data->status);
-		data->read_fd = G_FD_NONE;
-		data->write_fd = G_FD_NONE;
-		return;
-	}
-
-	g_file_flag_mode writeFlags = (G_FILE_FLAG_MODE_WRITE | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
-	g_fs_open_status writeOpen = filesystemOpen(pipeNode, writeFlags, task, &data->write_fd);
-	if(writeOpen != G_FS_OPEN_SUCCESSFUL)
-	{
-		logInfo("%! failed to open write end of pipe %i for task %i with status %i", "filesystem", pipeNode->id, task->id, writeOpen);
-		data->status = G_FS_PIPE_ERROR;
-		return;
-	}
-
-	g_file_flag_mode readFlags = (G_FILE_FLAG_MODE_READ | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
-	g_fs_open_status readOpen = filesystemOpen(pipeNode, readFlags, task, &data->read_fd);
-	if(readOpen != G_FS_OPEN_SUCCESSFUL)
-	{
-		if(filesystemClose(task->process->id, writeOpen, true) != G_FS_CLOSE_SUCCESSFUL)
-		{
-			logInfo("%! failed to close write end of pipe %i for task %i after failing to open read end", "filesystem", pipeNode->id, task->id);
-		}
-		logInfo("%! failed to open read end of pipe %i for task %i with status %i", "filesystem", pipeNode->id, task->id, readOpen);
-		data->status = G_FS_PIPE_ERROR;
-		return;
-	}
-
-	data->status = G_FS_PIPE_SUCCESSFUL;
-}
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/calls/syscall_filesystem.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
+#include "kernel/ipc/poll.hpp"
+#include "shared/logger/logger.hpp"
+
+void syscallFsOpen(g_task* task, g_syscall_fs_open* data)
+{
+	g_fd fd;
+	data->status = filesystemOpen(data->path, data->flags, task, &fd);
+	if(data->status == G_FS_OPEN_SUCCESSFUL)
+	{
+		data->fd = fd;
+	} else
+	{
+		data->fd = G_FD_NONE;
+	}
+}
+
+void syscallFsSeek(g_task* task, g_syscall_fs_seek* data)
+{
+	data->status = filesystemSeek(task, data->fd, data->mode, data->amount, &data->result);
+}
+
+bool syscallFsSeekInline(g_task* task, g_syscall_fs_seek* data)
+{
+	if(filesystemNeedsThread(task, data->fd))
+		return false;
+
+	syscallFsSeek(task, data);
+	return true;
+}
+
+bool syscallFsReadInline(g_task* task, g_syscall_fs_read* data)
+{
+	if(data->length > G_SYSCALL_INLINE_MAXIMUM_TRANSFER)
+		return false;
+
+	if(!filesystemTryRead(task, data->fd, data->buffer, data->length, &data->status, &data->result))
+		return false;
+
+	if(data->status != G_FS_READ_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+	return true;
+}
+
+void syscallFsRead(g_task* task, g_syscall_fs_read* data)
+{
+	data->status = filesystemRead(task, data->fd, data->buffer, data->length, &data->result);
+	if(data->status != G_FS_READ_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+bool syscallFsWriteInline(g_task* task, g_syscall_fs_write* data)
+{
+	if(data->length > G_SYSCALL_INLINE_MAXIMUM_TRANSFER)
+		return false;
+
+	if(!filesystemTryWrite(task, data->fd, data->buffer, data->length, &data->status, &data->result))
+		return false;
+
+	if(data->status != G_FS_WRITE_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+	return true;
+}
+
+void syscallFsWrite(g_task* task, g_syscall_fs_write* data)
+{
+	data->status = filesystemWrite(task, data->fd, data->buffer, data->length, &data->result);
+	if(data->status != G_FS_WRITE_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsReadv(g_task* task, g_syscall_fs_readv* data)
+{
+	data->status = filesystemReadVector(task, data->fd, data->vector, data->count, &data->result);
+	if(data->status != G_FS_READ_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsWritev(g_task* task, g_syscall_fs_writev* data)
+{
+	data->status = filesystemWriteVector(task, data->fd, data->vector, data->count, &data->result);
+	if(data->status != G_FS_WRITE_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsClose(g_task* task, g_syscall_fs_close* data)
+{
+	data->status = filesystemClose(task->process, data->fd, true);
+}
+
+bool syscallFsCloseInline(g_task* task, g_syscall_fs_close* data)
+{
+	if(filesystemNeedsThread(task, data->fd))
+		return false;
+
+	syscallFsClose(task, data);
+	return true;
+}
+
+void syscallFsUnlink(g_task* task, g_syscall_fs_unlink* data)
+{
+	g_fs_node* file;
+	g_fs_open_status findStatus = filesystemFind(filesystemGetPathOrigin(task, data->path), data->path, &file);
+	if(findStatus == G_FS_OPEN_NOT_FOUND)
+	{
+		data->status = G_FS_UNLINK_NOT_FOUND;
+		return;
+	}
+	if(findStatus != G_FS_OPEN_SUCCESSFUL)
+	{
+		data->status = G_FS_UNLINK_ERROR;
+		return;
+	}
+
+	data->status = filesystemUnlink(file);
+}
+
+void syscallFsFlush(g_task* task, g_syscall_fs_flush* data)
+{
+	data->status = filesystemFlush(task, data->fd);
+}
+
+void syscallFsPoll(g_task* task, g_syscall_fs_poll* data)
+{
+	pollWait(task, data);
+}
+
+bool syscallFsPollInline(g_task* task, g_syscall_fs_poll* data)
+{
+	// outside of a syscall thread this only checks once without waiting
+	pollWait(task, data);
+	return data->result > 0 || data->timeout == 0;
+}
+
+void syscallFsOpenDirectory(g_task* task, g_syscall_fs_open_directory* data)
+{
+	data->status = filesystemOpenDirectory(task, data->path, &data->iterator->node_id);
+}
+
+void syscallFsReadDirectory(g_task* task, g_syscall_fs_read_directory* data)
+{
+	uint64_t cursor = data->cursor;
+	data->status = filesystemReadDirectory(data->node_id, &cursor, data->buffer, data->length, &data->result);
+	data->cursor = cursor;
+}
+
+void syscallFsLength(g_task* task, g_syscall_fs_length* data)
+{
+	uint64_t length;
+	data->status = filesystemGetLength(task, data->fd, &length);
+	data->length = length;
+}
+
+bool syscallFsLengthInline(g_task* task, g_syscall_fs_length* data)
+{
+	if(filesystemNeedsThread(task, data->fd))
+		return false;
+
+	syscallFsLength(task, data);
+	return true;
+}
+
+void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data)
+{
+	g_task* sourceTask = taskingGetById(data->source_pid);
+	g_file_descriptor* descriptor = sourceTask ? filesystemProcessGetDescriptor(sourceTask->process, data->source_fd) : 0;
+	if(!descriptor)
+	{
+		data->status = G_FS_CLONEFD_INVALID_SOURCE_FD;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	g_task* targetTask = taskingGetById(data->target_pid);
+	g_file_descriptor* clone = targetTask ? filesystemCloneDescriptor(descriptor, targetTask->process, data->target_fd) : 0;
+	if(!clone)
+	{
+		data->result = G_FD_NONE;
+		data->status = G_FS_CLONEFD_ERROR;
+		return;
+	}
+
+	data->result = clone->id;
+	data->status = G_FS_CLONEFD_SUCCESSFUL;
+}
+
+void syscallFsTell(g_task* task, g_syscall_fs_tell* data)
+{
+
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, data->fd);
+	if(!descriptor)
+	{
+		data->status = G_FS_TELL_INVALID_FD;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	data->result = descriptor->offset;
+	data->status = G_FS_TELL_SUCCESSFUL;
+}
+
+void syscallFsStat(g_task* task, g_syscall_fs_stat* data)
+{
+	logInfo("%! stat not implemented", "syscall");
+}
+
+void syscallFsFstat(g_task* task, g_syscall_fs_fstat* data)
+{
+	logInfo("%! fstat not implemented", "syscall");
+}
+
+void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
+{
+	g_fs_node* pipeNode;
+	data->status = filesystemCreatePipe(data->blocking, &pipeNode);
+
+	if(data->status != G_FS_PIPE_SUCCESSFUL)
+	{
+		logInfo("%! failed to create pipe for task %i with status %i", "filesystem", task->id, data->status);
+		data->read_fd = G_FD_NONE;
+		data->write_fd = G_FD_NONE;
+		return;
+	}
+
+	g_file_flag_mode writeFlags = (G_FILE_FLAG_MODE_WRITE | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
+	g_fs_open_status writeOpen = filesystemOpen(pipeNode, writeFlags, task, &data->write_fd);
+	if(writeOpen != G_FS_OPEN_SUCCESSFUL)
+	{
+		logInfo("%! failed to open write end of pipe %i for task %i with status %i", "filesystem", pipeNode->id, task->id, writeOpen);
+		data->status = G_FS_PIPE_ERROR;
+		return;
+	}
+
+	g_file_flag_mode readFlags = (G_FILE_FLAG_MODE_READ | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
+	g_fs_open_status readOpen = filesystemOpen(pipeNode, readFlags, task, &data->read_fd);
+	if(readOpen != G_FS_OPEN_SUCCESSFUL)
+	{
+		if(filesystemClose(task->process, data->write_fd, true) != G_FS_CLOSE_SUCCESSFUL)
+		{
+			logInfo("%! failed to close write end of pipe %i for task %i after failing to open read end", "filesystem", pipeNode->id, task->id);
+		}
+		logInfo("%! failed to open read end of pipe %i for task %i with status %i", "filesystem", pipeNode->id, task->id, readOpen);
+		data->status = G_FS_PIPE_ERROR;
+		return;
+	}
+
+	data->status = G_FS_PIPE_SUCCESSFUL;
+}
+
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data)
+{
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->result = G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+		return;
+	}
+
+	data->result = filesystemTaskedDelegateRegister(task, data->name, data->phys_mountpoint_id, &data->mountpoint_id, &data->ring);
+	if(data->result != G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		logInfo("%! task %i failed to register as delegate '%s' with status %i", "filesystem", task->id, data->name, data->result);
+	}
+}
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data)
+{
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->result = G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+		return;
+	}
+
+	data->result = filesystemTaskedDelegateCreateNode(task, data->parent_id, data->name, data->type, data->phys_fs_id, &data->created_id);
+}
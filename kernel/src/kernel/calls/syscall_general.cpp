@@ -20,6 +20,7 @@
 
 #include "kernel/calls/syscall_general.hpp"
 #include "kernel/tasking/wait.hpp"
+#include "kernel/ipc/message.hpp"
 
 #include "kernel/memory/heap.hpp"
 #include "shared/logger/logger.hpp"
@@ -133,6 +134,7 @@ void syscallSetWorkingDirectory(g_task* task, g_syscall_fs_set_working_directory
 			int length = filesystemGetAbsolutePathLength(child);
 			task->process->environment.workingDirectory = (char*) heapAllocate(length + 1);
 			filesystemGetAbsolutePath(child, task->process->environment.workingDirectory);
+			task->process->environment.workingDirectoryNode = child;
 			data->result = G_SET_WORKING_DIRECTORY_SUCCESSFUL;
 		} else
 		{
@@ -149,9 +151,21 @@ void syscallSetWorkingDirectory(g_task* task, g_syscall_fs_set_working_directory
 	}
 }
 
-void syscallKernQuery(g_task* task, g_syscall_fs_set_working_directory* data)
+void syscallKernQuery(g_task* task, g_syscall_kernquery* data)
 {
-	logInfo("syscall not implemented: syscallKernQuery");
-	for(;;)
-		;
+	if(data->command == G_KERNQUERY_MESSAGE_QUEUE_GET_BY_ID)
+	{
+		g_kernquery_message_queue_get_data* query = (g_kernquery_message_queue_get_data*) data->buffer;
+		query->found = messageQueryQueue(query->id, query);
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	} else if(data->command == G_KERNQUERY_SYSCALL_GET_STATISTICS)
+	{
+		g_kernquery_syscall_statistics_data* query = (g_kernquery_syscall_statistics_data*) data->buffer;
+		query->found = syscallQueryStatistics(query->call, query);
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	} else
+	{
+		logInfo("%! task %i used unknown query %h", "kernquery", task->id, data->command);
+		data->status = G_KERNQUERY_STATUS_UNKNOWN_ID;
+	}
 }
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "kernel/memory/lower_heap.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
+#include "kernel/system/processor/processor.hpp"
 
 #include "shared/logger/logger.hpp"
 
@@ -149,13 +150,14 @@ void syscallShareMemory(g_task* task, g_syscall_share_mem* data)
 		return;
 	}
 
-	/* Map required pages */
+	/* Map required pages, keeping the caching attributes (like for shared framebuffers) */
 	for (uint32_t i = 0; i < pages; i++) {
 		g_physical_address physicalAddr = pagingVirtualToPhysical(memory + i * G_PAGE_SIZE);
+		uint32_t cacheFlags = pagingGetPageFlags(memory + i * G_PAGE_SIZE) & G_PAGE_CACHE_ATTRIBUTE_MASK;
 
 		/* Switch into target space to map */
 		g_physical_address back = taskingTemporarySwitchToSpace(targetProcess->pageDirectory);
-		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, physicalAddr, DEFAULT_USER_TABLE_FLAGS, DEFAULT_USER_PAGE_FLAGS);
+		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, physicalAddr, DEFAULT_USER_TABLE_FLAGS, DEFAULT_USER_PAGE_FLAGS | cacheFlags);
 		taskingTemporarySwitchBack(back);
 
 		pageReferenceTrackerIncrement(physicalAddr);
@@ -179,10 +181,19 @@ void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data)
 		return;
 	}
 
+	uint32_t pageFlags = DEFAULT_USER_PAGE_FLAGS;
+	if(data->flags & G_MMIO_FLAG_WRITE_COMBINING)
+	{
+		if(processorSupportsWriteCombining())
+			pageFlags |= G_PAGE_WRITE_COMBINING_FLAGS;
+		else
+			logDebug("%! task %i requested write-combining mmio mapping, not supported", "syscall", task->id);
+	}
+
 	/* Map to physical memory */
 	for(uint32_t i = 0; i < pages; i++)
 	{
-		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, data->physicalAddress + i * G_PAGE_SIZE, DEFAULT_USER_TABLE_FLAGS, DEFAULT_USER_PAGE_FLAGS);
+		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, data->physicalAddress + i * G_PAGE_SIZE, DEFAULT_USER_TABLE_FLAGS, pageFlags);
 	}
 
 	data->virtualAddress = (void*) virtualRangeBase;
@@ -36,7 +36,7 @@ void syscallGetTaskForIdentifier(g_task* task, g_syscall_task_id_get* data)
 
 void syscallMessageSend(g_task* task, g_syscall_send_message* data)
 {
-	data->status = messageSend(task->id, data->receiver, data->buffer, data->length, data->transaction);
+	data->status = messageSend(task->id, data->receiver, data->buffer, data->length, data->transaction, data->mode);
 
 	if(data->mode == G_MESSAGE_SEND_MODE_BLOCKING && data->status == G_MESSAGE_SEND_STATUS_QUEUE_FULL)
 	{
@@ -19,18 +19,39 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_cache.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
 #include "kernel/filesystem/filesystem_ramdiskdelegate.hpp"
 #include "kernel/filesystem/filesystem_pipedelegate.hpp"
+#include "kernel/filesystem/filesystem_tmpdelegate.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/tasking/tasking.hpp"
 #include "kernel/tasking/wait.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/ipc/pipes.hpp"
 #include "kernel/kernel.hpp"
+#include "kernel/utils/hashmap.hpp"
 
 #include "shared/system/mutex.hpp"
 #include "shared/utils/string.hpp"
 
+/**
+ * Key of the dentry cache. The name is only copied when an entry is stored.
+ */
+struct g_fs_dentry_key
+{
+	g_fs_virt_id parent;
+	const char* name;
+};
+
+/**
+ * Value of negative entries in the dentry cache. The number of negative entries
+ * is limited, misses beyond that are simply not remembered.
+ */
+#define G_FS_DENTRY_NEGATIVE		((g_fs_node*) -1)
+#define G_FS_DENTRY_NEGATIVE_MAX	4096
+#define G_FS_DENTRY_BUCKETS			4096
+
 static g_fs_node* filesystemRoot;
 static g_fs_node* mountFolder;
 static g_fs_node* pipesFolder;
@@ -40,6 +61,35 @@ static g_mutex filesystemNextNodeIdLock;
 
 static g_hashmap<g_fs_virt_id, g_fs_node*>* filesystemNodes;
 
+static g_hashmap<g_fs_dentry_key, g_fs_node*>* filesystemDentries;
+static uint32_t filesystemDentriesNegative;
+
+static g_fs_dentry_key filesystemDentryKeyCopy(g_fs_dentry_key key)
+{
+	g_fs_dentry_key copy;
+	copy.parent = key.parent;
+	copy.name = stringDuplicate(key.name);
+	return copy;
+}
+
+static int filesystemDentryKeyHash(g_fs_dentry_key key)
+{
+	int hash = stringHash(key.name) * 31 + key.parent;
+	if(hash < 0)
+		hash = -hash;
+	return hash;
+}
+
+static void filesystemDentryKeyFree(g_fs_dentry_key key)
+{
+	heapFree((void*) key.name);
+}
+
+static bool filesystemDentryKeyEquals(g_fs_dentry_key k1, g_fs_dentry_key k2)
+{
+	return k1.parent == k2.parent && stringEquals(k1.name, k2.name);
+}
+
 void filesystemInitialize()
 {
 	mutexInitialize(&filesystemNextNodeIdLock);
@@ -47,7 +97,15 @@ void filesystemInitialize()
 
 	filesystemNodes = hashmapCreateNumeric<g_fs_virt_id, g_fs_node*>(1024);
 
-	filesystemProcessInitialize();
+	filesystemDentries = hashmapInternalCreate<g_fs_dentry_key, g_fs_node*>(G_FS_DENTRY_BUCKETS);
+	filesystemDentries->keyCopy = filesystemDentryKeyCopy;
+	filesystemDentries->keyHash = filesystemDentryKeyHash;
+	filesystemDentries->keyFree = filesystemDentryKeyFree;
+	filesystemDentries->keyEquals = filesystemDentryKeyEquals;
+	filesystemDentriesNegative = 0;
+
+	filesystemCacheInitialize();
+	filesystemTaskedDelegateInitialize();
 	filesystemCreateRoot();
 }
 
@@ -55,6 +113,7 @@ void filesystemCreateRoot()
 {
 	// Mount ramdisk
 	g_fs_delegate* ramdiskDelegate = filesystemCreateDelegate();
+	ramdiskDelegate->cacheMisses = true;
 	ramdiskDelegate->open = filesystemRamdiskDelegateOpen;
 	ramdiskDelegate->discover = filesystemRamdiskDelegateDiscover;
 	ramdiskDelegate->read = filesystemRamdiskDelegateRead;
@@ -63,6 +122,7 @@ void filesystemCreateRoot()
 	ramdiskDelegate->create = filesystemRamdiskDelegateCreate;
 	ramdiskDelegate->getLength = filesystemRamdiskDelegateGetLength;
 	ramdiskDelegate->close = filesystemRamdiskDelegateClose;
+	ramdiskDelegate->refreshDirectory = filesystemRamdiskDelegateRefreshDirectory;
 
 	filesystemRoot = filesystemCreateNode(G_FS_NODE_TYPE_ROOT, "root");
 	filesystemRoot->delegate = ramdiskDelegate;
@@ -84,11 +144,31 @@ void filesystemCreateRoot()
 	pipeDelegate->getLength = filesystemPipeDelegateGetLength;
 	pipeDelegate->waitResolverRead = filesystemPipeDelegateWaitResolverRead;
 	pipeDelegate->waitResolverWrite = filesystemPipeDelegateWaitResolverWrite;
+	pipeDelegate->poll = filesystemPipeDelegatePoll;
+	pipeDelegate->unpoll = filesystemPipeDelegateUnpoll;
 	pipeDelegate->close = filesystemPipeDelegateClose;
 
 	pipesFolder = filesystemCreateNode(G_FS_NODE_TYPE_FOLDER, "pipes");
 	pipesFolder->delegate = pipeDelegate;
 	filesystemAddChild(mountFolder, pipesFolder);
+
+	// Mount tmpfs
+	filesystemTmpDelegateInitialize();
+	g_fs_delegate* tmpDelegate = filesystemCreateDelegate();
+	tmpDelegate->cacheMisses = true;
+	tmpDelegate->open = filesystemTmpDelegateOpen;
+	tmpDelegate->discover = filesystemTmpDelegateDiscover;
+	tmpDelegate->read = filesystemTmpDelegateRead;
+	tmpDelegate->write = filesystemTmpDelegateWrite;
+	tmpDelegate->truncate = filesystemTmpDelegateTruncate;
+	tmpDelegate->create = filesystemTmpDelegateCreate;
+	tmpDelegate->getLength = filesystemTmpDelegateGetLength;
+	tmpDelegate->close = filesystemTmpDelegateClose;
+	tmpDelegate->unlink = filesystemTmpDelegateUnlink;
+
+	g_fs_node* tmpFolder = filesystemCreateNode(G_FS_NODE_TYPE_FOLDER, "tmp");
+	tmpFolder->delegate = tmpDelegate;
+	filesystemAddChild(mountFolder, tmpFolder);
 }
 
 g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name)
@@ -99,6 +179,8 @@ g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name)
 	node->name = stringDuplicate(name);
 	node->parent = 0;
 	node->children = 0;
+	node->childrenTail = 0;
+	node->parentEntry = 0;
 	node->delegate = 0;
 	node->blocking = false;
 	node->upToDate = false;
@@ -116,12 +198,42 @@ void filesystemAddChild(g_fs_node* parent, g_fs_node* child)
 
 	g_fs_node_entry* entry = (g_fs_node_entry*) heapAllocate(sizeof(g_fs_node_entry));
 	entry->node = child;
-	entry->next = child->children;
-	child->children = entry;
+	entry->next = 0;
+	if(parent->childrenTail)
+		parent->childrenTail->next = entry;
+	else
+		parent->children = entry;
+	parent->childrenTail = entry;
+	child->parentEntry = entry;
+
+	// Replaces a negative entry if the name was looked up before
+	g_fs_dentry_key key;
+	key.parent = parent->id;
+	key.name = child->name;
+
+	mutexAcquire(&filesystemDentries->lock);
+	if(hashmapGet<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key, 0) == G_FS_DENTRY_NEGATIVE)
+		filesystemDentriesNegative--;
+	hashmapPut<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key, child);
+	mutexRelease(&filesystemDentries->lock);
 
 	mutexRelease(&delegate->lock);
 }
 
+/**
+ * Frees an unlinked node once no descriptor refers to it anymore. Must hold the
+ * lock of the node's delegate.
+ */
+static void filesystemFreeIfUnused(g_fs_node* node)
+{
+	if(!node->unlinked || node->openDescriptors > 0)
+		return;
+
+	hashmapRemove<g_fs_virt_id, g_fs_node*>(filesystemNodes, node->id);
+	heapFree(node->name);
+	heapFree(node);
+}
+
 g_fs_virt_id filesystemGetNextNodeId()
 {
 	mutexAcquire(&filesystemNextNodeIdLock);
@@ -140,6 +252,11 @@ g_fs_node* filesystemGetRoot()
 	return filesystemRoot;
 }
 
+g_fs_node* filesystemGetMountFolder()
+{
+	return mountFolder;
+}
+
 g_fs_delegate* filesystemCreateDelegate()
 {
 	g_fs_delegate* delegate = (g_fs_delegate*) heapAllocateClear(sizeof(g_fs_delegate));
@@ -175,26 +292,42 @@ g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_n
 		return G_FS_OPEN_SUCCESSFUL;
 	}
 
-	g_fs_node_entry* child = parent->children;
-	g_fs_node* lastKnown = parent;
-	while(child)
+	g_fs_dentry_key key;
+	key.parent = parent->id;
+	key.name = name;
+
+	g_fs_node* cached = hashmapGet<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key, 0);
+	if(cached == G_FS_DENTRY_NEGATIVE)
 	{
-		if(stringEquals(name, child->node->name))
-		{
-			*outChild = child->node;
-			return G_FS_OPEN_SUCCESSFUL;
-		}
-		lastKnown = child->node;
-		child = child->next;
+		*outChild = 0;
+		return G_FS_OPEN_NOT_FOUND;
+	}
+	if(cached)
+	{
+		*outChild = cached;
+		return G_FS_OPEN_SUCCESSFUL;
 	}
 
-	g_fs_delegate* delegate = filesystemFindDelegate(lastKnown);
+	g_fs_delegate* delegate = filesystemFindDelegate(parent);
 	if(!delegate->discover)
 	{
 		*outChild = 0;
 		return G_FS_OPEN_ERROR;
 	}
-	return delegate->discover(lastKnown, name, outChild);
+
+	g_fs_open_status status = delegate->discover(parent, name, outChild);
+	if(status == G_FS_OPEN_NOT_FOUND && delegate->cacheMisses)
+	{
+		mutexAcquire(&filesystemDentries->lock);
+		if(filesystemDentriesNegative < G_FS_DENTRY_NEGATIVE_MAX &&
+		   !hashmapGet<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key, 0))
+		{
+			hashmapPut<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key, G_FS_DENTRY_NEGATIVE);
+			filesystemDentriesNegative++;
+		}
+		mutexRelease(&filesystemDentries->lock);
+	}
+	return status;
 }
 
 g_fs_open_status filesystemFind(g_fs_node* parent, const char* path, g_fs_node** outChild, bool* outFoundAllButLast, g_fs_node** outLastFoundParent,
@@ -204,7 +337,7 @@ g_fs_open_status filesystemFind(g_fs_node* parent, const char* path, g_fs_node**
 	{
 		parent = filesystemRoot;
 	}
-	char* nameBuf = (char*) heapAllocate(sizeof(char) * (G_FILENAME_MAX + 1));
+	char nameBuf[G_FILENAME_MAX + 1];
 
 	const char* nameStart = path;
 	const char* nameEnd = nameStart;
@@ -230,7 +363,6 @@ g_fs_open_status filesystemFind(g_fs_node* parent, const char* path, g_fs_node**
 		if(nameLen > G_FILENAME_MAX)
 		{
 			logInfo("%! tried to resolve path with filename (%i) longer than max (%i): %s", "fs", nameLen, G_FILENAME_MAX, path);
-			heapFree(nameBuf);
 			return 0;
 		}
 
@@ -255,27 +387,23 @@ g_fs_open_status filesystemFind(g_fs_node* parent, const char* path, g_fs_node**
 	if(outFileNameStart)
 		*outFileNameStart = nameStart;
 
-	heapFree(nameBuf);
 	*outChild = node;
 	return status;
 }
 
-g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd)
+g_fs_node* filesystemGetPathOrigin(g_task* task, const char* path)
 {
-	// Decide for relative path origin
-	g_fs_node* relative = 0;
+	g_fs_node* origin = 0;
 	if(path[0] != '/')
-	{
-		const char* workingDirectoryPath = task->process->environment.workingDirectory;
-		if(workingDirectoryPath == 0)
-		{
-			workingDirectoryPath = "/";
-		}
+		origin = task->process->environment.workingDirectoryNode;
+	if(!origin)
+		origin = filesystemRoot;
+	return origin;
+}
 
-		filesystemFind(0, workingDirectoryPath, &relative);
-	}
-	if(!relative)
-		relative = filesystemGetRoot();
+g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd)
+{
+	g_fs_node* relative = filesystemGetPathOrigin(task, path);
 
 	// Try to find existing node
 	g_fs_node* file;
@@ -328,24 +456,164 @@ g_fs_open_status filesystemOpen(g_fs_node* file, g_file_flag_mode flags, g_task*
 		kernelPanic("%! failed to open file %i, delegate had no implementation", "fs", file->id);
 
 	g_fs_open_status status = delegate->open(file);
-	if(status == G_FS_OPEN_SUCCESSFUL)
+	if(status != G_FS_OPEN_SUCCESSFUL)
+		return status;
+
+	g_file_descriptor* descriptor;
+	if(filesystemProcessCreateDescriptor(task->process, file, flags, &descriptor) != G_FS_OPEN_SUCCESSFUL)
 	{
-		g_file_descriptor* descriptor;
-		filesystemProcessCreateDescriptor(task->process->id, file->id, flags, &descriptor);
-		*outFd = descriptor->id;
+		if(delegate->close)
+			delegate->close(file);
+		return G_FS_OPEN_ERROR;
 	}
-	return status;
+
+	mutexAcquire(&delegate->lock);
+	file->openDescriptors++;
+	mutexRelease(&delegate->lock);
+
+	*outFd = descriptor->id;
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_file_descriptor* filesystemCloneDescriptor(g_file_descriptor* source, g_process* targetProcess, g_fd targetFd)
+{
+	// Cloning a descriptor onto itself
+	if(targetFd != G_FD_NONE && filesystemProcessGetDescriptor(targetProcess, targetFd) == source)
+		return source;
+
+	g_fs_node* file = source->node;
+	g_fs_delegate* delegate = filesystemFindDelegate(file);
+	if(delegate->open && delegate->open(file) != G_FS_OPEN_SUCCESSFUL)
+		return 0;
+
+	if(targetFd != G_FD_NONE && filesystemProcessGetDescriptor(targetProcess, targetFd))
+		filesystemClose(targetProcess, targetFd, true);
+
+	g_file_descriptor* clone = filesystemProcessCloneDescriptor(source, targetProcess, targetFd);
+	if(!clone)
+	{
+		if(delegate->close)
+			delegate->close(file);
+		return 0;
+	}
+
+	mutexAcquire(&delegate->lock);
+	file->openDescriptors++;
+	mutexRelease(&delegate->lock);
+	return clone;
+}
+
+g_fs_open_directory_status filesystemOpenDirectory(g_task* task, const char* path, g_fs_virt_id* outFolderId)
+{
+	g_fs_node* folder;
+	g_fs_open_status status = filesystemFind(filesystemGetPathOrigin(task, path), path, &folder);
+	if(status == G_FS_OPEN_NOT_FOUND)
+		return G_FS_OPEN_DIRECTORY_NOT_FOUND;
+	if(status != G_FS_OPEN_SUCCESSFUL)
+		return G_FS_OPEN_DIRECTORY_ERROR;
+
+	if(folder->type == G_FS_NODE_TYPE_FILE || folder->type == G_FS_NODE_TYPE_PIPE)
+		return G_FS_OPEN_DIRECTORY_NOT_FOUND;
+
+	*outFolderId = folder->id;
+	return G_FS_OPEN_DIRECTORY_SUCCESSFUL;
+}
+
+/**
+ * Appends the record of a child to the buffer. The length is only filled in
+ * where it can be retrieved without waiting for a user-space delegate.
+ */
+static bool filesystemWriteDirectoryRecord(g_fs_node* child, uint8_t* buffer, uint32_t length, uint32_t* written)
+{
+	uint32_t nameLength = stringLength(child->name);
+	uint32_t recordLength = G_FS_DIRECTORY_RECORD_LENGTH(nameLength);
+	if(*written + recordLength > length)
+		return false;
+
+	g_fs_directory_record* record = (g_fs_directory_record*) &buffer[*written];
+	record->record_length = recordLength;
+	record->name_length = nameLength;
+	record->type = child->type;
+	record->node_id = child->id;
+	record->length = 0;
+	memoryCopy(G_FS_DIRECTORY_RECORD_NAME(record), child->name, nameLength + 1);
+
+	uint64_t childLength;
+	if(child->type == G_FS_NODE_TYPE_FILE && !filesystemFindDelegate(child)->threaded &&
+	   filesystemGetLength(child, &childLength) == G_FS_LENGTH_SUCCESSFUL)
+		record->length = childLength;
+
+	*written += recordLength;
+	return true;
+}
+
+g_fs_read_directory_status filesystemReadDirectory(g_fs_virt_id folderId, uint64_t* cursor, uint8_t* buffer, uint32_t length, uint32_t* outWritten)
+{
+	*outWritten = 0;
+
+	g_fs_node* folder = filesystemGetNode(folderId);
+	if(!folder || folder->type == G_FS_NODE_TYPE_FILE || folder->type == G_FS_NODE_TYPE_PIPE)
+		return G_FS_READ_DIRECTORY_ERROR;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(folder);
+	if(!folder->upToDate && delegate->refreshDirectory)
+	{
+		if(delegate->refreshDirectory(folder) != G_FS_DIRECTORY_REFRESH_SUCCESSFUL)
+			return G_FS_READ_DIRECTORY_ERROR;
+		folder->upToDate = true;
+	}
+
+	mutexAcquire(&delegate->lock);
+
+	// The cursor is the id of the last child that was returned. Usually the read
+	// continues right behind it; if it was removed meanwhile, children are skipped
+	// up to its id, as they were added in the order of their ids.
+	g_fs_virt_id last = *cursor;
+	g_fs_node_entry* entry = folder->children;
+	if(last != 0)
+	{
+		g_fs_node* lastNode = filesystemGetNode(last);
+		if(lastNode && lastNode->parent == folder && lastNode->parentEntry)
+		{
+			entry = lastNode->parentEntry->next;
+		} else
+		{
+			while(entry && entry->node->id <= last)
+				entry = entry->next;
+		}
+	}
+
+	bool full = false;
+	while(entry)
+	{
+		if(!filesystemWriteDirectoryRecord(entry->node, buffer, length, outWritten))
+		{
+			full = true;
+			break;
+		}
+		last = entry->node->id;
+		entry = entry->next;
+	}
+
+	mutexRelease(&delegate->lock);
+
+	*cursor = last;
+	if(*outWritten > 0)
+		return G_FS_READ_DIRECTORY_SUCCESSFUL;
+
+	// Buffer can't even hold a single record
+	return full ? G_FS_READ_DIRECTORY_ERROR : G_FS_READ_DIRECTORY_EOD;
 }
 
 g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outRead)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_READ_INVALID_FD;
 	}
 
-	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	g_fs_node* node = descriptor->node;
 	if(!node)
 	{
 		return G_FS_READ_INVALID_FD;
@@ -366,24 +634,113 @@ g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t
 	return status;
 }
 
+bool filesystemTryRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, g_fs_read_status* outStatus, int64_t* outRead)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+	{
+		*outStatus = G_FS_READ_INVALID_FD;
+		return true;
+	}
+
+	g_fs_node* node = descriptor->node;
+	if(!node)
+	{
+		*outStatus = G_FS_READ_INVALID_FD;
+		return true;
+	}
+
+	int64_t read;
+	g_fs_read_status status;
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(delegate->cached)
+	{
+		// Only served if the data is cached, filling the cache must happen in a kernel thread
+		status = filesystemCacheRead(delegate, node, buffer, descriptor->offset, length, &read, false);
+		if(status == G_FS_READ_BUSY)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		status = filesystemRead(node, buffer, descriptor->offset, length, &read);
+		if(status == G_FS_READ_BUSY && node->blocking)
+		{
+			return false;
+		}
+	}
+	if(read > 0)
+	{
+		descriptor->offset += read;
+	}
+	*outRead = read;
+	*outStatus = status;
+	return true;
+}
+
 g_fs_read_status filesystemRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(node);
 	if(!delegate->read)
 		return G_FS_READ_ERROR;
 
+	if(delegate->cached)
+		return filesystemCacheRead(delegate, node, buffer, offset, length, outRead);
+
 	return delegate->read(node, buffer, offset, length, outRead);
 }
 
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vector, int32_t count, int64_t* outRead)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+	{
+		return G_FS_READ_INVALID_FD;
+	}
+
+	g_fs_node* node = descriptor->node;
+	if(!node)
+	{
+		return G_FS_READ_INVALID_FD;
+	}
+
+	int64_t total = 0;
+	g_fs_read_status status = G_FS_READ_SUCCESSFUL;
+	for(int32_t i = 0; i < count; i++)
+	{
+		if(vector[i].length == 0)
+			continue;
+
+		int64_t read;
+		while((status = filesystemRead(node, (uint8_t*) vector[i].buffer, descriptor->offset, vector[i].length, &read)) == G_FS_READ_BUSY &&
+			  node->blocking && total == 0)
+		{
+			filesystemWaitToRead(task, node);
+			taskingKernelThreadYield();
+		}
+		if(status != G_FS_READ_SUCCESSFUL || read <= 0)
+			break;
+
+		descriptor->offset += read;
+		total += read;
+		if((uint64_t) read < vector[i].length)
+			break;
+	}
+
+	*outRead = total;
+	return total > 0 ? G_FS_READ_SUCCESSFUL : status;
+}
+
 g_fs_length_status filesystemGetLength(g_task* task, g_fd fd, uint64_t* outLength)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_LENGTH_INVALID_FD;
 	}
 
-	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	g_fs_node* node = descriptor->node;
 	if(!node)
 	{
 		return G_FS_LENGTH_INVALID_FD;
@@ -398,18 +755,23 @@ g_fs_length_status filesystemGetLength(g_fs_node* node, uint64_t* outLength)
 	if(!delegate->getLength)
 		return G_FS_LENGTH_ERROR;
 
-	return delegate->getLength(node, outLength);
+	g_fs_length_status status = delegate->getLength(node, outLength);
+
+	// Writes that are not flushed yet might have extended the file
+	if(status == G_FS_LENGTH_SUCCESSFUL && delegate->cached && node->cacheWrittenEnd > *outLength)
+		*outLength = node->cacheWrittenEnd;
+	return status;
 }
 
 g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outWrote)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_WRITE_INVALID_FD;
 	}
 
-	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	g_fs_node* node = descriptor->node;
 	if(!node)
 	{
 		return G_FS_WRITE_INVALID_FD;
@@ -440,15 +802,118 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 	return status;
 }
 
+bool filesystemTryWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, g_fs_write_status* outStatus, int64_t* outWrote)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+	{
+		*outStatus = G_FS_WRITE_INVALID_FD;
+		return true;
+	}
+
+	g_fs_node* node = descriptor->node;
+	if(!node)
+	{
+		*outStatus = G_FS_WRITE_INVALID_FD;
+		return true;
+	}
+
+	// Writing through the cache may have to fill or write back pages
+	if(filesystemFindDelegate(node)->cached)
+	{
+		return false;
+	}
+
+	uint64_t startOffset = descriptor->offset;
+	if(descriptor->openFlags & G_FILE_FLAG_MODE_APPEND)
+	{
+		if(filesystemGetLength(node, &startOffset) != G_FS_LENGTH_SUCCESSFUL)
+		{
+			logInfo("%! failed to append to file %i, could not get length", "fs", node->id);
+			*outStatus = G_FS_WRITE_ERROR;
+			return true;
+		}
+	}
+
+	int64_t wrote;
+	g_fs_write_status status = filesystemWrite(node, buffer, startOffset, length, &wrote);
+	if(status == G_FS_WRITE_BUSY && node->blocking)
+	{
+		return false;
+	}
+	if(wrote > 0)
+	{
+		descriptor->offset = startOffset + wrote;
+	}
+	*outWrote = wrote;
+	*outStatus = status;
+	return true;
+}
+
 g_fs_write_status filesystemWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(node);
 	if(!delegate->write)
 		return G_FS_WRITE_ERROR;
 
+	if(delegate->cached)
+		return filesystemCacheWrite(delegate, node, buffer, offset, length, outWrote);
+
 	return delegate->write(node, buffer, offset, length, outWrote);
 }
 
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vector, int32_t count, int64_t* outWrote)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+	{
+		return G_FS_WRITE_INVALID_FD;
+	}
+
+	g_fs_node* node = descriptor->node;
+	if(!node)
+	{
+		return G_FS_WRITE_INVALID_FD;
+	}
+
+	uint64_t offset = descriptor->offset;
+	if(descriptor->openFlags & G_FILE_FLAG_MODE_APPEND)
+	{
+		if(filesystemGetLength(node, &offset) != G_FS_LENGTH_SUCCESSFUL)
+		{
+			logInfo("%! failed to append to file %i, could not get length", "fs", node->id);
+			return G_FS_WRITE_ERROR;
+		}
+	}
+
+	int64_t total = 0;
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	for(int32_t i = 0; i < count; i++)
+	{
+		if(vector[i].length == 0)
+			continue;
+
+		int64_t wrote;
+		while((status = filesystemWrite(node, (uint8_t*) vector[i].buffer, offset, vector[i].length, &wrote)) == G_FS_WRITE_BUSY &&
+			  node->blocking && total == 0)
+		{
+			filesystemWaitToWrite(task, node);
+			taskingKernelThreadYield();
+		}
+		if(status != G_FS_WRITE_SUCCESSFUL || wrote <= 0)
+			break;
+
+		offset += wrote;
+		descriptor->offset = offset;
+		total += wrote;
+		if((uint64_t) wrote < vector[i].length)
+			break;
+	}
+
+	*outWrote = total;
+	return total > 0 ? G_FS_WRITE_SUCCESSFUL : status;
+}
+
 g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_node** outFile)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(parent);
@@ -464,9 +929,102 @@ g_fs_open_status filesystemTruncate(g_fs_node* file)
 	if(!delegate->truncate)
 		return G_FS_OPEN_ERROR;
 
+	if(delegate->cached)
+		filesystemCacheDrop(file);
+
 	return delegate->truncate(file);
 }
 
+g_fs_unlink_status filesystemUnlink(g_fs_node* file)
+{
+	g_fs_node* parent = file->parent;
+	if(!parent || file->type != G_FS_NODE_TYPE_FILE)
+		return G_FS_UNLINK_ERROR;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(file);
+	if(!delegate->unlink)
+		return G_FS_UNLINK_NOT_SUPPORTED;
+
+	g_fs_unlink_status status = delegate->unlink(file);
+	if(status != G_FS_UNLINK_SUCCESSFUL)
+		return status;
+
+	if(delegate->cached)
+		filesystemCacheDrop(file);
+
+	mutexAcquire(&delegate->lock);
+
+	g_fs_node_entry* previous = 0;
+	g_fs_node_entry** entry = &parent->children;
+	while(*entry)
+	{
+		if((*entry)->node == file)
+		{
+			g_fs_node_entry* removed = *entry;
+			*entry = removed->next;
+			if(parent->childrenTail == removed)
+				parent->childrenTail = previous;
+			heapFree(removed);
+			break;
+		}
+		previous = *entry;
+		entry = &(*entry)->next;
+	}
+	file->parentEntry = 0;
+
+	g_fs_dentry_key key;
+	key.parent = parent->id;
+	key.name = file->name;
+	hashmapRemove<g_fs_dentry_key, g_fs_node*>(filesystemDentries, key);
+
+	// Open descriptors still need to find the delegate
+	file->delegate = delegate;
+	file->parent = 0;
+	file->unlinked = true;
+	filesystemFreeIfUnused(file);
+	mutexRelease(&delegate->lock);
+	return G_FS_UNLINK_SUCCESSFUL;
+}
+
+g_fs_flush_status filesystemFlush(g_task* task, g_fd fd)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor || !descriptor->node)
+		return G_FS_FLUSH_INVALID_FD;
+
+	g_fs_node* file = descriptor->node;
+	if(!filesystemFindDelegate(file)->cached)
+		return G_FS_FLUSH_SUCCESSFUL;
+
+	if(filesystemCacheFlush(file) != G_FS_WRITE_SUCCESSFUL)
+		return G_FS_FLUSH_ERROR;
+	return G_FS_FLUSH_SUCCESSFUL;
+}
+
+g_fs_poll_events filesystemPollDescriptor(g_process* process, g_fd fd, g_fs_poll_events events, g_tid subscriber)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(process, fd);
+	if(!descriptor || !descriptor->node)
+		return G_FS_POLL_INVALID;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(descriptor->node);
+	if(!delegate->poll)
+		return events & (G_FS_POLL_READ | G_FS_POLL_WRITE);
+
+	return delegate->poll(descriptor->node, events, subscriber);
+}
+
+void filesystemUnpollDescriptor(g_process* process, g_fd fd, g_tid subscriber)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(process, fd);
+	if(!descriptor || !descriptor->node)
+		return;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(descriptor->node);
+	if(delegate->unpoll)
+		delegate->unpoll(descriptor->node, subscriber);
+}
+
 void filesystemWaitToWrite(g_task* task, g_fs_node* file)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(file);
@@ -510,19 +1068,28 @@ g_fs_pipe_status filesystemCreatePipe(g_bool blocking, g_fs_node** outPipeNode)
 	return G_FS_PIPE_SUCCESSFUL;
 }
 
-g_fs_close_status filesystemClose(g_pid pid, g_fd fd, g_bool removeDescriptor)
+bool filesystemNeedsThread(g_task* task, g_fd fd)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(pid, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor || !descriptor->node)
+		return false;
+
+	return filesystemFindDelegate(descriptor->node)->threaded;
+}
+
+g_fs_close_status filesystemClose(g_process* process, g_fd fd, g_bool removeDescriptor)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(process, fd);
 	if(!descriptor)
 	{
-		logInfo("%! failed to close fd %i in process %i, illegal descriptor", "fs", fd, pid);
+		logInfo("%! failed to close fd %i in process %i, illegal descriptor", "fs", fd, process->id);
 		return G_FS_CLOSE_INVALID_FD;
 	}
 
-	g_fs_node* file = filesystemGetNode(descriptor->nodeId);
+	g_fs_node* file = descriptor->node;
 	if(!file)
 	{
-		logInfo("%! failed to close fd %i in process %i, illegal node", "fs", pid);
+		logInfo("%! failed to close fd %i in process %i, illegal node", "fs", fd, process->id);
 		return G_FS_CLOSE_INVALID_FD;
 	}
 
@@ -530,26 +1097,49 @@ g_fs_close_status filesystemClose(g_pid pid, g_fd fd, g_bool removeDescriptor)
 	if(!delegate->close)
 		kernelPanic("%! failed to close file %i, delegate had no implementation", "fs", file->id);
 
-	g_fs_close_status status = delegate->close(file);
-	if(status == G_FS_CLOSE_SUCCESSFUL && removeDescriptor)
+	g_fs_close_status status;
+	if(delegate->cached && filesystemCacheFlush(file) == G_FS_WRITE_BUSY)
 	{
-		filesystemProcessRemoveDescriptor(pid, fd);
+		// This thread can't wait for the delegate, the worker writes back and closes
+		filesystemCacheDeferClose(file);
+		status = G_FS_CLOSE_SUCCESSFUL;
+	} else
+	{
+		status = filesystemCloseNode(file);
 	}
 
-	logDebug("%! closed file descriptor %i in process %i", "fs", fd, pid);
+	if(status == G_FS_CLOSE_SUCCESSFUL && removeDescriptor)
+		filesystemProcessRemoveDescriptor(process, fd);
+
+	logDebug("%! closed file descriptor %i in process %i", "fs", fd, process->id);
 
 	return status;
 }
 
+g_fs_close_status filesystemCloseNode(g_fs_node* file)
+{
+	g_fs_delegate* delegate = filesystemFindDelegate(file);
+	g_fs_close_status status = delegate->close(file);
+	if(status == G_FS_CLOSE_SUCCESSFUL)
+	{
+		mutexAcquire(&delegate->lock);
+		if(file->openDescriptors > 0)
+			file->openDescriptors--;
+		filesystemFreeIfUnused(file);
+		mutexRelease(&delegate->lock);
+	}
+	return status;
+}
+
 g_fs_seek_status filesystemSeek(g_task* task, g_fd fd, g_fs_seek_mode mode, int64_t amount, int64_t* outResult)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_SEEK_INVALID_FD;
 	}
 
-	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	g_fs_node* node = descriptor->node;
 	if(!node)
 	{
 		return G_FS_SEEK_INVALID_FD;
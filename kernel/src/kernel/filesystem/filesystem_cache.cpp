@@ -0,0 +1,600 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_cache.hpp"
+
+#include "kernel/memory/memory.hpp"
+#include "kernel/utils/hashmap.hpp"
+#include "kernel/kernel.hpp"
+#include "kernel/tasking/wait.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Key of the page lookup map.
+ */
+struct g_fs_cache_key
+{
+	g_fs_virt_id node;
+	uint32_t index;
+};
+
+static g_mutex filesystemCacheLock;
+static g_hashmap<g_fs_cache_key, g_fs_cache_page*>* filesystemCachePages;
+static uint32_t filesystemCachePageCount;
+
+// most recently used page first
+static g_fs_cache_page* filesystemCacheLruFirst;
+static g_fs_cache_page* filesystemCacheLruLast;
+
+/**
+ * Closes that wait for the worker, see <filesystemCacheDeferClose>.
+ */
+struct g_fs_cache_deferred_close
+{
+	g_fs_node* node;
+	g_fs_cache_deferred_close* next;
+};
+
+static g_fs_cache_deferred_close* filesystemCacheDeferredFirst;
+static g_fs_cache_deferred_close* filesystemCacheDeferredLast;
+static bool filesystemCacheWorkerStarted;
+
+static g_fs_cache_key filesystemCacheKeyCopy(g_fs_cache_key key)
+{
+	return key;
+}
+
+static int filesystemCacheKeyHash(g_fs_cache_key key)
+{
+	int hash = key.node * 31 + key.index;
+	if(hash < 0)
+		hash = -hash;
+	return hash;
+}
+
+static void filesystemCacheKeyFree(g_fs_cache_key key)
+{
+}
+
+static bool filesystemCacheKeyEquals(g_fs_cache_key k1, g_fs_cache_key k2)
+{
+	return k1.node == k2.node && k1.index == k2.index;
+}
+
+void filesystemCacheInitialize()
+{
+	mutexInitialize(&filesystemCacheLock);
+	filesystemCachePages = hashmapInternalCreate<g_fs_cache_key, g_fs_cache_page*>(1024);
+	filesystemCachePages->keyCopy = filesystemCacheKeyCopy;
+	filesystemCachePages->keyHash = filesystemCacheKeyHash;
+	filesystemCachePages->keyFree = filesystemCacheKeyFree;
+	filesystemCachePages->keyEquals = filesystemCacheKeyEquals;
+	filesystemCachePageCount = 0;
+	filesystemCacheLruFirst = 0;
+	filesystemCacheLruLast = 0;
+	filesystemCacheDeferredFirst = 0;
+	filesystemCacheDeferredLast = 0;
+	filesystemCacheWorkerStarted = false;
+}
+
+static g_fs_cache_page* filesystemCacheLookup(g_fs_node* node, uint32_t index)
+{
+	g_fs_cache_key key;
+	key.node = node->id;
+	key.index = index;
+	return hashmapGet<g_fs_cache_key, g_fs_cache_page*>(filesystemCachePages, key, 0);
+}
+
+static void filesystemCacheLruRemove(g_fs_cache_page* page)
+{
+	if(page->lruPrevious)
+		page->lruPrevious->lruNext = page->lruNext;
+	else
+		filesystemCacheLruFirst = page->lruNext;
+
+	if(page->lruNext)
+		page->lruNext->lruPrevious = page->lruPrevious;
+	else
+		filesystemCacheLruLast = page->lruPrevious;
+}
+
+static void filesystemCacheLruPushFront(g_fs_cache_page* page)
+{
+	page->lruPrevious = 0;
+	page->lruNext = filesystemCacheLruFirst;
+	if(filesystemCacheLruFirst)
+		filesystemCacheLruFirst->lruPrevious = page;
+	else
+		filesystemCacheLruLast = page;
+	filesystemCacheLruFirst = page;
+}
+
+static void filesystemCacheTouch(g_fs_cache_page* page)
+{
+	if(filesystemCacheLruFirst == page)
+		return;
+
+	filesystemCacheLruRemove(page);
+	filesystemCacheLruPushFront(page);
+}
+
+/**
+ * Takes a page out of all lists, the caller frees it. Must hold the cache lock.
+ */
+static void filesystemCacheRemove(g_fs_cache_page* page)
+{
+	g_fs_cache_key key;
+	key.node = page->node->id;
+	key.index = page->index;
+	hashmapRemove<g_fs_cache_key, g_fs_cache_page*>(filesystemCachePages, key);
+
+	filesystemCacheLruRemove(page);
+
+	if(page->nodePrevious)
+		page->nodePrevious->nodeNext = page->nodeNext;
+	else
+		page->node->cachePages = page->nodeNext;
+	if(page->nodeNext)
+		page->nodeNext->nodePrevious = page->nodePrevious;
+
+	if(page->dirty)
+		page->node->cacheDirtyPages--;
+	filesystemCachePageCount--;
+}
+
+static void filesystemCacheFree(g_fs_cache_page* page)
+{
+	memoryFreeKernelPage(page->data);
+	heapFree(page);
+}
+
+/**
+ * Writes a page back to the delegate. The page is marked busy so that it is
+ * not evicted while the cache lock is released; if it was dropped meanwhile,
+ * it is freed afterwards and must not be used by the caller. A short write
+ * counts as a failure and leaves the page dirty. Must hold the cache lock.
+ */
+static g_fs_write_status filesystemCacheWriteBack(g_fs_cache_page* page)
+{
+	page->busy = true;
+	page->dirty = false;
+	page->node->cacheDirtyPages--;
+	uint32_t length = page->valid;
+	mutexRelease(&filesystemCacheLock);
+
+	g_fs_delegate* delegate = filesystemFindDelegate(page->node);
+	int64_t wrote = 0;
+	g_fs_write_status status = delegate->write(page->node, (uint8_t*) page->data, (uint64_t) page->index * G_PAGE_SIZE, length, &wrote);
+	if(status == G_FS_WRITE_SUCCESSFUL && wrote < (int64_t) length)
+		status = G_FS_WRITE_ERROR;
+
+	mutexAcquire(&filesystemCacheLock);
+	page->busy = false;
+	if(page->dropped)
+	{
+		filesystemCacheFree(page);
+		return status;
+	}
+
+	if(status != G_FS_WRITE_SUCCESSFUL)
+	{
+		if(status != G_FS_WRITE_BUSY)
+			logInfo("%! failed to write back page %i of node %i", "fscache", page->index, page->node->id);
+
+		if(!page->dirty)
+		{
+			page->dirty = true;
+			page->node->cacheDirtyPages++;
+		}
+	}
+	return status;
+}
+
+/**
+ * Evicts pages from the end of the LRU list until the cache is within its limits.
+ * Clean pages are preferred, dirty pages are only written back if nothing else
+ * can be evicted. If a write-back fails, the cache stays above its limits until
+ * the delegate accepts writes again. Must hold the cache lock.
+ */
+static void filesystemCacheEvict()
+{
+	while(filesystemCachePageCount > 0 && (filesystemCachePageCount >= G_FS_CACHE_MAXIMUM_PAGES ||
+			memoryPhysicalAllocator.freePageCount < G_FS_CACHE_MINIMUM_FREE_PAGES))
+	{
+		g_fs_cache_page* victim = 0;
+		g_fs_cache_page* dirtyVictim = 0;
+		for(g_fs_cache_page* page = filesystemCacheLruLast; page; page = page->lruPrevious)
+		{
+			if(page->busy)
+				continue;
+
+			if(!page->dirty)
+			{
+				victim = page;
+				break;
+			}
+			if(!dirtyVictim)
+				dirtyVictim = page;
+		}
+
+		if(!victim && dirtyVictim)
+		{
+			if(filesystemCacheWriteBack(dirtyVictim) != G_FS_WRITE_SUCCESSFUL)
+				break;
+			continue;
+		}
+		if(!victim)
+			break;
+
+		filesystemCacheRemove(victim);
+		filesystemCacheFree(victim);
+	}
+}
+
+/**
+ * Creates a page and inserts it, unless the page was inserted in the meantime.
+ * Must hold the cache lock.
+ */
+static g_fs_cache_page* filesystemCacheInsert(g_fs_node* node, uint32_t index, uint8_t* content, uint32_t valid)
+{
+	g_fs_cache_page* existing = filesystemCacheLookup(node, index);
+	if(existing)
+		return existing;
+
+	filesystemCacheEvict();
+
+	// Eviction might have released the lock
+	existing = filesystemCacheLookup(node, index);
+	if(existing)
+		return existing;
+
+	g_virtual_address data = memoryAllocateKernelPage();
+	if(!data)
+		return 0;
+
+	g_fs_cache_page* page = (g_fs_cache_page*) heapAllocate(sizeof(g_fs_cache_page));
+	page->node = node;
+	page->index = index;
+	page->data = data;
+	page->valid = valid;
+	page->dirty = false;
+	page->busy = false;
+	page->dropped = false;
+	if(content && valid > 0)
+		memoryCopy((void*) data, content, valid);
+
+	g_fs_cache_key key;
+	key.node = node->id;
+	key.index = index;
+	hashmapPut<g_fs_cache_key, g_fs_cache_page*>(filesystemCachePages, key, page);
+
+	filesystemCacheLruPushFront(page);
+
+	page->nodePrevious = 0;
+	page->nodeNext = node->cachePages;
+	if(node->cachePages)
+		node->cachePages->nodePrevious = page;
+	node->cachePages = page;
+
+	filesystemCachePageCount++;
+	return page;
+}
+
+/**
+ * Reads "count" pages starting at "index" from the delegate with a single request
+ * and inserts them. Stops at the end of the file.
+ */
+static g_fs_read_status filesystemCacheFill(g_fs_delegate* delegate, g_fs_node* node, uint32_t index, uint32_t count)
+{
+	// Delegates may map the buffer into a driver, so it must not share pages with the heap
+	uint8_t* buffer = (uint8_t*) memoryAllocateKernelRange(count);
+	if(!buffer)
+		return G_FS_READ_ERROR;
+
+	int64_t read = 0;
+	g_fs_read_status status = delegate->read(node, buffer, (uint64_t) index * G_PAGE_SIZE, count * G_PAGE_SIZE, &read);
+	if(status == G_FS_READ_SUCCESSFUL)
+	{
+		mutexAcquire(&filesystemCacheLock);
+		for(uint32_t i = 0; i < count; i++)
+		{
+			int64_t remaining = read - (int64_t) i * G_PAGE_SIZE;
+			uint32_t valid = remaining <= 0 ? 0 : (remaining > G_PAGE_SIZE ? G_PAGE_SIZE : remaining);
+
+			// The first page is always inserted so that the end of the file is known
+			if(valid == 0 && i > 0)
+				break;
+
+			if(!filesystemCacheInsert(node, index + i, &buffer[i * G_PAGE_SIZE], valid))
+			{
+				if(i == 0)
+					status = G_FS_READ_ERROR;
+				break;
+			}
+		}
+		mutexRelease(&filesystemCacheLock);
+	}
+
+	memoryFreeKernelRange((g_virtual_address) buffer);
+	return status;
+}
+
+/**
+ * Returns the number of readable bytes in a page. Bytes behind the valid length
+ * are zero and readable if the file was extended by writes through the cache.
+ */
+static uint32_t filesystemCacheReadable(g_fs_cache_page* page)
+{
+	uint64_t pageStart = (uint64_t) page->index * G_PAGE_SIZE;
+	if(page->node->cacheWrittenEnd > pageStart + page->valid)
+	{
+		uint64_t readable = page->node->cacheWrittenEnd - pageStart;
+		return readable > G_PAGE_SIZE ? G_PAGE_SIZE : readable;
+	}
+	return page->valid;
+}
+
+g_fs_read_status filesystemCacheRead(g_fs_delegate* delegate, g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead,
+		bool allowFill)
+{
+	// Grow the read-ahead window while the node is read sequentially
+	uint32_t readAhead = 0;
+	if(offset == node->cacheNextOffset && offset > 0)
+		readAhead = node->cacheReadAhead == 0 ? 1 : node->cacheReadAhead * 2;
+	if(readAhead > G_FS_CACHE_MAXIMUM_READ_AHEAD)
+		readAhead = G_FS_CACHE_MAXIMUM_READ_AHEAD;
+
+	uint32_t lastIndex = (offset + length + G_PAGE_SIZE - 1) / G_PAGE_SIZE;
+
+	uint64_t done = 0;
+	g_fs_read_status status = G_FS_READ_SUCCESSFUL;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t index = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+
+		mutexAcquire(&filesystemCacheLock);
+		g_fs_cache_page* page = filesystemCacheLookup(node, index);
+		if(!page)
+		{
+			mutexRelease(&filesystemCacheLock);
+			if(!allowFill)
+			{
+				status = G_FS_READ_BUSY;
+				break;
+			}
+
+			// Large reads are filled in parts so that they don't evict their own pages
+			uint32_t count = (lastIndex - index) + readAhead;
+			if(count > G_FS_CACHE_MAXIMUM_FILL)
+				count = G_FS_CACHE_MAXIMUM_FILL;
+
+			status = filesystemCacheFill(delegate, node, index, count);
+			if(status != G_FS_READ_SUCCESSFUL)
+				break;
+			continue;
+		}
+
+		filesystemCacheTouch(page);
+
+		uint32_t readable = filesystemCacheReadable(page);
+		uint32_t chunk = 0;
+		if(readable > pageOffset)
+		{
+			chunk = readable - pageOffset;
+			if(chunk > length - done)
+				chunk = length - done;
+			memoryCopy(&buffer[done], (uint8_t*) (page->data + pageOffset), chunk);
+		}
+		mutexRelease(&filesystemCacheLock);
+
+		done += chunk;
+		if(readable < G_PAGE_SIZE)
+			break;
+	}
+
+	if(done > 0)
+		status = G_FS_READ_SUCCESSFUL;
+	if(status != G_FS_READ_BUSY)
+	{
+		node->cacheReadAhead = readAhead;
+		node->cacheNextOffset = offset + done;
+	}
+	*outRead = done;
+	return status;
+}
+
+g_fs_write_status filesystemCacheWrite(g_fs_delegate* delegate, g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	uint64_t done = 0;
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t index = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+
+		uint32_t chunk = G_PAGE_SIZE - pageOffset;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		mutexAcquire(&filesystemCacheLock);
+		g_fs_cache_page* page = filesystemCacheLookup(node, index);
+		if(!page && chunk == G_PAGE_SIZE)
+		{
+			// Overwritten completely, no need to read it first
+			page = filesystemCacheInsert(node, index, 0, 0);
+			if(!page)
+			{
+				mutexRelease(&filesystemCacheLock);
+				status = G_FS_WRITE_ERROR;
+				break;
+			}
+		}
+		if(!page)
+		{
+			mutexRelease(&filesystemCacheLock);
+			if(filesystemCacheFill(delegate, node, index, 1) != G_FS_READ_SUCCESSFUL)
+			{
+				status = G_FS_WRITE_ERROR;
+				break;
+			}
+			continue;
+		}
+
+		memoryCopy((uint8_t*) (page->data + pageOffset), &buffer[done], chunk);
+		if(pageOffset + chunk > page->valid)
+			page->valid = pageOffset + chunk;
+		if(!page->dirty)
+		{
+			page->dirty = true;
+			node->cacheDirtyPages++;
+		}
+		filesystemCacheTouch(page);
+		if(position + chunk > node->cacheWrittenEnd)
+			node->cacheWrittenEnd = position + chunk;
+		mutexRelease(&filesystemCacheLock);
+
+		done += chunk;
+	}
+
+	if(node->cacheDirtyPages > G_FS_CACHE_MAXIMUM_DIRTY_PAGES)
+		filesystemCacheFlush(node);
+
+	if(done > 0)
+		status = G_FS_WRITE_SUCCESSFUL;
+	*outWrote = done;
+	return status;
+}
+
+g_fs_write_status filesystemCacheFlush(g_fs_node* node)
+{
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+
+	mutexAcquire(&filesystemCacheLock);
+	while(node->cacheDirtyPages > 0)
+	{
+		g_fs_cache_page* dirty = 0;
+		for(g_fs_cache_page* page = node->cachePages; page; page = page->nodeNext)
+		{
+			if(page->dirty && !page->busy)
+			{
+				dirty = page;
+				break;
+			}
+		}
+		if(!dirty)
+			break;
+
+		status = filesystemCacheWriteBack(dirty);
+		if(status != G_FS_WRITE_SUCCESSFUL)
+			break;
+	}
+	mutexRelease(&filesystemCacheLock);
+	return status;
+}
+
+void filesystemCacheDrop(g_fs_node* node)
+{
+	mutexAcquire(&filesystemCacheLock);
+	g_fs_cache_page* page = node->cachePages;
+	while(page)
+	{
+		g_fs_cache_page* next = page->nodeNext;
+		filesystemCacheRemove(page);
+		if(page->busy)
+			page->dropped = true;
+		else
+			filesystemCacheFree(page);
+		page = next;
+	}
+	node->cacheWrittenEnd = 0;
+	node->cacheNextOffset = 0;
+	node->cacheReadAhead = 0;
+	mutexRelease(&filesystemCacheLock);
+}
+
+/**
+ * Flushes and closes nodes whose close was deferred. Runs in a thread that can
+ * wait for user-space delegates.
+ */
+static void filesystemCacheWorkerEntry()
+{
+	g_task* worker = taskingGetCurrentTask();
+	for(;;)
+	{
+		mutexAcquire(&filesystemCacheLock);
+		g_fs_cache_deferred_close* deferred = filesystemCacheDeferredFirst;
+		if(deferred)
+		{
+			filesystemCacheDeferredFirst = deferred->next;
+			if(!filesystemCacheDeferredFirst)
+				filesystemCacheDeferredLast = 0;
+		}
+		mutexRelease(&filesystemCacheLock);
+
+		if(!deferred)
+		{
+			waitForCacheWork(worker);
+			taskingKernelThreadYield();
+			continue;
+		}
+
+		filesystemCacheFlush(deferred->node);
+		filesystemCloseNode(deferred->node);
+		heapFree(deferred);
+	}
+}
+
+void filesystemCacheDeferClose(g_fs_node* node)
+{
+	g_fs_cache_deferred_close* deferred = (g_fs_cache_deferred_close*) heapAllocate(sizeof(g_fs_cache_deferred_close));
+	deferred->node = node;
+	deferred->next = 0;
+
+	mutexAcquire(&filesystemCacheLock);
+	if(filesystemCacheDeferredLast)
+		filesystemCacheDeferredLast->next = deferred;
+	else
+		filesystemCacheDeferredFirst = deferred;
+	filesystemCacheDeferredLast = deferred;
+
+	bool startWorker = !filesystemCacheWorkerStarted;
+	filesystemCacheWorkerStarted = true;
+	mutexRelease(&filesystemCacheLock);
+
+	if(startWorker)
+	{
+		g_process* process = taskingCreateProcess();
+		g_task* worker = taskingCreateThread((g_virtual_address) filesystemCacheWorkerEntry, process, G_SECURITY_LEVEL_KERNEL);
+		worker->type = G_THREAD_TYPE_SYSCALL;
+
+		g_tasking_local* local = taskingGetLocal();
+		mutexAcquire(&local->lock);
+		taskingAssign(local, worker);
+		mutexRelease(&local->lock);
+	}
+}
+
+bool filesystemCacheHasWork()
+{
+	return filesystemCacheDeferredFirst != 0;
+}
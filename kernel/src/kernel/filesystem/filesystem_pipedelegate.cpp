@@ -59,6 +59,16 @@ g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file)
 	return pipeTruncate(file->physicalId);
 }
 
+g_fs_poll_events filesystemPipeDelegatePoll(g_fs_node* node, g_fs_poll_events events, g_tid subscriber)
+{
+	return pipePoll(node->physicalId, events, subscriber);
+}
+
+void filesystemPipeDelegateUnpoll(g_fs_node* node, g_tid subscriber)
+{
+	pipeUnpoll(node->physicalId, subscriber);
+}
+
 bool filesystemPipeDelegateWaitResolverRead(g_task* task)
 {
 	g_wait_resolver_for_file_data* waitData = (g_wait_resolver_for_file_data*) task->waitData;
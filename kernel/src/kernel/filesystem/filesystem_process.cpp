@@ -22,106 +22,179 @@
 #include "kernel/memory/memory.hpp"
 #include "shared/logger/logger.hpp"
 
-static g_hashmap<g_pid, g_filesystem_process*>* filesystemProcessInfo;
+#define G_FILESYSTEM_PROCESS_INITIAL_DESCRIPTORS	16
+#define G_FILESYSTEM_PROCESS_FIRST_DESCRIPTOR		3 // after stdin, stdout, stderr
 
-void filesystemProcessInitialize()
+static g_file_descriptor_table* filesystemProcessCreateTable(g_fd capacity, g_file_descriptor_table* previous)
 {
-	filesystemProcessInfo = hashmapCreateNumeric<g_pid, g_filesystem_process*>(128);
+	g_file_descriptor_table* table = (g_file_descriptor_table*) heapAllocate(sizeof(g_file_descriptor_table));
+	if(!table)
+		return 0;
+
+	table->capacity = capacity;
+	table->descriptors = (g_file_descriptor**) heapAllocateClear(sizeof(g_file_descriptor*) * capacity);
+	if(!table->descriptors)
+	{
+		heapFree(table);
+		return 0;
+	}
+
+	table->previous = previous;
+	if(previous)
+		memoryCopy(table->descriptors, previous->descriptors, sizeof(g_file_descriptor*) * previous->capacity);
+	return table;
 }
 
-void filesystemProcessCreate(g_pid pid)
+void filesystemProcessCreate(g_process* process)
 {
 	g_filesystem_process* info = (g_filesystem_process*) heapAllocate(sizeof(g_filesystem_process));
-
-	info->nextDescriptor = 3; // after stdin, stdout, stderr
-	mutexInitialize(&info->nextDescriptorLock);
-	info->descriptors = hashmapCreateNumeric<g_fd, g_file_descriptor*>(128);
-
-	hashmapPut(filesystemProcessInfo, pid, info);
+	mutexInitialize(&info->lock);
+	info->table = filesystemProcessCreateTable(G_FILESYSTEM_PROCESS_INITIAL_DESCRIPTORS, 0);
+	process->filesystem = info;
 }
 
-g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeId, g_file_flag_mode flags, g_file_descriptor** outDescriptor, g_fd optionalFd)
+g_fs_open_status filesystemProcessCreateDescriptor(g_process* process, g_fs_node* node, g_file_flag_mode flags, g_file_descriptor** outDescriptor,
+		g_fd optionalFd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 	{
-		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
+		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", process->id);
 		return G_FS_OPEN_ERROR;
 	}
 
-	g_file_descriptor* descriptor = (g_file_descriptor*) heapAllocate(sizeof(g_file_descriptor));
+	if(optionalFd != G_FD_NONE && (optionalFd < 0 || optionalFd >= G_FD_MAX))
+	{
+		logInfo("%! tried to create file descriptor with invalid id %i in process %i", "filesystem", optionalFd, process->id);
+		return G_FS_OPEN_ERROR;
+	}
+
+	mutexAcquire(&info->lock);
 
-	if(optionalFd == G_FD_NONE) {
-		mutexAcquire(&info->nextDescriptorLock);
-		descriptor->id = info->nextDescriptor++;
-		mutexRelease(&info->nextDescriptorLock);
-	} else {
-		descriptor->id = optionalFd;
+	g_file_descriptor_table* table = info->table;
+	g_fd id = optionalFd;
+	if(id == G_FD_NONE)
+	{
+		id = G_FILESYSTEM_PROCESS_FIRST_DESCRIPTOR;
+		while(id < table->capacity && table->descriptors[id])
+			++id;
 	}
-	descriptor->nodeId = nodeId;
+
+	if(id >= G_FD_MAX)
+	{
+		mutexRelease(&info->lock);
+		logInfo("%! process %i has no free file descriptors left", "filesystem", process->id);
+		return G_FS_OPEN_ERROR;
+	}
+
+	if(id >= table->capacity)
+	{
+		g_fd capacity = table->capacity * 2;
+		while(capacity <= id)
+			capacity *= 2;
+
+		g_file_descriptor_table* grown = filesystemProcessCreateTable(capacity, table);
+		if(!grown)
+		{
+			mutexRelease(&info->lock);
+			logInfo("%! failed to grow file descriptor table of process %i to %i entries", "filesystem", process->id, capacity);
+			return G_FS_OPEN_ERROR;
+		}
+		table = grown;
+		info->table = table;
+	}
+
+	g_file_descriptor* descriptor = table->descriptors[id];
+	if(!descriptor)
+		descriptor = (g_file_descriptor*) heapAllocate(sizeof(g_file_descriptor));
+
+	descriptor->id = id;
+	descriptor->nodeId = node->id;
+	descriptor->node = node;
 	descriptor->offset = 0;
 	descriptor->openFlags = flags;
+	table->descriptors[id] = descriptor;
+
+	mutexRelease(&info->lock);
 
-	hashmapPut<g_fd, g_file_descriptor*>(info->descriptors, descriptor->id, descriptor);
 	*outDescriptor = descriptor;
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
-g_file_descriptor* filesystemProcessGetDescriptor(g_pid pid, g_fd fd)
+g_file_descriptor* filesystemProcessGetDescriptor(g_process* process, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
-	{
-		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
 		return 0;
-	}
 
-	return hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
+	g_file_descriptor_table* table = info->table;
+	if(fd < 0 || fd >= table->capacity)
+		return 0;
+
+	return table->descriptors[fd];
 }
 
-void filesystemProcessRemove(g_pid pid)
+void filesystemProcessRemove(g_process* process)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 		return;
 
-	g_hashmap_iterator<g_fd, g_file_descriptor*> iter = hashmapIteratorStart<g_fd, g_file_descriptor*>(info->descriptors);
-	while(hashmapIteratorHasNext<g_fd, g_file_descriptor*>(&iter))
+	g_file_descriptor_table* table = info->table;
+	for(g_fd fd = 0; fd < table->capacity; fd++)
 	{
-		g_hashmap_entry<g_fd, g_file_descriptor*>* entry = hashmapIteratorNext<g_fd, g_file_descriptor*>(&iter);
-		filesystemClose(pid, entry->key, false);
-		heapFree(entry->value);
+		g_file_descriptor* descriptor = table->descriptors[fd];
+		if(descriptor)
+		{
+			filesystemClose(process, fd, false);
+			heapFree(descriptor);
+		}
 	}
-	hashmapIteratorEnd<g_fd, g_file_descriptor*>(&iter);
 
+	while(table)
+	{
+		g_file_descriptor_table* previous = table->previous;
+		heapFree(table->descriptors);
+		heapFree(table);
+		table = previous;
+	}
+
+	process->filesystem = 0;
 	heapFree(info);
-	hashmapRemove<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid);
 }
 
-void filesystemProcessRemoveDescriptor(g_pid pid, g_fd fd)
+void filesystemProcessRemoveDescriptor(g_process* process, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 		return;
 
-	g_file_descriptor* descriptor = hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
-	if(!descriptor)
-		return;
+	mutexAcquire(&info->lock);
+
+	g_file_descriptor_table* table = info->table;
+	g_file_descriptor* descriptor = 0;
+	if(fd >= 0 && fd < table->capacity)
+	{
+		descriptor = table->descriptors[fd];
+		table->descriptors[fd] = 0;
+	}
+
+	mutexRelease(&info->lock);
 
-	hashmapRemove(info->descriptors, fd);
-	heapFree(descriptor);
+	if(descriptor)
+		heapFree(descriptor);
 }
 
-g_file_descriptor* filesystemProcessCloneDescriptor(g_file_descriptor* sourceFd, g_pid targetPid, g_fd targetFd) {
+g_file_descriptor* filesystemProcessCloneDescriptor(g_file_descriptor* sourceFd, g_process* targetProcess, g_fd targetFd) {
 
 	if(targetFd != G_FD_NONE)
-		filesystemProcessRemoveDescriptor(targetPid, targetFd);
+		filesystemProcessRemoveDescriptor(targetProcess, targetFd);
 	
 	g_file_descriptor* createdFd;
-	g_fs_open_status status = filesystemProcessCreateDescriptor(targetPid, sourceFd->nodeId, sourceFd->openFlags, &createdFd, targetFd);
+	g_fs_open_status status = filesystemProcessCreateDescriptor(targetProcess, sourceFd->node, sourceFd->openFlags, &createdFd, targetFd);
 	if(status != G_FS_OPEN_SUCCESSFUL)
 	{
-		logInfo("%! failed to clone descriptor %i to process %i in descriptor %i with status %i", "filesystem", sourceFd->id, targetPid, targetFd, status);
+		logInfo("%! failed to clone descriptor %i to process %i in descriptor %i with status %i", "filesystem", sourceFd->id, targetProcess->id, targetFd, status);
 		return 0;
 	}
 
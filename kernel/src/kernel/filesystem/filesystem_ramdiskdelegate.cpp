@@ -66,17 +66,34 @@ g_fs_open_status filesystemRamdiskDelegateDiscover(g_fs_node* parent, const char
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
+g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDirectory(g_fs_node* folder)
+{
+	g_ramdisk_entry* folderEntry;
+
+	if(folder->type == G_FS_NODE_TYPE_MOUNTPOINT)
+		folderEntry = ramdiskGetRoot();
+	else
+		folderEntry = ramdiskFindById(folder->physicalId);
+
+	if(!folderEntry)
+		return G_FS_DIRECTORY_REFRESH_ERROR;
+
+	// Children that are already known are found in the dentry cache
+	for(uint32_t i = 0; i < folderEntry->childCount; i++)
+	{
+		g_fs_node* child;
+		filesystemFindChild(folder, folderEntry->children[i]->name, &child);
+	}
+	return G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
+}
+
 g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
 {
 	g_ramdisk_entry* entry = ramdiskFindById(node->physicalId);
 	if(!entry)
 		return G_FS_READ_ERROR;
 
-	if(offset + length > entry->dataSize)
-		length = entry->dataSize - offset;
-
-	memoryCopy(buffer, &entry->data[offset], length);
-	*outRead = length;
+	*outRead = ramdiskReadData(entry, offset, buffer, length);
 	return G_FS_READ_SUCCESSFUL;
 }
 
@@ -91,8 +108,8 @@ g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffe
 	{
 		uint32_t buflen = entry->dataSize * 1.2;
 		uint8_t* new_buffer = (uint8_t*) heapAllocate(sizeof(uint8_t) * buflen);
-		memoryCopy(new_buffer, entry->data, entry->dataSize);
-		entry->data = new_buffer;
+		ramdiskReadData(entry, 0, new_buffer, entry->dataSize);
+		ramdiskReleaseBlocks(entry, new_buffer);
 		entry->notOnRdBufferLength = buflen;
 
 	} else if(entry->data == nullptr)
@@ -0,0 +1,591 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
+
+#include "kernel/memory/memory.hpp"
+#include "kernel/tasking/wait.hpp"
+#include "kernel/kernel.hpp"
+#include "shared/system/mutex.hpp"
+#include "shared/utils/string.hpp"
+
+static g_mutex filesystemTaskedLock;
+static g_fs_tasked_delegate* filesystemTaskedDelegates;
+
+void filesystemTaskedDelegateInitialize()
+{
+	mutexInitialize(&filesystemTaskedLock);
+	filesystemTaskedDelegates = 0;
+}
+
+/**
+ * Requests may only wait within kernel threads. Other callers, like the cleanup of a
+ * process, only post requests that need no answer.
+ */
+static bool filesystemTaskedCanWait()
+{
+	return taskingGetCurrentTask()->type == G_THREAD_TYPE_SYSCALL;
+}
+
+static g_fs_tasked_delegate* filesystemTaskedGet(g_fs_node* node)
+{
+	return (g_fs_tasked_delegate*) filesystemFindDelegate(node)->data;
+}
+
+/**
+ * Maps pages of the kernel or the current address space into the driver. The range
+ * is weak so that the driver can not free the pages. Must hold the delegate lock.
+ */
+static g_virtual_address filesystemTaskedMapIntoDriver(g_fs_tasked_delegate* tasked, g_physical_address* physical, uint32_t pages)
+{
+	g_virtual_address mapping = addressRangePoolAllocate(tasked->process->virtualRangePool, pages, G_PROC_VIRTUAL_RANGE_FLAG_WEAK);
+	if(!mapping)
+		return 0;
+
+	g_physical_address back = taskingTemporarySwitchToSpace(tasked->process->pageDirectory);
+	for(uint32_t i = 0; i < pages; i++)
+		pagingMapPage(mapping + i * G_PAGE_SIZE, physical[i], DEFAULT_USER_TABLE_FLAGS, DEFAULT_USER_PAGE_FLAGS);
+	taskingTemporarySwitchBack(back);
+	return mapping;
+}
+
+/**
+ * Removes a mapping from the driver. Must hold the delegate lock.
+ */
+static void filesystemTaskedUnmapFromDriver(g_fs_tasked_delegate* tasked, g_virtual_address mapping, uint32_t pages)
+{
+	g_physical_address back = taskingTemporarySwitchToSpace(tasked->process->pageDirectory);
+	for(uint32_t i = 0; i < pages; i++)
+		pagingUnmapPage(mapping + i * G_PAGE_SIZE);
+	taskingTemporarySwitchBack(back);
+
+	addressRangePoolFree(tasked->process->virtualRangePool, mapping);
+}
+
+/**
+ * Frees the ring once the driver has exited and no request uses it anymore. Must hold
+ * the delegate lock.
+ */
+static void filesystemTaskedFreeRingIfUnused(g_fs_tasked_delegate* tasked)
+{
+	if(tasked->process || !tasked->ring)
+		return;
+
+	for(int i = 0; i < G_FS_TASKED_DELEGATE_REQUESTS; i++)
+	{
+		if(tasked->slots[i].used)
+			return;
+	}
+
+	memoryFreeKernelRange((g_virtual_address) tasked->ring);
+	tasked->ring = 0;
+}
+
+/**
+ * Takes a free request slot. Detached requests that were completed are released on
+ * the way. If all slots are in use, waits if possible.
+ *
+ * @return the slot index or -1 if the driver is gone or no slot is available
+ */
+static int filesystemTaskedAcquire(g_fs_tasked_delegate* tasked)
+{
+	for(;;)
+	{
+		mutexAcquire(&tasked->lock);
+		if(!tasked->process)
+		{
+			mutexRelease(&tasked->lock);
+			return -1;
+		}
+
+		for(int i = 0; i < G_FS_TASKED_DELEGATE_REQUESTS; i++)
+		{
+			g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+			g_fs_tasked_delegate_request* request = &tasked->ring->requests[i];
+			if(slot->used && slot->detached && request->completed)
+				slot->used = false;
+
+			if(!slot->used)
+			{
+				slot->used = true;
+				slot->detached = false;
+				slot->mapping = 0;
+				slot->mappingPages = 0;
+				memorySetBytes(request, 0, sizeof(g_fs_tasked_delegate_request));
+				mutexRelease(&tasked->lock);
+				return i;
+			}
+		}
+		mutexRelease(&tasked->lock);
+
+		if(!filesystemTaskedCanWait())
+			return -1;
+		taskingKernelThreadYield();
+	}
+}
+
+static void filesystemTaskedRelease(g_fs_tasked_delegate* tasked, int index)
+{
+	mutexAcquire(&tasked->lock);
+	g_fs_tasked_delegate_slot* slot = &tasked->slots[index];
+	if(slot->mapping && tasked->process)
+		filesystemTaskedUnmapFromDriver(tasked, slot->mapping, slot->mappingPages);
+	slot->mapping = 0;
+	slot->used = false;
+	filesystemTaskedFreeRingIfUnused(tasked);
+	mutexRelease(&tasked->lock);
+}
+
+/**
+ * Maps the pages of a buffer in the current address space into the driver and points
+ * the request to it, so that the driver reads or writes the buffer directly.
+ */
+static bool filesystemTaskedMapBuffer(g_fs_tasked_delegate* tasked, int index, uint8_t* buffer, uint64_t length)
+{
+	g_virtual_address start = G_PAGE_ALIGN_DOWN((g_virtual_address) buffer);
+	g_virtual_address end = G_PAGE_ALIGN_UP((g_virtual_address) buffer + (g_virtual_address) length);
+	uint32_t pages = (end - start) / G_PAGE_SIZE;
+
+	g_physical_address* physical = (g_physical_address*) heapAllocate(sizeof(g_physical_address) * pages);
+	if(!physical)
+		return false;
+
+	for(uint32_t i = 0; i < pages; i++)
+	{
+		physical[i] = pagingVirtualToPhysical(start + i * G_PAGE_SIZE);
+		if(!physical[i])
+		{
+			heapFree(physical);
+			return false;
+		}
+	}
+
+	mutexAcquire(&tasked->lock);
+	g_virtual_address mapping = tasked->process ? filesystemTaskedMapIntoDriver(tasked, physical, pages) : 0;
+	if(mapping)
+	{
+		tasked->slots[index].mapping = mapping;
+		tasked->slots[index].mappingPages = pages;
+		tasked->ring->requests[index].buffer = (void*) (mapping + ((g_virtual_address) buffer - start));
+	}
+	mutexRelease(&tasked->lock);
+
+	heapFree(physical);
+	return mapping != 0;
+}
+
+/**
+ * Posts a request to the ring and wakes the driver if it is waiting.
+ */
+static void filesystemTaskedPost(g_fs_tasked_delegate* tasked, int index)
+{
+	mutexAcquire(&tasked->lock);
+	g_fs_tasked_delegate_ring* ring = tasked->ring;
+
+	uint32_t head = ring->head;
+	ring->queue[head % G_FS_TASKED_DELEGATE_REQUESTS] = index;
+	__sync_synchronize();
+	ring->head = head + 1;
+	__sync_synchronize();
+
+	if(ring->driver_waiting)
+		ring->driver_waiting = false;
+	mutexRelease(&tasked->lock);
+}
+
+/**
+ * Posts a request and waits until the driver completed it.
+ *
+ * @return whether the request was completed by the driver
+ */
+static bool filesystemTaskedSubmit(g_fs_tasked_delegate* tasked, int index)
+{
+	g_fs_tasked_delegate_request* request = &tasked->ring->requests[index];
+	filesystemTaskedPost(tasked, index);
+
+	g_task* task = taskingGetCurrentTask();
+	while(!request->completed)
+	{
+		waitForDelegateRequest(task, &request->completed);
+		taskingKernelThreadYield();
+	}
+	__sync_synchronize();
+	return tasked->process != 0;
+}
+
+/**
+ * Prepares a request on the given node, see filesystemTaskedAcquire.
+ */
+static g_fs_tasked_delegate_request* filesystemTaskedPrepare(g_fs_tasked_delegate* tasked, int* outIndex, g_fs_tasked_delegate_request_type type,
+		g_fs_node* node, const char* name = 0)
+{
+	if(name && stringLength(name) >= G_FILENAME_MAX)
+		return 0;
+
+	int index = filesystemTaskedAcquire(tasked);
+	if(index == -1)
+		return 0;
+
+	g_fs_tasked_delegate_request* request = &tasked->ring->requests[index];
+	request->type = type;
+	request->phys_fs_id = node->physicalId;
+	request->virt_fs_id = node->id;
+	if(name)
+		stringCopy(request->name, name);
+
+	*outIndex = index;
+	return request;
+}
+
+g_fs_register_as_delegate_status filesystemTaskedDelegateRegister(g_task* task, const char* name, g_fs_phys_id physMountpointId,
+		g_fs_virt_id* outMountpointId, g_fs_tasked_delegate_ring** outRing)
+{
+	g_fs_node* mountFolder = filesystemGetMountFolder();
+	g_fs_node* existing;
+	if(stringLength(name) >= G_FILENAME_MAX || filesystemFindChild(mountFolder, name, &existing) != G_FS_OPEN_NOT_FOUND)
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_EXISTING;
+
+	g_fs_tasked_delegate* tasked = (g_fs_tasked_delegate*) heapAllocateClear(sizeof(g_fs_tasked_delegate));
+	if(!tasked)
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	mutexInitialize(&tasked->lock);
+
+	tasked->ringPages = G_PAGE_ALIGN_UP(sizeof(g_fs_tasked_delegate_ring)) / G_PAGE_SIZE;
+	tasked->ring = (g_fs_tasked_delegate_ring*) memoryAllocateKernelRange(tasked->ringPages);
+	if(!tasked->ring)
+	{
+		heapFree(tasked);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+
+	g_physical_address* physical = (g_physical_address*) heapAllocate(sizeof(g_physical_address) * tasked->ringPages);
+	for(uint32_t i = 0; i < tasked->ringPages; i++)
+		physical[i] = pagingVirtualToPhysical((g_virtual_address) tasked->ring + i * G_PAGE_SIZE);
+
+	tasked->process = task->process;
+	tasked->ringMapping = filesystemTaskedMapIntoDriver(tasked, physical, tasked->ringPages);
+	heapFree(physical);
+	if(!tasked->ringMapping)
+	{
+		memoryFreeKernelRange((g_virtual_address) tasked->ring);
+		heapFree(tasked);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+
+	g_fs_delegate* delegate = filesystemCreateDelegate();
+	delegate->cached = true;
+	delegate->threaded = true;
+	delegate->data = tasked;
+	delegate->open = filesystemTaskedDelegateOpen;
+	delegate->discover = filesystemTaskedDelegateDiscover;
+	delegate->read = filesystemTaskedDelegateRead;
+	delegate->write = filesystemTaskedDelegateWrite;
+	delegate->truncate = filesystemTaskedDelegateTruncate;
+	delegate->create = filesystemTaskedDelegateCreate;
+	delegate->getLength = filesystemTaskedDelegateGetLength;
+	delegate->close = filesystemTaskedDelegateClose;
+	tasked->delegate = delegate;
+
+	mutexAcquire(&filesystemTaskedLock);
+	tasked->next = filesystemTaskedDelegates;
+	filesystemTaskedDelegates = tasked;
+	mutexRelease(&filesystemTaskedLock);
+
+	g_fs_node* mountpoint = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, name);
+	mountpoint->physicalId = physMountpointId;
+	mountpoint->delegate = delegate;
+	filesystemAddChild(mountFolder, mountpoint);
+
+	*outMountpointId = mountpoint->id;
+	*outRing = (g_fs_tasked_delegate_ring*) tasked->ringMapping;
+	return G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL;
+}
+
+g_fs_create_node_status filesystemTaskedDelegateCreateNode(g_task* task, g_fs_virt_id parentId, const char* name, g_fs_node_type type,
+		g_fs_phys_id physicalId, g_fs_virt_id* outCreatedId)
+{
+	g_fs_node* parent = filesystemGetNode(parentId);
+	if(!parent || stringLength(name) >= G_FILENAME_MAX)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(parent);
+	g_fs_tasked_delegate* tasked = (g_fs_tasked_delegate*) delegate->data;
+	if(delegate->open != filesystemTaskedDelegateOpen || tasked->process != task->process)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	// The children are searched directly, discovery would ask the calling driver
+	g_fs_node* existing = 0;
+	mutexAcquire(&delegate->lock);
+	for(g_fs_node_entry* entry = parent->children; entry; entry = entry->next)
+	{
+		if(stringEquals(entry->node->name, name))
+		{
+			existing = entry->node;
+			break;
+		}
+	}
+	mutexRelease(&delegate->lock);
+
+	if(existing)
+	{
+		existing->type = type;
+		existing->physicalId = physicalId;
+		*outCreatedId = existing->id;
+		return G_FS_CREATE_NODE_STATUS_UPDATED;
+	}
+
+	g_fs_node* node = filesystemCreateNode(type, name);
+	node->physicalId = physicalId;
+	filesystemAddChild(parent, node);
+	*outCreatedId = node->id;
+	return G_FS_CREATE_NODE_STATUS_CREATED;
+}
+
+void filesystemTaskedDelegateProcessRemoved(g_process* process)
+{
+	mutexAcquire(&filesystemTaskedLock);
+	for(g_fs_tasked_delegate* tasked = filesystemTaskedDelegates; tasked; tasked = tasked->next)
+	{
+		if(tasked->process != process)
+			continue;
+
+		mutexAcquire(&tasked->lock);
+
+		// Remove all mappings before the address space is cleaned up
+		for(int i = 0; i < G_FS_TASKED_DELEGATE_REQUESTS; i++)
+		{
+			g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+			if(!slot->used)
+				continue;
+
+			if(slot->mapping)
+				filesystemTaskedUnmapFromDriver(tasked, slot->mapping, slot->mappingPages);
+			slot->mapping = 0;
+
+			if(slot->detached)
+				slot->used = false;
+			else
+				tasked->ring->requests[i].completed = true;
+		}
+		filesystemTaskedUnmapFromDriver(tasked, tasked->ringMapping, tasked->ringPages);
+		tasked->ringMapping = 0;
+
+		tasked->process = 0;
+		filesystemTaskedFreeRingIfUnused(tasked);
+		mutexRelease(&tasked->lock);
+	}
+	mutexRelease(&filesystemTaskedLock);
+}
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(node);
+	if(!filesystemTaskedCanWait())
+		return G_FS_OPEN_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN, node, node->name);
+	if(!request)
+		return G_FS_OPEN_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(filesystemTaskedSubmit(tasked, index))
+		status = request->result_status;
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(node);
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE, node);
+	if(!request)
+		return G_FS_CLOSE_ERROR;
+
+	// Closing when a process is removed can not wait for the driver
+	if(!filesystemTaskedCanWait())
+	{
+		mutexAcquire(&tasked->lock);
+		tasked->slots[index].detached = true;
+		mutexRelease(&tasked->lock);
+
+		filesystemTaskedPost(tasked, index);
+		return G_FS_CLOSE_SUCCESSFUL;
+	}
+
+	g_fs_close_status status = G_FS_CLOSE_ERROR;
+	if(filesystemTaskedSubmit(tasked, index))
+		status = request->result_status;
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+/**
+ * Discovery and creation let the driver return the physical id and type of the node,
+ * which is then added to the tree.
+ */
+static g_fs_open_status filesystemTaskedFindOrCreate(g_fs_tasked_delegate_request_type type, g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(parent);
+	if(!filesystemTaskedCanWait())
+		return G_FS_OPEN_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, type, parent, name);
+	if(!request)
+		return G_FS_OPEN_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(filesystemTaskedSubmit(tasked, index))
+	{
+		if(request->result_status == G_FS_DISCOVERY_SUCCESSFUL)
+		{
+			g_fs_node* node = filesystemCreateNode(request->result_type, name);
+			node->physicalId = request->result_phys_fs_id;
+			filesystemAddChild(parent, node);
+			*outNode = node;
+			status = G_FS_OPEN_SUCCESSFUL;
+
+		} else if(request->result_status == G_FS_DISCOVERY_NOT_FOUND)
+		{
+			status = G_FS_OPEN_NOT_FOUND;
+		}
+	}
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	return filesystemTaskedFindOrCreate(G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER, parent, name, outNode);
+}
+
+g_fs_open_status filesystemTaskedDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile)
+{
+	return filesystemTaskedFindOrCreate(G_FS_TASKED_DELEGATE_REQUEST_TYPE_CREATE, parent, name, outFile);
+}
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(node);
+	if(!filesystemTaskedCanWait())
+		return G_FS_READ_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ, node);
+	if(!request)
+		return G_FS_READ_ERROR;
+
+	g_fs_read_status status = G_FS_READ_ERROR;
+	request->offset = offset;
+	request->length = length;
+	if(filesystemTaskedMapBuffer(tasked, index, buffer, length) && filesystemTaskedSubmit(tasked, index))
+	{
+		// The request is writable by the driver, so the length is read only once
+		status = request->result_status;
+		int64_t resultLength = *((volatile int64_t*) &request->result_length);
+		if(status == G_FS_READ_SUCCESSFUL && resultLength < 0)
+			status = G_FS_READ_ERROR;
+		else if(status == G_FS_READ_SUCCESSFUL)
+			*outRead = resultLength > (int64_t) length ? length : resultLength;
+	}
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(node);
+	if(!filesystemTaskedCanWait())
+		return G_FS_WRITE_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE, node);
+	if(!request)
+		return G_FS_WRITE_ERROR;
+
+	g_fs_write_status status = G_FS_WRITE_ERROR;
+	request->offset = offset;
+	request->length = length;
+	if(filesystemTaskedMapBuffer(tasked, index, buffer, length) && filesystemTaskedSubmit(tasked, index))
+	{
+		// The request is writable by the driver, so the length is read only once
+		status = request->result_status;
+		int64_t resultLength = *((volatile int64_t*) &request->result_length);
+		if(status == G_FS_WRITE_SUCCESSFUL && resultLength < 0)
+			status = G_FS_WRITE_ERROR;
+		else if(status == G_FS_WRITE_SUCCESSFUL)
+			*outWrote = resultLength > (int64_t) length ? length : resultLength;
+	}
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(node);
+	if(!filesystemTaskedCanWait())
+		return G_FS_LENGTH_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH, node);
+	if(!request)
+		return G_FS_LENGTH_ERROR;
+
+	g_fs_length_status status = G_FS_LENGTH_ERROR;
+	if(filesystemTaskedSubmit(tasked, index))
+	{
+		status = request->result_status;
+		int64_t resultLength = *((volatile int64_t*) &request->result_length);
+		if(status == G_FS_LENGTH_SUCCESSFUL && resultLength < 0)
+			status = G_FS_LENGTH_ERROR;
+		else if(status == G_FS_LENGTH_SUCCESSFUL)
+			*outLength = resultLength;
+	}
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
+
+g_fs_open_status filesystemTaskedDelegateTruncate(g_fs_node* file)
+{
+	g_fs_tasked_delegate* tasked = filesystemTaskedGet(file);
+	if(!filesystemTaskedCanWait())
+		return G_FS_OPEN_BUSY;
+
+	int index;
+	g_fs_tasked_delegate_request* request = filesystemTaskedPrepare(tasked, &index, G_FS_TASKED_DELEGATE_REQUEST_TYPE_TRUNCATE, file);
+	if(!request)
+		return G_FS_OPEN_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(filesystemTaskedSubmit(tasked, index))
+		status = request->result_status;
+
+	filesystemTaskedRelease(tasked, index);
+	return status;
+}
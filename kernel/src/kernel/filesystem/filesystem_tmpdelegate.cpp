@@ -0,0 +1,353 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_tmpdelegate.hpp"
+
+#include "kernel/memory/memory.hpp"
+#include "kernel/utils/hashmap.hpp"
+#include "kernel/kernel.hpp"
+#include "shared/system/mutex.hpp"
+
+static g_mutex filesystemTmpLock;
+static g_hashmap<g_fs_phys_id, g_fs_tmp_file*>* filesystemTmpFiles;
+static g_fs_phys_id filesystemTmpNextId;
+
+void filesystemTmpDelegateInitialize()
+{
+	mutexInitialize(&filesystemTmpLock);
+	filesystemTmpFiles = hashmapCreateNumeric<g_fs_phys_id, g_fs_tmp_file*>(128);
+	filesystemTmpNextId = 1;
+}
+
+static void filesystemTmpFreePageTable(g_virtual_address* pages, uint32_t pageCapacity)
+{
+	for(uint32_t i = 0; i < pageCapacity; i++)
+	{
+		if(pages[i])
+			memoryFreeKernelPage(pages[i]);
+	}
+	if(pages)
+		heapFree(pages);
+}
+
+/**
+ * Drops the contents of a file. If the file is busy, the pages are retired until
+ * it is no longer. Must hold the tmpfs lock.
+ */
+static void filesystemTmpFreePages(g_fs_tmp_file* file)
+{
+	if(file->busy > 0 && file->pages)
+	{
+		g_fs_tmp_retired_pages* retired = (g_fs_tmp_retired_pages*) heapAllocate(sizeof(g_fs_tmp_retired_pages));
+		retired->pages = file->pages;
+		retired->pageCapacity = file->pageCapacity;
+		retired->next = file->retired;
+		file->retired = retired;
+	} else
+	{
+		filesystemTmpFreePageTable(file->pages, file->pageCapacity);
+	}
+
+	file->pages = 0;
+	file->pageCapacity = 0;
+	file->length = 0;
+}
+
+/**
+ * Frees a file once it was unlinked and is no longer open or busy.
+ */
+static void filesystemTmpFreeIfUnused(g_fs_tmp_file* file)
+{
+	if(!file->unlinked || file->openCount > 0 || file->busy > 0)
+		return;
+
+	filesystemTmpFreePages(file);
+	hashmapRemove<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, file->id);
+	heapFree(file);
+}
+
+/**
+ * Marks a file busy so that its pages stay valid while the lock is released.
+ * Must hold the tmpfs lock.
+ */
+static g_fs_tmp_file* filesystemTmpPin(g_fs_node* node)
+{
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+		file->busy++;
+	return file;
+}
+
+/**
+ * Ends a copy and frees what was retired or unlinked during it. Must hold the
+ * tmpfs lock.
+ */
+static void filesystemTmpUnpin(g_fs_tmp_file* file)
+{
+	file->busy--;
+	if(file->busy > 0)
+		return;
+
+	while(file->retired)
+	{
+		g_fs_tmp_retired_pages* retired = file->retired;
+		file->retired = retired->next;
+		filesystemTmpFreePageTable(retired->pages, retired->pageCapacity);
+		heapFree(retired);
+	}
+	filesystemTmpFreeIfUnused(file);
+}
+
+static bool filesystemTmpEnsurePageCapacity(g_fs_tmp_file* file, uint32_t pages)
+{
+	if(pages <= file->pageCapacity)
+		return true;
+
+	uint32_t capacity = file->pageCapacity < 8 ? 8 : file->pageCapacity;
+	while(capacity < pages)
+		capacity *= 2;
+
+	g_virtual_address* table = (g_virtual_address*) heapAllocateClear(sizeof(g_virtual_address) * capacity);
+	if(!table)
+		return false;
+
+	if(file->pages)
+	{
+		memoryCopy(table, file->pages, sizeof(g_virtual_address) * file->pageCapacity);
+		heapFree(file->pages);
+	}
+	file->pages = table;
+	file->pageCapacity = capacity;
+	return true;
+}
+
+g_fs_open_status filesystemTmpDelegateOpen(g_fs_node* node)
+{
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+		file->openCount++;
+	mutexRelease(&filesystemTmpLock);
+
+	return file ? G_FS_OPEN_SUCCESSFUL : G_FS_OPEN_ERROR;
+}
+
+g_fs_close_status filesystemTmpDelegateClose(g_fs_node* node)
+{
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+	{
+		file->openCount--;
+		filesystemTmpFreeIfUnused(file);
+	}
+	mutexRelease(&filesystemTmpLock);
+
+	return G_FS_CLOSE_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemTmpDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	// All files are added to the tree when they are created
+	*outNode = 0;
+	return G_FS_OPEN_NOT_FOUND;
+}
+
+g_fs_read_status filesystemTmpDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
+{
+	mutexAcquire(&filesystemTmpLock);
+
+	g_fs_tmp_file* file = filesystemTmpPin(node);
+	if(!file)
+	{
+		mutexRelease(&filesystemTmpLock);
+		return G_FS_READ_ERROR;
+	}
+
+	if(offset >= file->length)
+		length = 0;
+	else if(length > file->length - offset)
+		length = file->length - offset;
+
+	mutexRelease(&filesystemTmpLock);
+
+	uint64_t done = 0;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t pageIndex = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+
+		uint32_t chunk = G_PAGE_SIZE - pageOffset;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		mutexAcquire(&filesystemTmpLock);
+		g_virtual_address page = pageIndex < file->pageCapacity ? file->pages[pageIndex] : 0;
+		mutexRelease(&filesystemTmpLock);
+
+		if(page)
+			memoryCopy(&buffer[done], (uint8_t*) (page + pageOffset), chunk);
+		else
+			memorySetBytes(&buffer[done], 0, chunk);
+		done += chunk;
+	}
+
+	mutexAcquire(&filesystemTmpLock);
+	filesystemTmpUnpin(file);
+	mutexRelease(&filesystemTmpLock);
+
+	*outRead = done;
+	return G_FS_READ_SUCCESSFUL;
+}
+
+/**
+ * Returns the page at the index, allocating it if it is a hole. The page is
+ * allocated without holding the lock. Must hold the tmpfs lock.
+ */
+static g_virtual_address filesystemTmpGetOrCreatePage(g_fs_tmp_file* file, uint32_t pageIndex)
+{
+	if(!filesystemTmpEnsurePageCapacity(file, pageIndex + 1))
+		return 0;
+	if(file->pages[pageIndex])
+		return file->pages[pageIndex];
+
+	mutexRelease(&filesystemTmpLock);
+	g_virtual_address created = memoryAllocateKernelPage();
+	mutexAcquire(&filesystemTmpLock);
+	if(!created)
+		return 0;
+
+	// The page table might have changed meanwhile
+	if(!filesystemTmpEnsurePageCapacity(file, pageIndex + 1))
+	{
+		memoryFreeKernelPage(created);
+		return 0;
+	}
+	if(file->pages[pageIndex])
+	{
+		memoryFreeKernelPage(created);
+		return file->pages[pageIndex];
+	}
+	file->pages[pageIndex] = created;
+	return created;
+}
+
+g_fs_write_status filesystemTmpDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	// Page indexes are 32 bit
+	if(offset + length > 0xFFFFFFFF)
+		return G_FS_WRITE_ERROR;
+
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = filesystemTmpPin(node);
+	mutexRelease(&filesystemTmpLock);
+	if(!file)
+		return G_FS_WRITE_ERROR;
+
+	uint64_t done = 0;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t pageIndex = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+
+		mutexAcquire(&filesystemTmpLock);
+		g_virtual_address page = filesystemTmpGetOrCreatePage(file, pageIndex);
+		mutexRelease(&filesystemTmpLock);
+		if(!page)
+		{
+			logInfo("%! out of memory while writing to file %i", "tmpfs", node->id);
+			break;
+		}
+
+		uint32_t chunk = G_PAGE_SIZE - pageOffset;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		memoryCopy((uint8_t*) (page + pageOffset), &buffer[done], chunk);
+		done += chunk;
+	}
+
+	mutexAcquire(&filesystemTmpLock);
+	if(offset + done > file->length)
+		file->length = offset + done;
+	filesystemTmpUnpin(file);
+	mutexRelease(&filesystemTmpLock);
+
+	if(done == 0 && length > 0)
+		return G_FS_WRITE_ERROR;
+
+	*outWrote = done;
+	return G_FS_WRITE_SUCCESSFUL;
+}
+
+g_fs_length_status filesystemTmpDelegateGetLength(g_fs_node* node, uint64_t* outLength)
+{
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+		*outLength = file->length;
+	mutexRelease(&filesystemTmpLock);
+
+	return file ? G_FS_LENGTH_SUCCESSFUL : G_FS_LENGTH_ERROR;
+}
+
+g_fs_open_status filesystemTmpDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile)
+{
+	g_fs_tmp_file* file = (g_fs_tmp_file*) heapAllocateClear(sizeof(g_fs_tmp_file));
+
+	mutexAcquire(&filesystemTmpLock);
+	file->id = filesystemTmpNextId++;
+	hashmapPut<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, file->id, file);
+	mutexRelease(&filesystemTmpLock);
+
+	g_fs_node* newNode = filesystemCreateNode(G_FS_NODE_TYPE_FILE, name);
+	newNode->physicalId = file->id;
+	filesystemAddChild(parent, newNode);
+	*outFile = newNode;
+
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemTmpDelegateTruncate(g_fs_node* node)
+{
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+		filesystemTmpFreePages(file);
+	mutexRelease(&filesystemTmpLock);
+
+	return file ? G_FS_OPEN_SUCCESSFUL : G_FS_OPEN_ERROR;
+}
+
+g_fs_unlink_status filesystemTmpDelegateUnlink(g_fs_node* node)
+{
+	mutexAcquire(&filesystemTmpLock);
+	g_fs_tmp_file* file = hashmapGet<g_fs_phys_id, g_fs_tmp_file*>(filesystemTmpFiles, node->physicalId, 0);
+	if(file)
+	{
+		file->unlinked = true;
+		filesystemTmpFreeIfUnused(file);
+	}
+	mutexRelease(&filesystemTmpLock);
+
+	return file ? G_FS_UNLINK_SUCCESSFUL : G_FS_UNLINK_NOT_FOUND;
+}
@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/filesystem/ramdisk.hpp"
+#include "kernel/filesystem/ramdisk_compression.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/paging.hpp"
 #include "kernel/kernel.hpp"
@@ -26,9 +27,91 @@
 #include "shared/utils/string.hpp"
 #include "shared/memory/memory.hpp"
 #include "kernel/memory/heap.hpp"
+#include "kernel/utils/hashmap_string.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Maximum number of decompressed blocks that are kept, blocks that are pinned
+ * by readers are not counted against this limit.
+ */
+#define G_RAMDISK_MAXIMUM_CACHED_BLOCKS	256
 
 g_ramdisk* ramdiskMain = 0;
 
+// protects the block tables and the block LRU list, most recently used first
+static g_mutex ramdiskBlockLock;
+static g_ramdisk_block* ramdiskBlockLruFirst = 0;
+static g_ramdisk_block* ramdiskBlockLruLast = 0;
+static uint32_t ramdiskBlockCount = 0;
+
+/**
+ * Names in the child maps belong to the entries, so keys are not copied.
+ */
+static const char* ramdiskChildKeyCopy(const char* key)
+{
+	return key;
+}
+
+static void ramdiskChildKeyFree(const char* key)
+{
+}
+
+static void ramdiskInitializeChildren(g_ramdisk_entry* folder, uint32_t capacity)
+{
+	folder->childCount = 0;
+	folder->childCapacity = capacity;
+	folder->children = capacity > 0 ? (g_ramdisk_entry**) heapAllocate(sizeof(g_ramdisk_entry*) * capacity) : 0;
+
+	folder->childrenByName = hashmapInternalCreate<const char*, g_ramdisk_entry*>(capacity < 8 ? 8 : capacity);
+	folder->childrenByName->keyCopy = ramdiskChildKeyCopy;
+	folder->childrenByName->keyHash = hashmapKeyHashString;
+	folder->childrenByName->keyFree = ramdiskChildKeyFree;
+	folder->childrenByName->keyEquals = hashmapKeyEqualsString;
+}
+
+static void ramdiskAddChild(g_ramdisk_entry* folder, g_ramdisk_entry* child)
+{
+	if(!folder->childrenByName)
+		ramdiskInitializeChildren(folder, 0);
+
+	if(folder->childCount == folder->childCapacity)
+	{
+		uint32_t capacity = folder->childCapacity < 8 ? 8 : folder->childCapacity * 2;
+		g_ramdisk_entry** children = (g_ramdisk_entry**) heapAllocate(sizeof(g_ramdisk_entry*) * capacity);
+		if(folder->children)
+		{
+			memoryCopy(children, folder->children, sizeof(g_ramdisk_entry*) * folder->childCount);
+			heapFree(folder->children);
+		}
+		folder->children = children;
+		folder->childCapacity = capacity;
+	}
+
+	folder->children[folder->childCount++] = child;
+	hashmapPut<const char*, g_ramdisk_entry*>(folder->childrenByName, child->name, child);
+}
+
+static void ramdiskIndexEntry(g_ramdisk_entry* entry)
+{
+	if(entry->id >= ramdiskMain->entriesCapacity)
+	{
+		uint32_t capacity = ramdiskMain->entriesCapacity * 2;
+		if(capacity <= entry->id)
+			capacity = entry->id + 1;
+
+		g_ramdisk_entry** entries = (g_ramdisk_entry**) heapAllocateClear(sizeof(g_ramdisk_entry*) * capacity);
+		if(ramdiskMain->entries)
+		{
+			memoryCopy(entries, ramdiskMain->entries, sizeof(g_ramdisk_entry*) * ramdiskMain->entriesCapacity);
+			heapFree(ramdiskMain->entries);
+		}
+		ramdiskMain->entries = entries;
+		ramdiskMain->entriesCapacity = capacity;
+	}
+
+	ramdiskMain->entries[entry->id] = entry;
+}
+
 void ramdiskLoadFromModule(g_multiboot_module* module)
 {
 	if(ramdiskMain)
@@ -55,16 +138,15 @@ void ramdiskLoadFromModule(g_multiboot_module* module)
 	logDebug("%! relocated to kernel space: %h -> %h", "ramdisk", module->moduleStart, G_PAGE_ALIGN_UP(module->moduleEnd));
 }
 
-void ramdiskParseContents(g_multiboot_module* module)
+/**
+ * Parses the original format, a sequential stream of entries with the file
+ * contents directly following each entry.
+ */
+static void ramdiskParseLegacy(g_multiboot_module* module)
 {
 	uint8_t* data = (uint8_t*) module->moduleStart;
 	g_address dataEnd = module->moduleEnd;
 
-	ramdiskMain->root = new g_ramdisk_entry;
-	ramdiskMain->root->id = 0;
-	ramdiskMain->firstEntry = 0;
-	ramdiskMain->nextUnusedId = 0;
-
 	uint32_t pos = 0;
 	g_ramdisk_entry* currentHeader = 0;
 	while((g_address) (data + pos) < dataEnd)
@@ -125,52 +207,159 @@ void ramdiskParseContents(g_multiboot_module* module)
 			entry->dataSize = 0;
 			entry->data = 0;
 		}
-
-		// start with unused ids after the last one
-		if(entry->id > ramdiskMain->nextUnusedId)
-		{
-			ramdiskMain->nextUnusedId = entry->id + 1;
-		}
+		entry->compressed = false;
+		entry->storedData = 0;
+		entry->blocks = 0;
+
+		entry->childCount = 0;
+		entry->childCapacity = 0;
+		entry->children = 0;
+		entry->childrenByName = 0;
 	}
 }
 
-g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName)
+/**
+ * Parses the indexed format. Only the entry table is read, names are used in place
+ * and file contents are page-aligned within the image.
+ */
+static void ramdiskParseIndexed(g_multiboot_module* module)
 {
+	uint8_t* data = (uint8_t*) module->moduleStart;
+	g_ramdisk_header* header = (g_ramdisk_header*) data;
+	bool compressedFormat = header->version == G_RAMDISK_FORMAT_VERSION_COMPRESSED;
+	if(header->version != G_RAMDISK_FORMAT_VERSION && !compressedFormat)
+		kernelPanic("%! unsupported format version %i", "ramdisk", header->version);
+
+	uint32_t tableEntrySize = compressedFormat ? sizeof(g_ramdisk_compressed_table_entry) : sizeof(g_ramdisk_table_entry);
+	uint8_t* table = data + sizeof(g_ramdisk_header);
+	char* names = (char*) (data + header->namesOffset);
 
-	g_ramdisk_entry* current = ramdiskMain->firstEntry;
-	while(current)
+	uint32_t storedTotal = 0;
+	uint32_t compressedTotal = 0;
+
+	g_ramdisk_entry* entries = new g_ramdisk_entry[header->entryCount];
+	for(uint32_t i = 0; i < header->entryCount; i++)
 	{
-		if(current->parentid == parent->id && stringEquals(current->name, childName))
-			return current;
+		g_ramdisk_table_entry* tableEntry = (g_ramdisk_table_entry*) (table + i * tableEntrySize);
+
+		g_ramdisk_entry* entry = &entries[i];
+		entry->next = i + 1 < header->entryCount ? &entries[i + 1] : 0;
+		entry->type = tableEntry->type;
+		entry->id = tableEntry->id;
+		entry->parentid = tableEntry->parentId;
+		entry->name = &names[tableEntry->nameOffset];
 
-		current = current->next;
+		entry->dataOnRamdisk = true;
+		entry->dataSize = tableEntry->dataLength;
+		entry->data = entry->type == G_RAMDISK_ENTRY_TYPE_FILE ? data + tableEntry->dataOffset : 0;
+
+		entry->compressed = false;
+		entry->storedData = 0;
+		entry->blocks = 0;
+		if(compressedFormat && entry->type == G_RAMDISK_ENTRY_TYPE_FILE &&
+		   (((g_ramdisk_compressed_table_entry*) tableEntry)->flags & G_RAMDISK_ENTRY_FLAG_COMPRESSED))
+		{
+			entry->compressed = true;
+			entry->storedData = entry->data;
+			entry->data = 0;
+			entry->blocks = (g_ramdisk_block**) heapAllocateClear(sizeof(g_ramdisk_block*) * G_RAMDISK_BLOCK_COUNT(entry->dataSize));
+
+			storedTotal += ((g_ramdisk_compressed_table_entry*) tableEntry)->storedLength;
+			compressedTotal += entry->dataSize;
+		}
+
+		entry->childCount = 0;
+		entry->childCapacity = 0;
+		entry->children = 0;
+		entry->childrenByName = 0;
 	}
+	ramdiskMain->firstEntry = header->entryCount > 0 ? entries : 0;
 
-	return 0;
+	if(compressedTotal > 0)
+		logDebug("%! %i KB of compressed files stored in %i KB", "ramdisk", compressedTotal / 1024, storedTotal / 1024);
 }
 
-g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
+void ramdiskParseContents(g_multiboot_module* module)
 {
-	g_ramdisk_entry* foundNode = 0;
+	mutexInitialize(&ramdiskBlockLock);
 
-	if(id == 0)
+	ramdiskMain->root = new g_ramdisk_entry;
+	ramdiskMain->root->id = 0;
+	ramdiskMain->root->parentid = 0;
+	ramdiskMain->root->type = G_RAMDISK_ENTRY_TYPE_FOLDER;
+	ramdiskMain->root->name = (char*) "";
+	ramdiskMain->root->childCount = 0;
+	ramdiskMain->root->childCapacity = 0;
+	ramdiskMain->root->children = 0;
+	ramdiskMain->root->childrenByName = 0;
+	ramdiskMain->root->compressed = false;
+	ramdiskMain->root->storedData = 0;
+	ramdiskMain->root->blocks = 0;
+	ramdiskMain->firstEntry = 0;
+	ramdiskMain->nextUnusedId = 1;
+	ramdiskMain->entries = 0;
+	ramdiskMain->entriesCapacity = 0;
+	ramdiskIndexEntry(ramdiskMain->root);
+
+	g_ramdisk_header* header = (g_ramdisk_header*) module->moduleStart;
+	if(module->moduleEnd - module->moduleStart >= sizeof(g_ramdisk_header) &&
+	   header->magic[0] == G_RAMDISK_MAGIC_0 && header->magic[1] == G_RAMDISK_MAGIC_1 &&
+	   header->magic[2] == G_RAMDISK_MAGIC_2 && header->magic[3] == G_RAMDISK_MAGIC_3)
 	{
-		return ramdiskMain->root;
+		ramdiskParseIndexed(module);
+	} else
+	{
+		ramdiskParseLegacy(module);
 	}
 
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode != 0)
+	// Index all entries and start with unused ids after the last one
+	g_ramdisk_entry* entry;
+	for(entry = ramdiskMain->firstEntry; entry; entry = entry->next)
 	{
-		if(currentNode->id == id)
-		{
-			foundNode = currentNode;
-			break;
-		}
+		ramdiskIndexEntry(entry);
+		if(entry->id >= ramdiskMain->nextUnusedId)
+			ramdiskMain->nextUnusedId = entry->id + 1;
+	}
 
-		currentNode = currentNode->next;
+	// Count children first so each table is allocated once with the right size
+	for(entry = ramdiskMain->firstEntry; entry; entry = entry->next)
+	{
+		g_ramdisk_entry* parent = ramdiskFindById(entry->parentid);
+		if(parent)
+			parent->childCapacity++;
+	}
+
+	ramdiskInitializeChildren(ramdiskMain->root, ramdiskMain->root->childCapacity);
+	for(entry = ramdiskMain->firstEntry; entry; entry = entry->next)
+	{
+		if(entry->type == G_RAMDISK_ENTRY_TYPE_FOLDER)
+			ramdiskInitializeChildren(entry, entry->childCapacity);
 	}
 
-	return foundNode;
+	for(entry = ramdiskMain->firstEntry; entry; entry = entry->next)
+	{
+		g_ramdisk_entry* parent = ramdiskFindById(entry->parentid);
+		if(parent && parent->childrenByName)
+			ramdiskAddChild(parent, entry);
+		else
+			logInfo("%! entry %i has no valid parent %i", "ramdisk", entry->id, entry->parentid);
+	}
+}
+
+g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName)
+{
+	if(!parent->childrenByName)
+		return 0;
+
+	return hashmapGet<const char*, g_ramdisk_entry*>(parent->childrenByName, childName, 0);
+}
+
+g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
+{
+	if(id >= ramdiskMain->entriesCapacity)
+		return 0;
+
+	return ramdiskMain->entries[id];
 }
 
 g_ramdisk_entry* ramdiskFindAbsolute(const char* path)
@@ -214,39 +403,231 @@ g_ramdisk_entry* ramdiskFindRelative(g_ramdisk_entry* node, const char* path)
 
 uint32_t ramdiskGetChildCount(g_ramdisk_id id)
 {
-	uint32_t count = 0;
+	g_ramdisk_entry* entry = ramdiskFindById(id);
+	if(!entry)
+		return 0;
+
+	return entry->childCount;
+}
+
+g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index)
+{
+	g_ramdisk_entry* entry = ramdiskFindById(id);
+	if(!entry || index >= entry->childCount)
+		return 0;
+
+	return entry->children[index];
+}
+
+static void ramdiskBlockLruRemove(g_ramdisk_block* block)
+{
+	if(block->lruPrevious)
+		block->lruPrevious->lruNext = block->lruNext;
+	else
+		ramdiskBlockLruFirst = block->lruNext;
+
+	if(block->lruNext)
+		block->lruNext->lruPrevious = block->lruPrevious;
+	else
+		ramdiskBlockLruLast = block->lruPrevious;
+}
+
+static void ramdiskBlockLruPushFront(g_ramdisk_block* block)
+{
+	block->lruPrevious = 0;
+	block->lruNext = ramdiskBlockLruFirst;
+	if(ramdiskBlockLruFirst)
+		ramdiskBlockLruFirst->lruPrevious = block;
+	else
+		ramdiskBlockLruLast = block;
+	ramdiskBlockLruFirst = block;
+}
+
+static void ramdiskBlockFree(g_ramdisk_block* block)
+{
+	heapFree(block->data);
+	heapFree(block);
+}
+
+/**
+ * Takes a block out of its entry's table and the LRU list. The block is freed
+ * once it is no longer pinned. Must hold the block lock.
+ */
+static void ramdiskBlockUncache(g_ramdisk_block* block)
+{
+	block->entry->blocks[block->index] = 0;
+	ramdiskBlockLruRemove(block);
+	block->cached = false;
+	ramdiskBlockCount--;
+
+	if(block->references == 0)
+		ramdiskBlockFree(block);
+}
+
+/**
+ * Evicts unpinned blocks from the end of the LRU list until the number of
+ * cached blocks is within its limit. Must hold the block lock.
+ */
+static void ramdiskBlockEvict()
+{
+	g_ramdisk_block* block = ramdiskBlockLruLast;
+	while(block && ramdiskBlockCount > G_RAMDISK_MAXIMUM_CACHED_BLOCKS)
+	{
+		g_ramdisk_block* previous = block->lruPrevious;
+		if(block->references == 0)
+			ramdiskBlockUncache(block);
+		block = previous;
+	}
+}
+
+/**
+ * Returns the decompressed block at "index" of a compressed file and pins it, the
+ * caller must unpin it once it finished copying. Decompression happens without
+ * holding the block lock. Returns null if the file is no longer compressed or the
+ * block is corrupted.
+ */
+static g_ramdisk_block* ramdiskPinBlock(g_ramdisk_entry* entry, uint32_t index)
+{
+	mutexAcquire(&ramdiskBlockLock);
+	if(!entry->compressed)
+	{
+		mutexRelease(&ramdiskBlockLock);
+		return 0;
+	}
 
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode != 0)
+	g_ramdisk_block* block = entry->blocks[index];
+	if(block)
 	{
-		if(currentNode->parentid == id)
+		block->references++;
+		if(ramdiskBlockLruFirst != block)
 		{
-			++count;
+			ramdiskBlockLruRemove(block);
+			ramdiskBlockLruPushFront(block);
 		}
-		currentNode = currentNode->next;
+		mutexRelease(&ramdiskBlockLock);
+		return block;
+	}
+
+	// The stored contents stay in the image, so they can be read without the lock
+	uint32_t* offsets = (uint32_t*) entry->storedData;
+	uint8_t* stored = entry->storedData + offsets[index];
+	uint32_t storedLength = offsets[index + 1] - offsets[index];
+	mutexRelease(&ramdiskBlockLock);
+
+	uint32_t blockLength = entry->dataSize - index * G_RAMDISK_BLOCK_SIZE;
+	if(blockLength > G_RAMDISK_BLOCK_SIZE)
+		blockLength = G_RAMDISK_BLOCK_SIZE;
+
+	uint8_t* data = (uint8_t*) heapAllocate(blockLength);
+	if(storedLength == blockLength)
+	{
+		memoryCopy(data, stored, blockLength);
+	} else if(ramdiskDecompressBlock(stored, storedLength, data, blockLength) != (int32_t) blockLength)
+	{
+		logInfo("%! block %i of entry %i is corrupted", "ramdisk", index, entry->id);
+		heapFree(data);
+		return 0;
 	}
 
-	return count;
+	block = (g_ramdisk_block*) heapAllocate(sizeof(g_ramdisk_block));
+	block->entry = entry;
+	block->index = index;
+	block->data = data;
+	block->references = 1;
+	block->cached = false;
+
+	mutexAcquire(&ramdiskBlockLock);
+	if(entry->compressed)
+	{
+		g_ramdisk_block* existing = entry->blocks[index];
+		if(existing)
+		{
+			// Another reader was faster
+			existing->references++;
+			mutexRelease(&ramdiskBlockLock);
+			ramdiskBlockFree(block);
+			return existing;
+		}
+
+		entry->blocks[index] = block;
+		block->cached = true;
+		ramdiskBlockLruPushFront(block);
+		ramdiskBlockCount++;
+		ramdiskBlockEvict();
+	}
+	// If the contents were replaced meanwhile, the block is only used by this reader
+	mutexRelease(&ramdiskBlockLock);
+	return block;
 }
 
-g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index)
+static void ramdiskUnpinBlock(g_ramdisk_block* block)
 {
+	mutexAcquire(&ramdiskBlockLock);
+	block->references--;
+	bool release = block->references == 0 && !block->cached;
+	mutexRelease(&ramdiskBlockLock);
 
-	uint32_t pos = 0;
+	if(release)
+		ramdiskBlockFree(block);
+}
+
+uint32_t ramdiskReadData(g_ramdisk_entry* entry, uint32_t offset, uint8_t* buffer, uint32_t length)
+{
+	if(offset >= entry->dataSize)
+		return 0;
 
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode)
+	if(length > entry->dataSize - offset)
+		length = entry->dataSize - offset;
+
+	uint32_t done = 0;
+	while(entry->compressed && done < length)
 	{
-		if(currentNode->parentid == id)
+		uint32_t position = offset + done;
+		g_ramdisk_block* block = ramdiskPinBlock(entry, position / G_RAMDISK_BLOCK_SIZE);
+		if(!block)
 		{
-			if(pos == index)
-				return currentNode;
-			++pos;
+			if(entry->compressed)
+				return done;
+			break;
 		}
-		currentNode = currentNode->next;
+
+		uint32_t blockOffset = position % G_RAMDISK_BLOCK_SIZE;
+		uint32_t chunk = G_RAMDISK_BLOCK_SIZE - blockOffset;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		memoryCopy(&buffer[done], &block->data[blockOffset], chunk);
+		ramdiskUnpinBlock(block);
+		done += chunk;
 	}
 
-	return 0;
+	// Contents that are not or no longer compressed
+	if(done < length)
+		memoryCopy(&buffer[done], &entry->data[offset + done], length - done);
+	return length;
+}
+
+void ramdiskReleaseBlocks(g_ramdisk_entry* entry, uint8_t* data)
+{
+	mutexAcquire(&ramdiskBlockLock);
+	entry->data = data;
+	if(!entry->compressed)
+	{
+		mutexRelease(&ramdiskBlockLock);
+		return;
+	}
+
+	uint32_t blockCount = G_RAMDISK_BLOCK_COUNT(entry->dataSize);
+	for(uint32_t i = 0; i < blockCount; i++)
+	{
+		if(entry->blocks[i])
+			ramdiskBlockUncache(entry->blocks[i]);
+	}
+	heapFree(entry->blocks);
+	entry->blocks = 0;
+	entry->storedData = 0;
+	entry->compressed = false;
+	mutexRelease(&ramdiskBlockLock);
 }
 
 g_ramdisk_entry* ramdiskGetRoot()
@@ -273,5 +654,16 @@ g_ramdisk_entry* ramdiskCreateFile(g_ramdisk_entry* parent, const char* filename
 	entry->dataOnRamdisk = false;
 	entry->notOnRdBufferLength = 0;
 
+	entry->compressed = false;
+	entry->storedData = 0;
+	entry->blocks = 0;
+
+	entry->children = 0;
+	entry->childCount = 0;
+	entry->childCapacity = 0;
+	entry->childrenByName = 0;
+
+	ramdiskIndexEntry(entry);
+	ramdiskAddChild(parent, entry);
 	return entry;
 }
@@ -32,9 +32,15 @@ void messageInitialize()
     messageQueues = hashmapCreateNumeric<g_tid, g_message_queue*>(64);
 }
 
-void messageRemoveFromQueue(g_message_queue* queue, g_message_header* message)
+g_message_transaction_bucket* messageGetTransactionBucket(g_message_queue* queue, g_message_transaction tx)
 {
-    queue->size -= sizeof(g_message_header) + message->length;
+    return &queue->transactions[tx % G_MESSAGE_QUEUE_TRANSACTION_BUCKETS];
+}
+
+void messageRemoveFromQueue(g_message_queue* queue, g_message_entry* message)
+{
+    queue->size -= sizeof(g_message_header) + message->header.length;
+    queue->count--;
 
     if(message == queue->head)
         queue->head = message->next;
@@ -47,65 +53,109 @@ void messageRemoveFromQueue(g_message_queue* queue, g_message_header* message)
 
     if(message->previous)
         message->previous->next = message->next;
+
+    if(message->header.transaction == G_MESSAGE_TRANSACTION_NONE)
+        return;
+
+    g_message_transaction_bucket* bucket = messageGetTransactionBucket(queue, message->header.transaction);
+
+    if(message == bucket->head)
+        bucket->head = message->nextInTransaction;
+
+    if(message == bucket->tail)
+        bucket->tail = message->previousInTransaction;
+
+    if(message->nextInTransaction)
+        message->nextInTransaction->previousInTransaction = message->previousInTransaction;
+
+    if(message->previousInTransaction)
+        message->previousInTransaction->nextInTransaction = message->nextInTransaction;
 }
 
-void messageAddToQueueTail(g_message_queue* queue, g_message_header* message)
+void messageAddToQueueTail(g_message_queue* queue, g_message_entry* message)
 {
-    queue->size += sizeof(g_message_header) + message->length;
+    queue->size += sizeof(g_message_header) + message->header.length;
+    queue->count++;
 
     message->next = 0;
-    if(!queue->head)
-    {
+    message->previous = queue->tail;
+    if(queue->tail)
+        queue->tail->next = message;
+    else
         queue->head = message;
-        queue->tail = message;
-        message->previous = 0;
-        message->next = 0;
+    queue->tail = message;
+
+    message->nextInTransaction = 0;
+    message->previousInTransaction = 0;
+    if(message->header.transaction == G_MESSAGE_TRANSACTION_NONE)
         return;
-    }
 
-    message->previous = queue->tail;
-    queue->tail->next = message;
-    queue->tail = message;
+    g_message_transaction_bucket* bucket = messageGetTransactionBucket(queue, message->header.transaction);
+    message->previousInTransaction = bucket->tail;
+    if(bucket->tail)
+        bucket->tail->nextInTransaction = message;
+    else
+        bucket->head = message;
+    bucket->tail = message;
 }
 
-g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, uint32_t length, g_message_transaction tx)
+/**
+ * Finds the oldest message in the queue that has the given transaction. Only the
+ * bucket of the transaction is searched, so this does not depend on the number of
+ * other messages in the queue.
+ */
+g_message_entry* messageFindInQueue(g_message_queue* queue, g_message_transaction tx)
 {
-    if(length > G_MESSAGE_MAXIMUM_LENGTH)
-    {
-        return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
-    }
+    if(tx == G_MESSAGE_TRANSACTION_NONE)
+        return queue->head;
 
-    auto receiverEntry = hashmapGetEntry(messageQueues, receiver);
+    g_message_entry* message = messageGetTransactionBucket(queue, tx)->head;
+    while(message && message->header.transaction != tx)
+        message = message->nextInTransaction;
+    return message;
+}
 
-    g_message_queue* queue;
+g_message_queue* messageGetOrCreateQueue(g_tid receiver)
+{
+    auto receiverEntry = hashmapGetEntry(messageQueues, receiver);
     if(receiverEntry)
+        return receiverEntry->value;
+
+    g_message_queue* queue = (g_message_queue*) heapAllocateClear(sizeof(g_message_queue));
+    mutexInitialize(&queue->lock);
+    hashmapPut(messageQueues, receiver, queue);
+    return queue;
+}
+
+g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, uint32_t length, g_message_transaction tx, g_message_send_mode mode)
+{
+    if(length > G_MESSAGE_MAXIMUM_LENGTH)
     {
-        queue = receiverEntry->value;
-    }
-    else {
-        queue = (g_message_queue*) heapAllocate(sizeof(g_message_queue));
-        queue->size = 0;
-        queue->head = 0;
-        queue->tail = 0;
-        mutexInitialize(&queue->lock);
-        hashmapPut(messageQueues, receiver, queue);
+        return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
     }
 
+    g_message_queue* queue = messageGetOrCreateQueue(receiver);
+
     mutexAcquire(&queue->lock);
 
     uint32_t len = sizeof(g_message_header) + length;
     if(queue->size + len > G_MESSAGE_MAXIMUM_QUEUE_CONTENT)
     {
+        if(mode == G_MESSAGE_SEND_MODE_NON_BLOCKING)
+            queue->drops++;
         mutexRelease(&queue->lock);
         return G_MESSAGE_SEND_STATUS_QUEUE_FULL;
     }
 
-    g_message_header* message = (g_message_header*) heapAllocate(len);
-    message->length = length;
-    message->sender = sender;
-    message->transaction = tx;
-    memoryCopy(G_MESSAGE_CONTENT(message), content, length);
-	messageAddToQueueTail(queue, message);
+    g_message_entry* message = (g_message_entry*) heapAllocate(sizeof(g_message_entry) + length);
+    message->header.length = length;
+    message->header.sender = sender;
+    message->header.transaction = tx;
+    message->header.previous = 0;
+    message->header.next = 0;
+    memoryCopy(G_MESSAGE_CONTENT(&message->header), content, length);
+    messageAddToQueueTail(queue, message);
+    pollNotify(&queue->pollers);
 
     mutexRelease(&queue->lock);
 
@@ -127,31 +177,66 @@ g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, u
 
     mutexAcquire(&queue->lock);
 
-    g_message_header* message = queue->head;
-    while(message)
+    g_message_entry* message = messageFindInQueue(queue, tx);
+    if(!message)
     {
-        if(tx == G_MESSAGE_TRANSACTION_NONE || message->transaction == tx)
-        {
-            uint32_t len = sizeof(g_message_header) + message->length;
-            if(len > max)
-            {
-                mutexRelease(&queue->lock);
-                return G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE;
-            }
-
-            memoryCopy((void*) out, message, len);
-			messageRemoveFromQueue(queue, message);
-			heapFree(message);
-
-            mutexRelease(&queue->lock);
-            return G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
-        }
-
-        message = message->next;
+        mutexRelease(&queue->lock);
+        return G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY;
     }
 
+    uint32_t len = sizeof(g_message_header) + message->header.length;
+    if(len > max)
+    {
+        mutexRelease(&queue->lock);
+        return G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE;
+    }
+
+    memoryCopy((void*) out, &message->header, len);
+    messageRemoveFromQueue(queue, message);
+    heapFree(message);
+
     mutexRelease(&queue->lock);
-    return G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY;
+    return G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
+}
+
+bool messagePoll(g_tid receiver, g_tid subscriber)
+{
+    g_message_queue* queue = messageGetOrCreateQueue(receiver);
+
+    mutexAcquire(&queue->lock);
+    bool ready = queue->head != 0;
+    if(!ready && subscriber != G_TID_NONE)
+        pollSubscribe(&queue->pollers, subscriber);
+    mutexRelease(&queue->lock);
+
+    return ready;
+}
+
+void messageUnpoll(g_tid receiver, g_tid subscriber)
+{
+    auto receiverEntry = hashmapGetEntry(messageQueues, receiver);
+    if(!receiverEntry)
+        return;
+
+    g_message_queue* queue = receiverEntry->value;
+    mutexAcquire(&queue->lock);
+    pollUnsubscribe(&queue->pollers, subscriber);
+    mutexRelease(&queue->lock);
+}
+
+bool messageQueryQueue(g_tid task, g_kernquery_message_queue_get_data* out)
+{
+    auto entry = hashmapGetEntry(messageQueues, task);
+    if(!entry)
+        return false;
+
+    g_message_queue* queue = entry->value;
+    mutexAcquire(&queue->lock);
+    out->depth = queue->count;
+    out->bytes = queue->size;
+    out->drops = queue->drops;
+    mutexRelease(&queue->lock);
+    return true;
 }
 
 void messageTaskRemoved(g_tid task)
@@ -163,17 +248,17 @@ void messageTaskRemoved(g_tid task)
     g_message_queue* queue = receiverEntry->value;
     mutexAcquire(&queue->lock);
 
-    g_message_header* head = queue->head;
+    g_message_entry* head = queue->head;
     while(head)
     {
-        g_message_header* next = head->next;
+        g_message_entry* next = head->next;
         heapFree(head);
         head = next;
     }
+    pollClear(&queue->pollers);
 
     mutexRelease(&queue->lock);
 
     hashmapRemove(messageQueues, task);
     heapFree(queue);
 }
-
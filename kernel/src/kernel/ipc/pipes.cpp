@@ -113,6 +113,7 @@ void pipeRemoveReference(g_fs_phys_id pipeId)
 
 void pipeDeleteInternal(g_fs_phys_id pipeId, g_pipeline* pipe)
 {
+	pollClear(&pipe->pollers);
 	heapFree(pipe);
 	hashmapRemove(pipeMap, pipeId);
 
@@ -167,6 +168,7 @@ g_fs_read_status pipeRead(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offset,
 	{
 		// decrease pipes remaining bytes
 		pipe->size -= length;
+		pollNotify(&pipe->pollers);
 
 		// finish with success
 		*outRead = length;
@@ -229,6 +231,7 @@ g_fs_write_status pipeWrite(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offse
 		}
 
 		pipe->size += length;
+		pollNotify(&pipe->pollers);
 		*outWrote = length;
 		status = G_FS_WRITE_SUCCESSFUL;
 
@@ -262,7 +265,40 @@ g_fs_open_status pipeTruncate(g_fs_phys_id pipeId)
 	pipe->size = 0;
 	pipe->readPosition = pipe->buffer;
 	pipe->writePosition = pipe->buffer;
+	pollNotify(&pipe->pollers);
 	mutexRelease(&pipe->lock);
 
 	return G_FS_OPEN_SUCCESSFUL;
 }
+
+g_fs_poll_events pipePoll(g_fs_phys_id pipeId, g_fs_poll_events events, g_tid subscriber)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return G_FS_POLL_INVALID;
+
+	mutexAcquire(&pipe->lock);
+
+	g_fs_poll_events ready = 0;
+	if((events & G_FS_POLL_READ) && pipe->size > 0)
+		ready |= G_FS_POLL_READ;
+	if((events & G_FS_POLL_WRITE) && pipe->size < pipe->capacity)
+		ready |= G_FS_POLL_WRITE;
+
+	if(!ready && subscriber != G_TID_NONE)
+		pollSubscribe(&pipe->pollers, subscriber);
+
+	mutexRelease(&pipe->lock);
+	return ready;
+}
+
+void pipeUnpoll(g_fs_phys_id pipeId, g_tid subscriber)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return;
+
+	mutexAcquire(&pipe->lock);
+	pollUnsubscribe(&pipe->pollers, subscriber);
+	mutexRelease(&pipe->lock);
+}
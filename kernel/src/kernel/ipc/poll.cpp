@@ -0,0 +1,156 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/ipc/poll.hpp"
+#include "kernel/ipc/message.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/tasking/wait.hpp"
+#include "kernel/memory/heap.hpp"
+
+void pollSubscribe(g_poll_subscription** list, g_tid task)
+{
+	for(g_poll_subscription* entry = *list; entry; entry = entry->next)
+	{
+		if(entry->task == task)
+			return;
+	}
+
+	g_poll_subscription* subscription = (g_poll_subscription*) heapAllocate(sizeof(g_poll_subscription));
+	subscription->task = task;
+	subscription->next = *list;
+	*list = subscription;
+}
+
+void pollUnsubscribe(g_poll_subscription** list, g_tid task)
+{
+	g_poll_subscription** link = list;
+	while(*link)
+	{
+		g_poll_subscription* entry = *link;
+		if(entry->task == task)
+		{
+			*link = entry->next;
+			heapFree(entry);
+			return;
+		}
+		link = &entry->next;
+	}
+}
+
+void pollNotify(g_poll_subscription** list)
+{
+	g_poll_subscription** link = list;
+	while(*link)
+	{
+		g_poll_subscription* entry = *link;
+
+		g_task* task = taskingGetById(entry->task);
+		if(!task)
+		{
+			*link = entry->next;
+			heapFree(entry);
+			continue;
+		}
+
+		task->pollNotified = true;
+		link = &entry->next;
+	}
+}
+
+void pollClear(g_poll_subscription** list)
+{
+	pollNotify(list);
+
+	g_poll_subscription* entry = *list;
+	while(entry)
+	{
+		g_poll_subscription* next = entry->next;
+		heapFree(entry);
+		entry = next;
+	}
+	*list = 0;
+}
+
+/**
+ * Checks all sources once and fills in which of them are ready. If a subscriber is
+ * given, it is subscribed to each source that is not ready, within the same lock that
+ * is used for the check so that no notification can get lost in between.
+ */
+static int32_t pollEvaluate(g_task* task, g_syscall_fs_poll* data, g_tid subscriber)
+{
+	int32_t ready = 0;
+	for(uint32_t i = 0; i < data->count; i++)
+	{
+		g_fs_poll_entry* entry = &data->entries[i];
+		if(entry->fd < 0)
+		{
+			entry->revents = 0;
+			continue;
+		}
+
+		entry->revents = filesystemPollDescriptor(task->process, entry->fd, entry->events, subscriber);
+		if(entry->revents)
+			ready++;
+	}
+
+	data->messages_ready = data->messages && messagePoll(task->id, subscriber);
+	if(data->messages_ready)
+		ready++;
+	return ready;
+}
+
+static void pollRelease(g_task* task, g_syscall_fs_poll* data, g_tid subscriber)
+{
+	for(uint32_t i = 0; i < data->count; i++)
+	{
+		if(data->entries[i].fd >= 0)
+			filesystemUnpollDescriptor(task->process, data->entries[i].fd, subscriber);
+	}
+
+	if(data->messages)
+		messageUnpoll(task->id, subscriber);
+}
+
+void pollWait(g_task* task, g_syscall_fs_poll* data)
+{
+	g_task* waiter = taskingGetCurrentTask();
+	bool canWait = data->timeout != 0 && waiter->type == G_THREAD_TYPE_SYSCALL;
+	g_tid subscriber = canWait ? waiter->id : G_TID_NONE;
+	uint32_t startTime = taskingGetLocal()->time;
+
+	for(;;)
+	{
+		// reset before checking, a notification that arrives during the check is kept
+		waiter->pollNotified = false;
+
+		data->result = pollEvaluate(task, data, subscriber);
+		if(data->result > 0 || !canWait)
+			break;
+
+		if(data->timeout > 0 && taskingGetLocal()->time - startTime >= (uint32_t) data->timeout)
+			break;
+
+		waitForPoll(waiter, startTime, data->timeout);
+		taskingKernelThreadYield();
+	}
+
+	if(canWait)
+		pollRelease(task, data, subscriber);
+}
@@ -62,3 +62,55 @@ void memoryUnmapSetupMemory()
 	for(g_virtual_address addr = G_CONST_LOWER_MEMORY_END; addr < G_CONST_KERNEL_AREA_START; addr += G_PAGE_SIZE)
 		pagingUnmapPage(addr);
 }
+
+g_virtual_address memoryAllocateKernelPage()
+{
+	return memoryAllocateKernelRange(1);
+}
+
+void memoryFreeKernelPage(g_virtual_address page)
+{
+	memoryFreeKernelRange(page);
+}
+
+g_virtual_address memoryAllocateKernelRange(uint32_t pages)
+{
+	g_virtual_address range = addressRangePoolAllocate(memoryVirtualRangePool, pages);
+	if(!range)
+		return 0;
+
+	for(uint32_t i = 0; i < pages; i++)
+	{
+		g_physical_address physical = bitmapPageAllocatorAllocate(&memoryPhysicalAllocator);
+		if(!physical)
+		{
+			for(uint32_t j = 0; j < i; j++)
+			{
+				g_virtual_address page = range + j * G_PAGE_SIZE;
+				bitmapPageAllocatorMarkFree(&memoryPhysicalAllocator, pagingVirtualToPhysical(page));
+				pagingUnmapPage(page);
+			}
+			addressRangePoolFree(memoryVirtualRangePool, range);
+			return 0;
+		}
+		pagingMapPage(range + i * G_PAGE_SIZE, physical, DEFAULT_KERNEL_TABLE_FLAGS, DEFAULT_KERNEL_PAGE_FLAGS);
+	}
+
+	memorySetBytes((void*) range, 0, pages * G_PAGE_SIZE);
+	return range;
+}
+
+void memoryFreeKernelRange(g_virtual_address range)
+{
+	g_address_range* entry = addressRangePoolFind(memoryVirtualRangePool, range);
+	if(!entry)
+		return;
+
+	for(uint32_t i = 0; i < entry->pages; i++)
+	{
+		g_virtual_address page = range + i * G_PAGE_SIZE;
+		bitmapPageAllocatorMarkFree(&memoryPhysicalAllocator, pagingVirtualToPhysical(page));
+		pagingUnmapPage(page);
+	}
+	addressRangePoolFree(memoryVirtualRangePool, range);
+}
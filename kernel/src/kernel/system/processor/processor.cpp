@@ -35,6 +35,7 @@ void processorInitializeBsp()
 
 	processorPrintInformation();
 	processorEnableSSE();
+	processorEnablePat();
 
 	if(!processorHasFeature(g_cpuid_standard_edx_feature::APIC))
 		kernelPanic("%! processor has no APIC", "cpu");
@@ -43,6 +44,7 @@ void processorInitializeBsp()
 void processorInitializeAp()
 {
 	processorEnableSSE();
+	processorEnablePat();
 }
 
 void processorApicIdCreateMappingTable()
@@ -144,6 +146,31 @@ void processorEnableSSE()
 	}
 }
 
+void processorEnablePat()
+{
+	if(!processorSupportsWriteCombining())
+	{
+		logWarn("%! not supported, framebuffers are not write-combined", "pat");
+		return;
+	}
+
+	// entries 4 to 7 are in the high dword
+	uint32_t lo;
+	uint32_t hi;
+	processorReadMsr(IA32_PAT_MSR, &lo, &hi);
+
+	uint32_t shift = (G_PAT_ENTRY_WRITE_COMBINING - 4) * 8;
+	hi &= ~(0xFFu << shift);
+	hi |= G_PAT_MEMORY_TYPE_WRITE_COMBINING << shift;
+	processorWriteMsr(IA32_PAT_MSR, lo, hi);
+	logDebug("%! entry %i set to write-combining", "pat", G_PAT_ENTRY_WRITE_COMBINING);
+}
+
+bool processorSupportsWriteCombining()
+{
+	return processorHasFeature(g_cpuid_standard_edx_feature::PAT);
+}
+
 bool processorHasFeature(g_cpuid_standard_edx_feature feature)
 {
 	uint32_t eax;
@@ -208,6 +235,10 @@ void processorPrintInformation()
 	{
 		logInfon(" SSE2");
 	}
+	if(edx & (int64_t) g_cpuid_standard_edx_feature::PAT)
+	{
+		logInfon(" PAT");
+	}
 	logInfo("");
 }
 
@@ -233,3 +264,9 @@ uint32_t processorReadEflags() {
                    : "=g"(eflags));
 	return eflags;
 }
+
+uint64_t processorReadTimestamp() {
+	uint64_t timestamp;
+	asm volatile("rdtsc" : "=A"(timestamp));
+	return timestamp;
+}
@@ -74,7 +74,7 @@ void smpInitialize(g_physical_address initialPageDirectoryPhysical)
 		logInfo("%*%! could not initialize due to missing apstartup object at '%s'", 0x0C, "smp", ap_startup_location);
 		return;
 	}
-	memoryCopy((uint8_t*) G_CONST_SMP_STARTUP_AREA_CODE_START, (uint8_t*) startupObject->data, startupObject->dataSize);
+	ramdiskReadData(startupObject, 0, (uint8_t*) G_CONST_SMP_STARTUP_AREA_CODE_START, startupObject->dataSize);
 
 	smpInitialized = true;
 
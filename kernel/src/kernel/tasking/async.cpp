@@ -0,0 +1,272 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/tasking/async.hpp"
+#include "kernel/tasking/wait.hpp"
+#include "kernel/calls/syscall.hpp"
+#include "kernel/ipc/message.hpp"
+#include "kernel/memory/heap.hpp"
+#include "shared/logger/logger.hpp"
+
+/**
+ * Only calls that solely depend on the process of the calling task may be executed
+ * by a worker. Messaging calls are handled separately, see <asyncExecute>.
+ */
+static bool asyncIsSupported(uint32_t call)
+{
+	switch(call)
+	{
+	case G_SYSCALL_MESSAGE_SEND:
+	case G_SYSCALL_MESSAGE_RECEIVE:
+	case G_SYSCALL_FS_OPEN:
+	case G_SYSCALL_FS_SEEK:
+	case G_SYSCALL_FS_READ:
+	case G_SYSCALL_FS_WRITE:
+	case G_SYSCALL_FS_CLOSE:
+	case G_SYSCALL_FS_LENGTH:
+	case G_SYSCALL_FS_TELL:
+	case G_SYSCALL_FS_STAT:
+	case G_SYSCALL_FS_FSTAT:
+	case G_SYSCALL_FS_READV:
+	case G_SYSCALL_FS_WRITEV:
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Writes a completion to the ring. Must be called with the context locked.
+ */
+static void asyncPostCompletion(g_async_context* async, uint32_t call, uint32_t userData, g_async_completion_status status)
+{
+	g_async_ring* ring = async->ring;
+	uint32_t tail = ring->completion_tail;
+
+	g_async_completion* completion = &G_ASYNC_COMPLETIONS(ring)[tail & (ring->entries - 1)];
+	completion->user_data = userData;
+	completion->call = call;
+	completion->status = status;
+
+	__sync_synchronize();
+	ring->completion_tail = tail + 1;
+}
+
+static void asyncStartWorker(g_process* process)
+{
+	g_tasking_local* local = taskingGetLocal();
+	mutexAcquire(&local->lock);
+
+	g_task* worker = taskingCreateThread((g_virtual_address) asyncWorkerEntry, process, G_SECURITY_LEVEL_KERNEL);
+	worker->type = G_THREAD_TYPE_SYSCALL;
+	taskingAssign(local, worker);
+
+	mutexRelease(&local->lock);
+}
+
+g_async_setup_status asyncSetup(g_task* task, g_async_ring* ring, uint32_t entries)
+{
+	if(entries == 0 || entries > G_ASYNC_MAXIMUM_ENTRIES || (entries & (entries - 1)) != 0)
+		return G_ASYNC_SETUP_STATUS_INVALID_SIZE;
+
+	g_process* process = task->process;
+	mutexAcquire(&process->lock);
+	if(process->async)
+	{
+		mutexRelease(&process->lock);
+		return G_ASYNC_SETUP_STATUS_ALREADY_SET_UP;
+	}
+
+	ring->submission_head = 0;
+	ring->submission_tail = 0;
+	ring->completion_head = 0;
+	ring->completion_tail = 0;
+	ring->entries = entries;
+
+	g_async_context* async = (g_async_context*) heapAllocateClear(sizeof(g_async_context));
+	mutexInitialize(&async->lock);
+	async->ring = ring;
+	process->async = async;
+
+	mutexRelease(&process->lock);
+	return G_ASYNC_SETUP_STATUS_SUCCESSFUL;
+}
+
+uint32_t asyncSubmit(g_task* task)
+{
+	g_async_context* async = task->process->async;
+	if(!async)
+		return 0;
+
+	mutexAcquire(&async->lock);
+	g_async_ring* ring = async->ring;
+
+	uint32_t head = ring->submission_head;
+	uint32_t tail = ring->submission_tail;
+	__sync_synchronize();
+
+	uint32_t submitted = 0;
+	while(head != tail)
+	{
+		uint32_t unconsumed = ring->completion_tail - ring->completion_head;
+		if(async->pending + unconsumed >= ring->entries)
+			break;
+
+		g_async_submission* submission = &G_ASYNC_SUBMISSIONS(ring)[head & (ring->entries - 1)];
+		++head;
+		++submitted;
+
+		if(!asyncIsSupported(submission->call))
+		{
+			asyncPostCompletion(async, submission->call, submission->user_data, G_ASYNC_COMPLETION_STATUS_UNSUPPORTED);
+			continue;
+		}
+
+		g_async_operation* operation = (g_async_operation*) heapAllocate(sizeof(g_async_operation));
+		operation->source = task->id;
+		operation->call = submission->call;
+		operation->data = submission->data;
+		operation->userData = submission->user_data;
+		operation->next = 0;
+
+		if(async->tail)
+			async->tail->next = operation;
+		else
+			async->head = operation;
+		async->tail = operation;
+		async->queued++;
+		async->pending++;
+	}
+	ring->submission_head = head;
+
+	int startWorkers = 0;
+	while(async->workers < G_ASYNC_MAXIMUM_WORKERS && (uint32_t) (async->workers - async->busyWorkers) < async->queued)
+	{
+		async->workers++;
+		startWorkers++;
+	}
+	mutexRelease(&async->lock);
+
+	for(int i = 0; i < startWorkers; i++)
+		asyncStartWorker(task->process);
+
+	return submitted;
+}
+
+uint32_t asyncAvailableCompletions(g_process* process)
+{
+	g_async_context* async = process->async;
+	if(!async)
+		return 0;
+	return async->ring->completion_tail - async->ring->completion_head;
+}
+
+/**
+ * Executes a single call within the worker. Messaging calls operate on the message
+ * queue of a task, so the worker sends and receives on behalf of the source task.
+ */
+static void asyncExecute(g_task* worker, g_async_operation* operation)
+{
+	worker->syscall.data = operation->data;
+
+	if(operation->call == G_SYSCALL_MESSAGE_SEND)
+	{
+		g_syscall_send_message* data = (g_syscall_send_message*) operation->data;
+		data->status = messageSend(operation->source, data->receiver, data->buffer, data->length, data->transaction, data->mode);
+
+		if(data->mode == G_MESSAGE_SEND_MODE_BLOCKING && data->status == G_MESSAGE_SEND_STATUS_QUEUE_FULL)
+		{
+			waitForAsyncMessageSend(worker, operation->source);
+			taskingKernelThreadYield();
+		}
+
+	} else if(operation->call == G_SYSCALL_MESSAGE_RECEIVE)
+	{
+		g_syscall_receive_message* data = (g_syscall_receive_message*) operation->data;
+		data->status = messageReceive(operation->source, data->buffer, data->maximum, data->transaction);
+
+		if(data->mode == G_MESSAGE_RECEIVE_MODE_BLOCKING && data->status == G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY)
+		{
+			waitForAsyncMessageReceive(worker, operation->source);
+			taskingKernelThreadYield();
+		}
+
+	} else
+	{
+		g_syscall_registration* reg = syscallGetRegistration(operation->call);
+		worker->syscall.handler = reg->handler;
+		reg->handler(worker, operation->data);
+	}
+}
+
+void asyncWorkerEntry()
+{
+	g_task* worker = taskingGetCurrentTask();
+	g_async_context* async = worker->process->async;
+
+	for(;;)
+	{
+		mutexAcquire(&async->lock);
+		g_async_operation* operation = async->head;
+		if(operation)
+		{
+			async->head = operation->next;
+			if(!async->head)
+				async->tail = 0;
+			async->queued--;
+			async->busyWorkers++;
+		}
+		mutexRelease(&async->lock);
+
+		if(!operation)
+		{
+			waitForAsyncWork(worker);
+			taskingKernelThreadYield();
+			continue;
+		}
+
+		asyncExecute(worker, operation);
+
+		mutexAcquire(&async->lock);
+		asyncPostCompletion(async, operation->call, operation->userData, G_ASYNC_COMPLETION_STATUS_DONE);
+		async->pending--;
+		async->busyWorkers--;
+		mutexRelease(&async->lock);
+
+		heapFree(operation);
+	}
+}
+
+void asyncProcessRemoved(g_process* process)
+{
+	g_async_context* async = process->async;
+	if(!async)
+		return;
+
+	g_async_operation* operation = async->head;
+	while(operation)
+	{
+		g_async_operation* next = operation->next;
+		heapFree(operation);
+		operation = next;
+	}
+
+	heapFree(async);
+	process->async = 0;
+}
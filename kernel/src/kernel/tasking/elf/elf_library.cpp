@@ -45,7 +45,7 @@ g_spawn_status elfLibraryLoad(g_task* caller, g_elf_object* parentObject, const
 		return G_SPAWN_STATUS_DEPENDENCY_ERROR;
 	}
 	g_spawn_status status = elfObjectLoad(caller, parentObject, name, fd, baseAddress, rangeAllocator, outNextBase, outObject);
-	filesystemClose(caller->process->id, fd, true);
+	filesystemClose(caller->process, fd, true);
 	return status;
 }
 
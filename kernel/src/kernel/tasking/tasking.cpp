@@ -25,10 +25,12 @@
 #include "kernel/tasking/tasking_directory.hpp"
 #include "kernel/tasking/scheduler.hpp"
 #include "kernel/tasking/wait.hpp"
+#include "kernel/tasking/async.hpp"
 #include "kernel/tasking/elf/elf_loader.hpp"
 
 #include "kernel/ipc/message.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/system/processor/processor.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/lower_heap.hpp"
@@ -159,7 +161,7 @@ void taskingAddToProcessTaskList(g_process* process, g_task* task)
 	{
 		process->main = task;
 		process->id = task->id;
-		filesystemProcessCreate((g_pid) task->id);
+		filesystemProcessCreate(process);
 	}
 	mutexRelease(&process->lock);
 }
@@ -347,6 +349,8 @@ g_process* taskingCreateProcess()
 	process->id = taskingGetNextId();
 	process->main = 0;
 	process->tasks = 0;
+	process->async = 0;
+	process->filesystem = 0;
 
 	mutexInitialize(&process->lock);
 
@@ -374,6 +378,7 @@ g_process* taskingCreateProcess()
 	process->environment.arguments = 0;
 	process->environment.executablePath = 0;
 	process->environment.workingDirectory = 0;
+	process->environment.workingDirectoryNode = 0;
 
 	return process;
 }
@@ -639,7 +644,9 @@ void taskingRemoveProcess(g_process* process)
 {
 	mutexAcquire(&process->lock);
 
-	filesystemProcessRemove(process->id);
+	filesystemProcessRemove(process);
+	filesystemTaskedDelegateProcessRemoved(process);
+	asyncProcessRemoved(process);
 
 	g_physical_address returnDirectory = taskingTemporarySwitchToSpace(process->pageDirectory);
 
@@ -124,6 +124,94 @@ void waitForMessageReceive(g_task* task)
 	mutexRelease(&task->process->lock);
 }
 
+void waitForAsyncWork(g_task* task)
+{
+	mutexAcquire(&task->process->lock);
+
+	task->waitData = 0;
+	task->waitResolver = waitResolverAsyncWork;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForAsyncCompletion(g_task* task, uint32_t minimum)
+{
+	mutexAcquire(&task->process->lock);
+
+	g_wait_resolver_async_completion_data* waitData = (g_wait_resolver_async_completion_data*) heapAllocate(sizeof(g_wait_resolver_async_completion_data));
+	waitData->minimum = minimum;
+	task->waitData = waitData;
+	task->waitResolver = waitResolverAsyncCompletion;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForAsyncMessageSend(g_task* task, g_tid source)
+{
+	mutexAcquire(&task->process->lock);
+
+	g_wait_resolver_async_message_data* waitData = (g_wait_resolver_async_message_data*) heapAllocate(sizeof(g_wait_resolver_async_message_data));
+	waitData->source = source;
+	task->waitData = waitData;
+	task->waitResolver = waitResolverAsyncSendMessage;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForAsyncMessageReceive(g_task* task, g_tid source)
+{
+	mutexAcquire(&task->process->lock);
+
+	g_wait_resolver_async_message_data* waitData = (g_wait_resolver_async_message_data*) heapAllocate(sizeof(g_wait_resolver_async_message_data));
+	waitData->source = source;
+	task->waitData = waitData;
+	task->waitResolver = waitResolverAsyncReceiveMessage;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForDelegateRequest(g_task* task, volatile uint32_t* completed)
+{
+	mutexAcquire(&task->process->lock);
+
+	g_wait_resolver_delegate_request_data* waitData = (g_wait_resolver_delegate_request_data*) heapAllocate(sizeof(g_wait_resolver_delegate_request_data));
+	waitData->completed = completed;
+	task->waitData = waitData;
+	task->waitResolver = waitResolverDelegateRequest;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForCacheWork(g_task* task)
+{
+	mutexAcquire(&task->process->lock);
+
+	task->waitData = 0;
+	task->waitResolver = waitResolverCacheWork;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
+void waitForPoll(g_task* task, uint32_t startTime, int32_t timeout)
+{
+	mutexAcquire(&task->process->lock);
+
+	g_wait_resolver_poll_data* waitData = (g_wait_resolver_poll_data*) heapAllocate(sizeof(g_wait_resolver_poll_data));
+	waitData->startTime = startTime;
+	waitData->timeout = timeout;
+	task->waitData = waitData;
+	task->waitResolver = waitResolverPoll;
+	task->status = G_THREAD_STATUS_WAITING;
+
+	mutexRelease(&task->process->lock);
+}
+
 void waitForVm86(g_task* task, g_task* vm86Task, g_vm86_registers* registerStore)
 {
 	mutexAcquire(&task->process->lock);
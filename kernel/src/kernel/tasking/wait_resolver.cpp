@@ -24,6 +24,8 @@
 #include "kernel/memory/heap.hpp"
 #include "shared/logger/logger.hpp"
 #include "kernel/ipc/message.hpp"
+#include "kernel/tasking/async.hpp"
+#include "kernel/filesystem/filesystem_cache.hpp"
 
 
 bool waitResolverSleep(g_task* task)
@@ -76,7 +78,7 @@ bool waitResolverSendMessage(g_task* task)
 {
 	g_syscall_send_message* data = (g_syscall_send_message*) task->syscall.data;
 
-	data->status = messageSend(task->id, data->receiver, data->buffer, data->length, data->transaction);
+	data->status = messageSend(task->id, data->receiver, data->buffer, data->length, data->transaction, data->mode);
 	if(data->status == G_MESSAGE_SEND_STATUS_QUEUE_FULL)
 	{
 		return false;
@@ -102,6 +104,72 @@ bool waitResolverReceiveMessage(g_task* task)
 	return true;
 }
 
+bool waitResolverAsyncWork(g_task* task)
+{
+	return task->process->async && task->process->async->head != 0;
+}
+
+bool waitResolverAsyncCompletion(g_task* task)
+{
+	g_wait_resolver_async_completion_data* waitData = (g_wait_resolver_async_completion_data*) task->waitData;
+	g_syscall_async_wait* data = (g_syscall_async_wait*) task->syscall.data;
+
+	data->available = asyncAvailableCompletions(task->process);
+	return data->available >= waitData->minimum;
+}
+
+bool waitResolverAsyncSendMessage(g_task* task)
+{
+	g_wait_resolver_async_message_data* waitData = (g_wait_resolver_async_message_data*) task->waitData;
+	g_syscall_send_message* data = (g_syscall_send_message*) task->syscall.data;
+
+	data->status = messageSend(waitData->source, data->receiver, data->buffer, data->length, data->transaction, data->mode);
+	if(data->status == G_MESSAGE_SEND_STATUS_QUEUE_FULL)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool waitResolverAsyncReceiveMessage(g_task* task)
+{
+	g_wait_resolver_async_message_data* waitData = (g_wait_resolver_async_message_data*) task->waitData;
+	g_syscall_receive_message* data = (g_syscall_receive_message*) task->syscall.data;
+
+	if(data->break_condition && *data->break_condition)
+	{
+		data->status = G_MESSAGE_RECEIVE_STATUS_INTERRUPTED;
+		return true;
+	}
+
+	data->status = messageReceive(waitData->source, data->buffer, data->maximum, data->transaction);
+	if(data->status == G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool waitResolverDelegateRequest(g_task* task)
+{
+	g_wait_resolver_delegate_request_data* waitData = (g_wait_resolver_delegate_request_data*) task->waitData;
+	return *waitData->completed != 0;
+}
+
+bool waitResolverCacheWork(g_task* task)
+{
+	return filesystemCacheHasWork();
+}
+
+bool waitResolverPoll(g_task* task)
+{
+	if(task->pollNotified)
+		return true;
+
+	g_wait_resolver_poll_data* waitData = (g_wait_resolver_poll_data*) task->waitData;
+	return waitData->timeout > 0 && taskingGetLocal()->time - waitData->startTime >= (uint32_t) waitData->timeout;
+}
+
 bool waitResolverVm86(g_task* task)
 {
 	g_wait_vm86_data* waitData = (g_wait_vm86_data*) task->waitData;
@@ -0,0 +1,105 @@
+#include "test/test.hpp"
+#include <string.h>
+
+#include "ghostuser/ui/canvas_damage_history.cpp"
+
+#define TEST_CANVAS_WIDTH	8
+#define TEST_CANVAS_HEIGHT	4
+#define TEST_CANVAS_STRIDE	(TEST_CANVAS_WIDTH * 4)
+#define TEST_CANVAS_SIZE	(TEST_CANVAS_STRIDE * TEST_CANVAS_HEIGHT)
+
+/**
+ * Counts the pixels that differ between both buffers.
+ */
+static int canvasDifferingPixels(const uint8_t* a, const uint8_t* b)
+{
+	int differing = 0;
+	for(int i = 0; i < TEST_CANVAS_SIZE; i += 4)
+	{
+		if(memcmp(a + i, b + i, 4) != 0)
+			++differing;
+	}
+	return differing;
+}
+
+TEST(canvasDamageHistoryRecordClips)
+{
+	g_canvas_damage_history history;
+	g_rectangle rects[] = {g_rectangle(-2, -2, 4, 4), g_rectangle(6, 2, 10, 10), g_rectangle(20, 0, 5, 5)};
+
+	const g_canvas_frame_damage& damage = history.record(1, rects, 3, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+	ASSERT_EQUALS(1, damage.frame);
+	ASSERT_EQUALS(2, damage.count);
+	ASSERT_EQUALS(0, damage.rects[0].x);
+	ASSERT_EQUALS(0, damage.rects[0].y);
+	ASSERT_EQUALS(2, damage.rects[0].width);
+	ASSERT_EQUALS(2, damage.rects[0].height);
+	ASSERT_EQUALS(6, damage.rects[1].x);
+	ASSERT_EQUALS(2, damage.rects[1].y);
+	ASSERT_EQUALS(2, damage.rects[1].width);
+	ASSERT_EQUALS(2, damage.rects[1].height);
+	return true;
+}
+
+TEST(canvasDamageHistoryRecordJoinsTooMany)
+{
+	g_canvas_damage_history history;
+	g_rectangle rects[G_UI_CANVAS_MAXIMUM_DAMAGE + 1];
+	for(int i = 0; i < G_UI_CANVAS_MAXIMUM_DAMAGE + 1; i++)
+		rects[i] = g_rectangle(i * 10, i * 5, 2, 2);
+
+	const g_canvas_frame_damage& damage = history.record(1, rects, G_UI_CANVAS_MAXIMUM_DAMAGE + 1, 1000, 1000);
+	ASSERT_EQUALS(1, damage.count);
+	ASSERT_EQUALS(0, damage.rects[0].x);
+	ASSERT_EQUALS(0, damage.rects[0].y);
+	ASSERT_EQUALS(G_UI_CANVAS_MAXIMUM_DAMAGE * 10 + 2, damage.rects[0].width);
+	ASSERT_EQUALS(G_UI_CANVAS_MAXIMUM_DAMAGE * 5 + 2, damage.rects[0].height);
+	return true;
+}
+
+TEST(canvasDamageHistoryCopiesDamage)
+{
+	g_canvas_damage_history history;
+	uint8_t from[TEST_CANVAS_SIZE];
+	uint8_t to[TEST_CANVAS_SIZE];
+	memset(from, 0xAA, sizeof(from));
+	memset(to, 0x00, sizeof(to));
+
+	// the target buffer was presented as frame 1, frames 2 and 3 changed one pixel each
+	g_rectangle first(1, 1, 1, 1);
+	g_rectangle second(5, 3, 1, 1);
+	history.record(1, 0, 0, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+	history.record(2, &first, 1, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+	history.record(3, &second, 1, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+
+	history.copyForward(to, from, TEST_CANVAS_STRIDE, TEST_CANVAS_SIZE, 1, 3);
+	ASSERT_EQUALS(TEST_CANVAS_WIDTH * TEST_CANVAS_HEIGHT - 2, canvasDifferingPixels(to, from));
+	ASSERT_EQUALS(0, memcmp(to + 1 * TEST_CANVAS_STRIDE + 1 * 4, from + 1 * TEST_CANVAS_STRIDE + 1 * 4, 4));
+	ASSERT_EQUALS(0, memcmp(to + 3 * TEST_CANVAS_STRIDE + 5 * 4, from + 3 * TEST_CANVAS_STRIDE + 5 * 4, 4));
+	return true;
+}
+
+TEST(canvasDamageHistoryCopiesAllWhenTooOld)
+{
+	g_canvas_damage_history history;
+	uint8_t from[TEST_CANVAS_SIZE];
+	uint8_t to[TEST_CANVAS_SIZE];
+	memset(from, 0xAA, sizeof(from));
+
+	g_rectangle pixel(0, 0, 1, 1);
+	for(uint32_t f = 1; f <= G_CANVAS_DAMAGE_HISTORY + 2; f++)
+		history.record(f, &pixel, 1, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+
+	// the damage of the frames after the buffer is no longer known
+	memset(to, 0x00, sizeof(to));
+	history.copyForward(to, from, TEST_CANVAS_STRIDE, TEST_CANVAS_SIZE, 1, G_CANVAS_DAMAGE_HISTORY + 2);
+	ASSERT_EQUALS(0, canvasDifferingPixels(to, from));
+
+	// after clearing, no damage is known at all
+	history.clear();
+	history.record(G_CANVAS_DAMAGE_HISTORY + 3, &pixel, 1, TEST_CANVAS_WIDTH, TEST_CANVAS_HEIGHT);
+	memset(to, 0x00, sizeof(to));
+	history.copyForward(to, from, TEST_CANVAS_STRIDE, TEST_CANVAS_SIZE, G_CANVAS_DAMAGE_HISTORY + 1, G_CANVAS_DAMAGE_HISTORY + 3);
+	ASSERT_EQUALS(0, canvasDifferingPixels(to, from));
+	return true;
+}
@@ -0,0 +1,87 @@
+#include "test/test.hpp"
+#include <string.h>
+
+#include "shared/memory/memory.cpp"
+#include "kernel/filesystem/ramdisk_compression.cpp"
+
+TEST(ramdiskDecompressLiterals)
+{
+	const uint8_t block[] = {0x50, 'h', 'e', 'l', 'l', 'o'};
+	uint8_t out[16];
+
+	ASSERT_EQUALS(5, ramdiskDecompressBlock(block, sizeof(block), out, sizeof(out)));
+	ASSERT_EQUALS(0, memcmp(out, "hello", 5));
+	return true;
+}
+
+TEST(ramdiskDecompressOverlappingMatch)
+{
+	// two literals, then a match of six bytes at offset two that overlaps its own output
+	const uint8_t block[] = {0x22, 'a', 'b', 0x02, 0x00, 0x10, 'c'};
+	uint8_t out[16];
+
+	ASSERT_EQUALS(9, ramdiskDecompressBlock(block, sizeof(block), out, sizeof(out)));
+	ASSERT_EQUALS(0, memcmp(out, "ababababc", 9));
+	return true;
+}
+
+TEST(ramdiskDecompressExtendedLengths)
+{
+	// 15 + 255 + 2 literals, then a match of 4 + 15 + 1 bytes
+	uint8_t block[3 + 272 + 4];
+	uint32_t pos = 0;
+	block[pos++] = 0xFF;
+	block[pos++] = 255;
+	block[pos++] = 2;
+	for(int i = 0; i < 272; i++)
+		block[pos++] = 'x';
+	block[pos++] = 0x01;
+	block[pos++] = 0x00;
+	block[pos++] = 1;
+
+	uint8_t out[512];
+	ASSERT_EQUALS(292, ramdiskDecompressBlock(block, pos, out, sizeof(out)));
+	for(int i = 0; i < 292; i++)
+		ASSERT_EQUALS('x', out[i]);
+	return true;
+}
+
+TEST(ramdiskDecompressRejectsMalformed)
+{
+	uint8_t out[16];
+
+	// offset of zero
+	const uint8_t zeroOffset[] = {0x10, 'a', 0x00, 0x00};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(zeroOffset, sizeof(zeroOffset), out, sizeof(out)));
+
+	// offset before the start of the output
+	const uint8_t farOffset[] = {0x10, 'a', 0x02, 0x00};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(farOffset, sizeof(farOffset), out, sizeof(out)));
+
+	// truncated offset
+	const uint8_t truncatedOffset[] = {0x10, 'a', 0x01};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(truncatedOffset, sizeof(truncatedOffset), out, sizeof(out)));
+
+	// more literals than the input contains
+	const uint8_t truncatedLiterals[] = {0x50, 'a', 'b'};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(truncatedLiterals, sizeof(truncatedLiterals), out, sizeof(out)));
+
+	// missing continuation byte of a literal length
+	const uint8_t truncatedLength[] = {0xF0};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(truncatedLength, sizeof(truncatedLength), out, sizeof(out)));
+	return true;
+}
+
+TEST(ramdiskDecompressRejectsOverflow)
+{
+	uint8_t out[8];
+
+	// literals that do not fit into the target
+	const uint8_t literals[] = {0x50, 'h', 'e', 'l', 'l', 'o'};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(literals, sizeof(literals), out, 4));
+
+	// a match that does not fit into the target
+	const uint8_t match[] = {0x2F, 'a', 'b', 0x02, 0x00, 0x00};
+	ASSERT_EQUALS(-1, ramdiskDecompressBlock(match, sizeof(match), out, sizeof(out)));
+	return true;
+}
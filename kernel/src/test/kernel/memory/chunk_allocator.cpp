@@ -11,6 +11,18 @@ typedef uint64_t g_physical_address;
 
 #include "kernel/memory/chunk_allocator.cpp"
 
+void mutexInitialize(g_mutex* mutex)
+{
+}
+
+void mutexAcquire(g_mutex* mutex)
+{
+}
+
+void mutexRelease(g_mutex* mutex)
+{
+}
+
 
 uint8_t testMemory[0x1000];
 TEST(chunkAllocatorInitialize)
@@ -25,6 +37,7 @@ TEST(chunkAllocatorInitialize)
 	ASSERT_EQUALS(false, alloc.first->used);
 	ASSERT_EQUALS(0x1000 - sizeof(g_chunk_header), alloc.first->size);
 	ASSERT_EQUALS(0, alloc.first->next);
+	return true;
 }
 
 
@@ -48,5 +61,6 @@ TEST(chunkAllocatorExpand)
 	ASSERT_EQUALS(false, next->used);
 	ASSERT_EQUALS(0x100 - sizeof(g_chunk_header), next->size);
 	ASSERT_EQUALS(0, next->next);
+	return true;
 }
 
@@ -22,19 +22,22 @@ void testAdd(const char* name, bool (*func)())
 
 int main()
 {
+	int failed = 0;
 	test_t* n = tests;
 	while(n)
 	{
 		printf("%s:\n", n->name);
-		if(!n->test())
+		if(n->test())
 		{
 			printf("  Successful\n");
 		} else
 		{
 			printf("  Failed\n");
+			++failed;
 		}
 		n = n->next;
 	}
+	return failed == 0 ? 0 : 1;
 }
 
 bool assertEquals(int a, int b)
@@ -21,7 +21,7 @@ bool name()
 #define TOKENPASTE2(x, y) TOKENPASTE(x, y)
 #define MOCK(name) TOKENPASTE2(name, __COUNTER__)
 
-#define ASSERT_EQUALS(a, b)		if(!assertEquals(a, b)) return;
+#define ASSERT_EQUALS(a, b)		if(!assertEquals(a, b)) return false;
 
 bool assertEquals(int a, int b);
 
@@ -0,0 +1,130 @@
+#include "test/test.hpp"
+
+#include "components/dirty_region.cpp"
+
+/**
+ * Sums up the area of all rectangles in the region.
+ */
+static int regionArea(const dirty_region_t& region)
+{
+	int total = 0;
+	for(int i = 0; i < region.getCount(); i++)
+		total += region.get(i).width * region.get(i).height;
+	return total;
+}
+
+/**
+ * Checks whether the rectangle is completely covered by one rectangle of the region.
+ */
+static bool regionCovers(const dirty_region_t& region, g_rectangle rect)
+{
+	for(int i = 0; i < region.getCount(); i++)
+	{
+		g_rectangle r = region.get(i);
+		if(rect.x >= r.x && rect.y >= r.y && rect.x + rect.width <= r.x + r.width && rect.y + rect.height <= r.y + r.height)
+			return true;
+	}
+	return false;
+}
+
+TEST(dirtyRegionAddKeepsDistantRectangles)
+{
+	dirty_region_t region;
+	region.add(g_rectangle(0, 0, 10, 10));
+	region.add(g_rectangle(500, 500, 10, 10));
+
+	ASSERT_EQUALS(2, region.getCount());
+	ASSERT_EQUALS(200, regionArea(region));
+	return true;
+}
+
+TEST(dirtyRegionAddMergesOverlapping)
+{
+	dirty_region_t region;
+	region.add(g_rectangle(0, 0, 100, 100));
+	region.add(g_rectangle(50, 0, 100, 100));
+
+	ASSERT_EQUALS(1, region.getCount());
+	ASSERT_EQUALS(true, region.get(0) == g_rectangle(0, 0, 150, 100));
+	return true;
+}
+
+TEST(dirtyRegionAddIgnoresContainedAndEmpty)
+{
+	dirty_region_t region;
+	region.add(g_rectangle(0, 0, 100, 100));
+	region.add(g_rectangle(10, 10, 20, 20));
+	region.add(g_rectangle(500, 500, 0, 10));
+	region.add(g_rectangle(500, 500, 10, -1));
+
+	ASSERT_EQUALS(1, region.getCount());
+	ASSERT_EQUALS(true, region.get(0) == g_rectangle(0, 0, 100, 100));
+	return true;
+}
+
+TEST(dirtyRegionAddMergesWhenFull)
+{
+	dirty_region_t region;
+	g_rectangle added[DIRTY_REGION_MAXIMUM_RECTANGLES + 1];
+	for(int i = 0; i < DIRTY_REGION_MAXIMUM_RECTANGLES + 1; i++)
+	{
+		added[i] = g_rectangle(i * 100, (i % 2) * 100, 10, 10);
+		region.add(added[i]);
+	}
+
+	ASSERT_EQUALS(true, region.getCount() <= DIRTY_REGION_MAXIMUM_RECTANGLES);
+	for(int i = 0; i < DIRTY_REGION_MAXIMUM_RECTANGLES + 1; i++)
+		ASSERT_EQUALS(true, regionCovers(region, added[i]));
+	return true;
+}
+
+TEST(dirtyRegionSubtractSplits)
+{
+	dirty_region_t region;
+	region.add(g_rectangle(0, 0, 100, 100));
+	region.subtract(g_rectangle(25, 25, 50, 50));
+
+	ASSERT_EQUALS(4, region.getCount());
+	ASSERT_EQUALS(100 * 100 - 50 * 50, regionArea(region));
+	ASSERT_EQUALS(false, region.intersects(g_rectangle(25, 25, 50, 50)));
+	ASSERT_EQUALS(true, regionCovers(region, g_rectangle(0, 0, 100, 25)));
+	ASSERT_EQUALS(true, regionCovers(region, g_rectangle(0, 75, 100, 25)));
+	ASSERT_EQUALS(true, regionCovers(region, g_rectangle(0, 25, 25, 50)));
+	ASSERT_EQUALS(true, regionCovers(region, g_rectangle(75, 25, 25, 50)));
+	return true;
+}
+
+TEST(dirtyRegionSubtractEdges)
+{
+	dirty_region_t region;
+	region.add(g_rectangle(0, 0, 100, 100));
+
+	// a cut next to the region changes nothing
+	region.subtract(g_rectangle(100, 0, 50, 50));
+	ASSERT_EQUALS(1, region.getCount());
+	ASSERT_EQUALS(true, region.get(0) == g_rectangle(0, 0, 100, 100));
+
+	// a cut over one side leaves a single piece
+	region.subtract(g_rectangle(50, -10, 100, 200));
+	ASSERT_EQUALS(1, region.getCount());
+	ASSERT_EQUALS(true, region.get(0) == g_rectangle(0, 0, 50, 100));
+
+	// a covering cut empties the region
+	region.subtract(g_rectangle(-10, -10, 200, 200));
+	ASSERT_EQUALS(true, region.isEmpty());
+	return true;
+}
+
+TEST(dirtyRegionSubtractKeepsRegionWhenFull)
+{
+	dirty_region_t region;
+	for(int i = 0; i < DIRTY_REGION_MAXIMUM_RECTANGLES; i++)
+		region.add(g_rectangle(i * 100, 0, 10, 100));
+	ASSERT_EQUALS(DIRTY_REGION_MAXIMUM_RECTANGLES, region.getCount());
+
+	// splitting every rectangle would need twice the space, the region must stay as it is
+	region.subtract(g_rectangle(0, 40, 10000, 20));
+	ASSERT_EQUALS(DIRTY_REGION_MAXIMUM_RECTANGLES, region.getCount());
+	ASSERT_EQUALS(DIRTY_REGION_MAXIMUM_RECTANGLES * 10 * 100, regionArea(region));
+	return true;
+}
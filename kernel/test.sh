@@ -25,7 +25,7 @@ mkdir $OBJDIR
 for file in $(find "src/test" -iname "*.cpp" -o -iname "*.c"); do
 	out=`sourceToObject $file`
 	list $out
-	$CXX -c $file -o "$OBJDIR/$out" -Isrc -Iinclude -Iinc -fpermissive -w $CXX_FLAGS
+	$CXX -c $file -o "$OBJDIR/$out" -Isrc -Iinclude -Iinc -I../libapi/inc -I../libuser/inc -I../libuser/src -I../applications/windowserver/src -fpermissive -w $CXX_FLAGS
 	failOnError
 done
 
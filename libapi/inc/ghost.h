@@ -27,6 +27,7 @@
 #include "ghost/system.h"
 #include "ghost/ramdisk.h"
 #include "ghost/ipc.h"
+#include "ghost/async.h"
 #include "ghost/types.h"
 #include "ghost/fs.h"
 #include "ghost/calls/calls.h"
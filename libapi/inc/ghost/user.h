@@ -173,6 +173,56 @@ g_fd g_open_fs(const char* path, g_file_flag_mode flags, g_fs_open_status* out_s
  */
 g_fs_close_status g_close(g_fd fd);
 
+/**
+ * Removes a file from its folder. Its contents are freed once it is no
+ * longer open. Only supported by some file systems.
+ *
+ * @param path
+ * 		the path of the file
+ *
+ * @return one of the {g_fs_unlink_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_unlink_status g_unlink(const char* path);
+
+/**
+ * Writes data of the file that the kernel still holds in its page cache
+ * back to the file system.
+ *
+ * @param fd
+ * 		the file descriptor
+ *
+ * @return one of the {g_fs_flush_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_flush_status g_flush(g_fd fd);
+
+/**
+ * Waits until any of the given file descriptors is ready for the requested events,
+ * or optionally until a message arrives in the message queue of the calling task.
+ * Entries with a negative file descriptor are ignored.
+ *
+ * @param entries
+ * 		file descriptors to poll, the revents of each entry are filled
+ * @param count
+ * 		number of entries
+ * @param messages
+ * 		whether to also wait for a message
+ * @param timeout
+ * 		maximum number of milliseconds to wait, zero to return immediately
+ * 		or {G_FS_POLL_INFINITE} to wait without timeout
+ * @param out_messages_ready
+ * 		is set to whether a message is available, may be null
+ *
+ * @return the number of ready entries including the message queue,
+ * 		zero if the timeout elapsed
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_poll(g_fs_poll_entry* entries, uint32_t count, g_bool messages, int32_t timeout, g_bool* out_messages_ready);
+
 /**
  * Retrieves the length of a file in bytes.
  *
@@ -214,6 +264,28 @@ g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_director
 g_fs_directory_entry* g_read_directory(g_fs_directory_iterator* iterator);
 g_fs_directory_entry* g_read_directory_s(g_fs_directory_iterator* iterator, g_fs_read_directory_status* out_status);
 
+/**
+ * Reads as many entries of a directory as fit into the buffer. Each entry is a
+ * {g_fs_directory_record} followed by its name, the next record starts at the
+ * record length. This is used by {g_read_directory} which should be preferred.
+ *
+ * @param node_id
+ * 		id of the directory, as filled in the iterator when opening it
+ * @param cursor
+ * 		position to continue at, zero for the first call; is updated by the call
+ * @param buffer
+ * 		target buffer
+ * @param length
+ * 		length of the buffer
+ * @param out_status
+ * 		is filled with the status code
+ *
+ * @return the number of bytes written to the buffer
+ *
+ * @security-level APPLICATION
+ */
+uint32_t g_read_directory_entries(g_fs_virt_id node_id, uint64_t* cursor, void* buffer, uint32_t length, g_fs_read_directory_status* out_status);
+
 /**
  * Closes a directory.
  *
@@ -367,6 +439,46 @@ int32_t g_read_s(g_fd fd, void* buffer, uint64_t length, g_fs_read_status* out_s
 int32_t g_write(g_fd fd, const void* buffer, uint64_t length);
 int32_t g_write_s(g_fd fd, const void* buffer, uint64_t length, g_fs_write_status* out_status);
 
+/**
+ * Reads bytes from the file into multiple buffers, filling each buffer
+ * before continuing with the next one.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vector
+ * 		array of target buffers
+ * @param count
+ * 		number of buffers in the array
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_read_status} codes
+ *
+ * @return if the read was successful the total length of bytes or
+ * 		zero if EOF, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_readv(g_fd fd, g_fs_iovec* vector, int32_t count);
+int32_t g_readv_s(g_fd fd, g_fs_iovec* vector, int32_t count, g_fs_read_status* out_status);
+
+/**
+ * Writes bytes from multiple buffers to the file with a single call.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vector
+ * 		array of source buffers
+ * @param count
+ * 		number of buffers in the array
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_write_status} codes
+ *
+ * @return if successful the total number of bytes that were written, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_writev(g_fd fd, const g_fs_iovec* vector, int32_t count);
+int32_t g_writev_s(g_fd fd, const g_fs_iovec* vector, int32_t count, g_fs_write_status* out_status);
+
 /**
  * Returns the next transaction id that can be used for messaging.
  * When sending a message, a transaction can be added so that one can wait
@@ -411,6 +523,24 @@ void* g_alloc_mem(int32_t size);
  */
 void* g_share_mem(void* memory, int32_t size, g_pid pid);
 
+/**
+ * Performs multiple system calls with a single kernel entry. Only calls that the
+ * kernel allows for batching are executed (like message sending and closing files),
+ * each entry is marked if it was executed. Calls are executed in order: if one of
+ * them has to wait, the batch stops after it; if one can't be executed in the
+ * batch, the batch stops before it.
+ *
+ * @param entries
+ * 		array of calls, each with its call id and data
+ * @param count
+ * 		number of entries
+ *
+ * @return the number of executed calls
+ *
+ * @security-level APPLICATION
+ */
+uint32_t g_batch(g_syscall_batch_entry* entries, uint32_t count);
+
 /**
  * Yields, causing a switch to the next process.
  *
@@ -565,6 +695,164 @@ g_message_receive_status g_receive_message_t(void* buf, size_t max, g_message_tr
 g_message_receive_status g_receive_message_tm(void* buf, size_t max, g_message_transaction tx, g_message_receive_mode mode);
 g_message_receive_status g_receive_message_tmb(void* buf, size_t max, g_message_transaction tx, g_message_receive_mode mode, uint8_t* break_condition);
 
+/**
+ * Creates a single-producer/single-consumer message ring in the executing processes
+ * address space. The ring can then be shared with the consuming process using
+ * {g_ring_share}. Writing and reading does not require any system call unless one
+ * side has to block.
+ *
+ * @param capacity
+ * 		minimum number of content bytes, rounded up to a power of two
+ *
+ * @return the ring header, or 0 if failed
+ *
+ * @security-level APPLICATION
+ */
+g_ring_header* g_ring_create(uint32_t capacity);
+
+/**
+ * Shares a message ring with another process.
+ *
+ * @param ring
+ * 		the ring created with {g_ring_create}
+ * @param pid
+ * 		the id of the target process
+ *
+ * @return a pointer to the ring within the target address space, or 0 if failed
+ *
+ * @security-level APPLICATION
+ */
+g_ring_header* g_ring_share(g_ring_header* ring, g_pid pid);
+
+/**
+ * Writes a message to the ring. Only one task may write to a ring.
+ *
+ * The mode specifies how the function shall block:
+ * - {G_MESSAGE_SEND_MODE_BLOCKING} the executing task will block until the ring
+ * 		has enough space for the message
+ * - {G_MESSAGE_SEND_MODE_NON_BLOCKING} the function will return {G_MESSAGE_SEND_STATUS_QUEUE_FULL}
+ * 		if the ring has not enough space
+ *
+ * @param ring
+ * 		the ring to write to
+ * @param buf
+ * 		message content buffer
+ * @param len
+ * 		number of bytes to copy from the buffer
+ * @param-opt mode
+ * 		determines how the function blocks when given, default is {G_MESSAGE_SEND_MODE_BLOCKING}
+ *
+ * @return one of the <g_message_send_status> codes
+ *
+ * @security-level APPLICATION
+ */
+g_message_send_status g_ring_write(g_ring_header* ring, void* buf, size_t len);
+g_message_send_status g_ring_write_m(g_ring_header* ring, void* buf, size_t len, g_message_send_mode mode);
+
+/**
+ * Reads the next message from the ring. Only one task may read from a ring.
+ * Different from {g_receive_message}, only the message content is copied
+ * to the buffer.
+ *
+ * The mode specifies how the function shall block:
+ * - {G_MESSAGE_RECEIVE_MODE_BLOCKING} the executing task will block until a
+ * 		message is available
+ * - {G_MESSAGE_RECEIVE_MODE_NON_BLOCKING} the function will return {G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY}
+ * 		if the ring is empty
+ *
+ * @param ring
+ * 		the ring to read from
+ * @param buf
+ * 		output buffer
+ * @param max
+ * 		maximum number of bytes to copy to the buffer
+ * @param out_len
+ * 		is filled with the length of the message
+ * @param-opt mode
+ * 		determines how the function blocks when given, default is {G_MESSAGE_RECEIVE_MODE_BLOCKING}
+ *
+ * @return one of the <g_message_receive_status> codes
+ *
+ * @security-level APPLICATION
+ */
+g_message_receive_status g_ring_read(g_ring_header* ring, void* buf, size_t max, size_t* out_len);
+g_message_receive_status g_ring_read_m(g_ring_header* ring, void* buf, size_t max, size_t* out_len, g_message_receive_mode mode);
+
+/**
+ * Sets up asynchronous system calls for the executing process. Creates a submission
+ * and a completion ring that are shared with the kernel. Calls are added to the
+ * submission ring with {g_async_push} and handed to the kernel with {g_async_submit},
+ * the kernel then executes them within worker threads.
+ *
+ * Supported are the filesystem calls that operate on descriptors or paths and
+ * message sending and receiving; messages are sent and received on behalf of the
+ * task that submitted the call.
+ *
+ * @param entries
+ * 		number of entries per ring, rounded up to a power of two
+ *
+ * @return the rings, or 0 if failed
+ *
+ * @security-level APPLICATION
+ */
+g_async_ring* g_async_setup(uint32_t entries);
+
+/**
+ * Adds a call to the submission ring. The call structure must stay valid until
+ * the completion for this call was taken from the completion ring.
+ *
+ * @param ring
+ * 		the rings created with {g_async_setup}
+ * @param call
+ * 		the system call id, like {G_SYSCALL_FS_READ}
+ * @param data
+ * 		the call structure, like {g_syscall_fs_read}
+ * @param user_data
+ * 		value that is passed back in the completion
+ *
+ * @return whether the submission ring had space for the call
+ *
+ * @security-level APPLICATION
+ */
+g_bool g_async_push(g_async_ring* ring, uint32_t call, void* data, uint32_t user_data);
+
+/**
+ * Hands the calls in the submission ring to the kernel. Calls are only taken
+ * while the completion ring has space for their completions; calls that were not
+ * taken stay in the submission ring.
+ *
+ * @return the number of calls that were taken
+ *
+ * @security-level APPLICATION
+ */
+uint32_t g_async_submit();
+
+/**
+ * Waits until a number of completions is available in the completion ring.
+ *
+ * @param minimum
+ * 		number of completions to wait for, zero doesn't block
+ *
+ * @return the number of available completions
+ *
+ * @security-level APPLICATION
+ */
+uint32_t g_async_wait(uint32_t minimum);
+
+/**
+ * Takes a completion from the completion ring without blocking.
+ *
+ * @param ring
+ * 		the rings created with {g_async_setup}
+ * @param out
+ * 		is filled with the completion
+ *
+ * @return whether a completion was available
+ *
+ * @security-level APPLICATION
+ */
+g_bool g_async_pop(g_async_ring* ring, g_async_completion* out);
+
 /**
  * Registers the executing task for the given identifier.
  *
@@ -604,6 +892,23 @@ g_tid g_task_get_id(const char* identifier);
  */
 void* g_map_mmio(void* addr, uint32_t size);
 
+/**
+ * Maps the given physical address to the executing processes address space
+ * with the given mapping flags.
+ *
+ * @param addr
+ * 		the physical memory address that should be mapped
+ * @param size
+ * 		the size that should be mapped
+ * @param flags
+ * 		mapping flags, for example G_MMIO_FLAG_WRITE_COMBINING for framebuffers
+ *
+ * @return a pointer to the mapped area within the executing processes address space
+ *
+ * @security-level DRIVER
+ */
+void* g_map_mmio_f(void* addr, uint32_t size, g_mmio_flags flags);
+
 /**
  * Unmaps the given memory area.
  *
@@ -780,28 +1085,39 @@ g_fs_pipe_status g_pipe_b(g_fd* out_write, g_fd* out_read, g_bool blocking);
  * @param out_mountpoint_id
  * 		is filled with the node id of the mountpoint on success
  *
- * @param out_transaction_storage
- * 		is filled with the address of the transaction storage
+ * @param out_ring
+ * 		is filled with the address of the request ring
  *
  * @return one of the {g_fs_register_as_delegate_status} codes
  *
  * @security-level DRIVER
  */
 g_fs_register_as_delegate_status g_fs_register_as_delegate(const char* name, g_fs_phys_id phys_mountpoint_id, g_fs_virt_id* out_mountpoint_id,
-		g_address* out_transaction_storage);
+		g_fs_tasked_delegate_ring** out_ring);
 
 /**
- * Updates the status for a filesystem transaction.
+ * Takes the next request from the request ring of a delegate. Blocks until the
+ * kernel posts a request.
  *
- * @param id
- * 		the transaction id
+ * @param ring
+ * 		the request ring
  *
- * @param status
- * 		the transaction status
+ * @return the request
+ *
+ * @security-level DRIVER
+ */
+g_fs_tasked_delegate_request* g_fs_next_request(g_fs_tasked_delegate_ring* ring);
+
+/**
+ * Marks a request as completed after its results were written. The task that
+ * waits for the request continues and the request must no longer be accessed.
+ *
+ * @param request
+ * 		the completed request
  *
  * @security-level DRIVER
  */
-void g_fs_set_transaction_status(g_fs_transaction_id id, g_fs_transaction_status status);
+void g_fs_complete_request(g_fs_tasked_delegate_request* request);
 
 /**
  * Creates a filesystem node.
@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+#include "__internal.h"
+
+/**
+ *
+ */
+void __g_ring_copy_in(g_ring_header* ring, uint32_t position, const void* src, uint32_t length) {
+
+	uint32_t offset = position & (ring->capacity - 1);
+	uint32_t first = ring->capacity - offset;
+	if (first > length) {
+		first = length;
+	}
+
+	__g_memcpy(G_RING_CONTENT(ring) + offset, src, first);
+	__g_memcpy(G_RING_CONTENT(ring), ((const uint8_t*) src) + first, length - first);
+}
+
+/**
+ *
+ */
+void __g_ring_copy_out(g_ring_header* ring, uint32_t position, void* dest, uint32_t length) {
+
+	uint32_t offset = position & (ring->capacity - 1);
+	uint32_t first = ring->capacity - offset;
+	if (first > length) {
+		first = length;
+	}
+
+	__g_memcpy(dest, G_RING_CONTENT(ring) + offset, first);
+	__g_memcpy(((uint8_t*) dest) + first, G_RING_CONTENT(ring), length - first);
+}
@@ -42,6 +42,13 @@ size_t __g_strlen(const char* s);
  */
 g_bool __g_atomic_lock(g_atom* atom_1, g_atom* atom_2, bool set_on_finish, bool is_try, g_bool has_timeout, uint64_t timeout);
 
+/**
+ * Copies data into/out of the content area of a message ring, wrapping
+ * around at the end of the content area.
+ */
+void __g_ring_copy_in(g_ring_header* ring, uint32_t position, const void* src, uint32_t length);
+void __g_ring_copy_out(g_ring_header* ring, uint32_t position, void* dest, uint32_t length);
+
 __END_C
 
 #endif
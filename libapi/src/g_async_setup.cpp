@@ -0,0 +1,48 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+g_async_ring* g_async_setup(uint32_t entries) {
+
+	uint32_t size = 1;
+	while (size < entries) {
+		size <<= 1;
+	}
+
+	g_async_ring* ring = (g_async_ring*) g_alloc_mem(G_ASYNC_RING_SIZE(size));
+	if (ring == 0) {
+		return 0;
+	}
+
+	g_syscall_async_setup data;
+	data.ring = ring;
+	data.entries = size;
+	g_syscall(G_SYSCALL_ASYNC_SETUP, (uint32_t) &data);
+
+	if (data.status != G_ASYNC_SETUP_STATUS_SUCCESSFUL) {
+		g_unmap(ring);
+		return 0;
+	}
+	return ring;
+}
@@ -23,10 +23,9 @@
 /**
  *
  */
-void g_fs_set_transaction_status(g_fs_transaction_id id, g_fs_transaction_status status) {
+uint32_t g_async_submit() {
 
-	g_syscall_fs_set_transaction_status data;
-	data.transaction = id;
-	data.status = status;
-	g_syscall(G_SYSCALL_FS_SET_TRANSACTION_STATUS, (uint32_t) &data);
+	g_syscall_async_submit data;
+	g_syscall(G_SYSCALL_ASYNC_SUBMIT, (uint32_t) &data);
+	return data.submitted;
 }
@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+g_fs_tasked_delegate_request* g_fs_next_request(g_fs_tasked_delegate_ring* ring) {
+
+	// wait until there is a request, the kernel clears the atom when it posted one
+	uint32_t tail = ring->tail;
+	while (ring->head == tail) {
+		ring->driver_waiting = true;
+		__sync_synchronize();
+		if (ring->head != tail) {
+			ring->driver_waiting = false;
+			break;
+		}
+		g_atomic_block((g_atom*) &ring->driver_waiting);
+	}
+	__sync_synchronize();
+
+	uint32_t index = ring->queue[tail % G_FS_TASKED_DELEGATE_REQUESTS];
+	ring->tail = tail + 1;
+	return &ring->requests[index];
+}
@@ -23,13 +23,14 @@
 /**
  *
  */
-int g_fs_register_as_delegate(const char* name, g_fs_phys_id phys_mountpoint_id, g_fs_virt_id* out_mountpoint_id, g_address* out_transaction_storage) {
+g_fs_register_as_delegate_status g_fs_register_as_delegate(const char* name, g_fs_phys_id phys_mountpoint_id, g_fs_virt_id* out_mountpoint_id,
+		g_fs_tasked_delegate_ring** out_ring) {
 
 	g_syscall_fs_register_as_delegate data;
 	data.name = (char*) name;
 	data.phys_mountpoint_id = phys_mountpoint_id;
 	g_syscall(G_SYSCALL_FS_REGISTER_AS_DELEGATE, (uint32_t) &data);
 	*out_mountpoint_id = data.mountpoint_id;
-	*out_transaction_storage = data.transaction_storage;
+	*out_ring = data.ring;
 	return data.result;
 }
@@ -27,6 +27,7 @@ void* g_map_mmio(void* physicalAddress, uint32_t size) {
 	g_syscall_map_mmio data;
 	data.physicalAddress = (g_physical_address) physicalAddress;
 	data.size = size;
+	data.flags = G_MMIO_FLAG_NONE;
 	g_syscall(G_SYSCALL_MAP_MMIO_AREA, (uint32_t) &data);
 	return data.virtualAddress;
 }
@@ -34,7 +34,12 @@ g_fs_directory_iterator* g_open_directory(const char* path) {
 g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_directory_status* out_status) {
 
 	g_fs_directory_iterator* iterator = (g_fs_directory_iterator*) malloc(sizeof(g_fs_directory_iterator));
-	iterator->entry_buffer.name = (char*) malloc(G_FILENAME_MAX);
+	iterator->entry_buffer.name = (char*) malloc(G_FILENAME_MAX + 1);
+	iterator->records = (uint8_t*) malloc(G_FS_DIRECTORY_ITERATOR_BUFFER_SIZE);
+	iterator->records_length = 0;
+	iterator->records_offset = 0;
+	iterator->cursor = 0;
+	iterator->finished = false;
 
 	g_syscall_fs_open_directory data;
 	data.path = (char*) path;
@@ -49,6 +54,8 @@ g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_director
 		return iterator;
 	}
 
+	free(iterator->records);
+	free(iterator->entry_buffer.name);
 	free(iterator);
 	return 0;
 }
@@ -0,0 +1,39 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost.h"
+
+/**
+ *
+ */
+int32_t g_poll(g_fs_poll_entry* entries, uint32_t count, g_bool messages, int32_t timeout, g_bool* out_messages_ready) {
+
+	g_syscall_fs_poll data;
+	data.entries = entries;
+	data.count = count;
+	data.messages = messages;
+	data.timeout = timeout;
+	g_syscall(G_SYSCALL_FS_POLL, (uint32_t) &data);
+
+	if (out_messages_ready) {
+		*out_messages_ready = data.messages_ready;
+	}
+	return data.result;
+}
@@ -20,6 +20,7 @@
 
 #include "ghost/user.h"
 #include "ghost/stdint.h"
+#include "__internal.h"
 #include <stdarg.h>
 
 // redirect
@@ -32,17 +33,39 @@ g_fs_directory_entry* g_read_directory(g_fs_directory_iterator* iterator) {
  */
 g_fs_directory_entry* g_read_directory_s(g_fs_directory_iterator* iterator, g_fs_read_directory_status* out_status) {
 
-	g_syscall_fs_read_directory data;
-	data.iterator = iterator;
-	g_syscall(G_SYSCALL_FS_READ_DIRECTORY, (uint32_t) &data);
+	// refill the record buffer once all records were handed out
+	if (iterator->records_offset >= iterator->records_length) {
+		g_fs_read_directory_status status = G_FS_READ_DIRECTORY_EOD;
+		if (!iterator->finished) {
+			iterator->records_length = g_read_directory_entries(iterator->node_id, &iterator->cursor, iterator->records,
+			G_FS_DIRECTORY_ITERATOR_BUFFER_SIZE, &status);
+			iterator->records_offset = 0;
+		}
 
-	if (out_status) {
-		*out_status = data.status;
-	}
+		if (status != G_FS_READ_DIRECTORY_SUCCESSFUL) {
+			iterator->records_length = 0;
+			iterator->finished = true;
 
-	if (data.status == G_FS_READ_DIRECTORY_SUCCESSFUL) {
-		return &iterator->entry_buffer;
+			if (out_status) {
+				*out_status = status;
+			}
+			return 0;
+		}
 	}
 
-	return 0;
+	g_fs_directory_record* record = (g_fs_directory_record*) &iterator->records[iterator->records_offset];
+	iterator->records_offset += record->record_length;
+
+	g_fs_directory_entry* entry = &iterator->entry_buffer;
+	entry->node_id = record->node_id;
+	entry->type = record->type;
+	entry->length = record->length;
+	uint32_t name_length = record->name_length > G_FILENAME_MAX ? G_FILENAME_MAX : record->name_length;
+	__g_memcpy(entry->name, G_FS_DIRECTORY_RECORD_NAME(record), name_length);
+	entry->name[name_length] = 0;
+
+	if (out_status) {
+		*out_status = G_FS_READ_DIRECTORY_SUCCESSFUL;
+	}
+	return entry;
 }
@@ -0,0 +1,40 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+uint32_t g_read_directory_entries(g_fs_virt_id node_id, uint64_t* cursor, void* buffer, uint32_t length, g_fs_read_directory_status* out_status) {
+
+	g_syscall_fs_read_directory data;
+	data.node_id = node_id;
+	data.cursor = *cursor;
+	data.buffer = (uint8_t*) buffer;
+	data.length = length;
+	g_syscall(G_SYSCALL_FS_READ_DIRECTORY, (uint32_t) &data);
+
+	*cursor = data.cursor;
+	if (out_status) {
+		*out_status = data.status;
+	}
+	return data.result;
+}
@@ -0,0 +1,70 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+#include "__internal.h"
+
+// redirect
+g_message_receive_status g_ring_read(g_ring_header* ring, void* buf, size_t max, size_t* out_len) {
+	return g_ring_read_m(ring, buf, max, out_len, G_MESSAGE_RECEIVE_MODE_BLOCKING);
+}
+
+/**
+ *
+ */
+g_message_receive_status g_ring_read_m(g_ring_header* ring, void* buf, size_t max, size_t* out_len, g_message_receive_mode mode) {
+
+	// wait until there is a message, the writer clears the atom when it published something
+	uint32_t tail = ring->tail;
+	while (ring->head == tail) {
+		if (mode == G_MESSAGE_RECEIVE_MODE_NON_BLOCKING) {
+			return G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY;
+		}
+
+		ring->reader_waiting = true;
+		__sync_synchronize();
+		if (ring->head != tail) {
+			ring->reader_waiting = false;
+			break;
+		}
+		g_atomic_block((g_atom*) &ring->reader_waiting);
+	}
+	__sync_synchronize();
+
+	uint32_t length;
+	__g_ring_copy_out(ring, tail, &length, sizeof(uint32_t));
+	if (out_len) {
+		*out_len = length;
+	}
+	if (length > max) {
+		return G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE;
+	}
+	__g_ring_copy_out(ring, tail + sizeof(uint32_t), buf, length);
+
+	// release the space before checking whether the writer must be woken
+	__sync_synchronize();
+	ring->tail = tail + G_RING_RECORD_LENGTH(length);
+	__sync_synchronize();
+
+	if (ring->writer_waiting) {
+		ring->writer_waiting = false;
+	}
+	return G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
+}
@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+#include "__internal.h"
+
+// redirect
+g_message_send_status g_ring_write(g_ring_header* ring, void* buf, size_t len) {
+	return g_ring_write_m(ring, buf, len, G_MESSAGE_SEND_MODE_BLOCKING);
+}
+
+/**
+ *
+ */
+g_message_send_status g_ring_write_m(g_ring_header* ring, void* buf, size_t len, g_message_send_mode mode) {
+
+	// check the length before aligning it, lengths close to the limit would overflow
+	if (len > ring->capacity) {
+		return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
+	}
+
+	uint32_t record = G_RING_RECORD_LENGTH(len);
+	if (record > ring->capacity) {
+		return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
+	}
+
+	// wait until there is enough space, the reader clears the atom when it consumed something
+	uint32_t head = ring->head;
+	while (ring->capacity - (head - ring->tail) < record) {
+		if (mode == G_MESSAGE_SEND_MODE_NON_BLOCKING) {
+			return G_MESSAGE_SEND_STATUS_QUEUE_FULL;
+		}
+
+		ring->writer_waiting = true;
+		__sync_synchronize();
+		if (ring->capacity - (head - ring->tail) >= record) {
+			ring->writer_waiting = false;
+			break;
+		}
+		g_atomic_block((g_atom*) &ring->writer_waiting);
+	}
+
+	uint32_t length = len;
+	__g_ring_copy_in(ring, head, &length, sizeof(uint32_t));
+	__g_ring_copy_in(ring, head + sizeof(uint32_t), buf, len);
+
+	// publish the message before checking whether the reader must be woken
+	__sync_synchronize();
+	ring->head = head + record;
+	__sync_synchronize();
+
+	if (ring->reader_waiting) {
+		ring->reader_waiting = false;
+	}
+	return G_MESSAGE_SEND_STATUS_SUCCESSFUL;
+}
@@ -0,0 +1,56 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_LIBC_POLL__
+#define __GHOST_LIBC_POLL__
+
+#include "ghost/common.h"
+#include "ghost/fs.h"
+
+__BEGIN_C
+
+/**
+ * Layout and event values are equal to the kernels {g_fs_poll_entry},
+ * arrays of this structure are passed to the kernel directly.
+ */
+struct pollfd {
+	int fd;
+	short events;
+	short revents;
+};
+
+typedef unsigned int nfds_t;
+
+#define POLLIN			G_FS_POLL_READ
+#define POLLOUT			G_FS_POLL_WRITE
+#define POLLNVAL		G_FS_POLL_INVALID
+#define POLLPRI			0x0008
+#define POLLERR			0x0010
+#define POLLHUP			0x0020
+#define POLLRDNORM		POLLIN
+#define POLLWRNORM		POLLOUT
+#define POLLRDBAND		0x0040
+#define POLLWRBAND		0x0080
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout);
+
+__END_C
+
+#endif
@@ -0,0 +1,47 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_LIBC_SYS_SELECT__
+#define __GHOST_LIBC_SYS_SELECT__
+
+#include "ghost/common.h"
+#include "sys/types.h"
+#include "sys/time.h"
+
+__BEGIN_C
+
+#define FD_SETSIZE		1024
+
+#define __FD_BITS		(8 * sizeof(unsigned long))
+
+typedef struct {
+	unsigned long fds_bits[FD_SETSIZE / __FD_BITS];
+} fd_set;
+
+#define FD_ZERO(set)		do { for (size_t __i = 0; __i < FD_SETSIZE / __FD_BITS; __i++) (set)->fds_bits[__i] = 0; } while (0)
+#define FD_SET(fd, set)		((set)->fds_bits[(fd) / __FD_BITS] |= (1UL << ((fd) % __FD_BITS)))
+#define FD_CLR(fd, set)		((set)->fds_bits[(fd) / __FD_BITS] &= ~(1UL << ((fd) % __FD_BITS)))
+#define FD_ISSET(fd, set)	(((set)->fds_bits[(fd) / __FD_BITS] & (1UL << ((fd) % __FD_BITS))) != 0)
+
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds, struct timeval* timeout);
+
+__END_C
+
+#endif
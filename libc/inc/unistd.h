@@ -62,6 +62,11 @@ long int tell(int filedes);
  */
 int close(int filedes);
 
+/**
+ * POSIX wrapper for <g_flush>
+ */
+int fsync(int filedes);
+
 /**
  * POSIX wrapper for <g_sbrk>
  */
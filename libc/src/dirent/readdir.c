@@ -36,10 +36,20 @@ struct dirent* readdir(DIR* dir) {
 
 		dirent* ent = dir->entbuf;
 		ent->d_fileno = entry->node_id;
-		dir->entbuf->d_dev = -1; // TODO
-		dir->entbuf->d_namlen = strlen(entry->name);
-		dir->entbuf->d_reclen = -1; // TODO
-		dir->entbuf->d_type = -1; // TODO
+		ent->d_dev = -1; // TODO
+		ent->d_namlen = strlen(entry->name);
+		ent->d_reclen = sizeof(struct dirent);
+
+		if (entry->type == G_FS_NODE_TYPE_FILE) {
+			ent->d_type = DT_REG;
+		} else if (entry->type == G_FS_NODE_TYPE_PIPE) {
+			ent->d_type = DT_FIFO;
+		} else if (entry->type == G_FS_NODE_TYPE_FOLDER || entry->type == G_FS_NODE_TYPE_MOUNTPOINT || entry->type == G_FS_NODE_TYPE_ROOT) {
+			ent->d_type = DT_DIR;
+		} else {
+			ent->d_type = DT_UNKNOWN;
+		}
+
 		strcpy(ent->d_name, entry->name);
 		return ent;
 
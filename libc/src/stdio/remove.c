@@ -27,8 +27,19 @@
  */
 int remove(const char *filename) {
 
-	klog("warning: remove(\"%s\") is not implemented", filename);
-	return 0;
+	g_fs_unlink_status status = g_unlink(filename);
+	if(status == G_FS_UNLINK_SUCCESSFUL) {
+		return 0;
+	}
+
+	if(status == G_FS_UNLINK_NOT_FOUND) {
+		errno = ENOENT;
+	} else if(status == G_FS_UNLINK_NOT_SUPPORTED) {
+		errno = EROFS;
+	} else {
+		errno = EIO;
+	}
+	return -1;
 }
 
 /**
@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "sys/select.h"
+#include "poll.h"
+#include "errno.h"
+#include "stdlib.h"
+#include "limits.h"
+
+/**
+ * Implemented on top of {poll}, only the descriptors that are
+ * contained in any of the sets are passed to the kernel.
+ */
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds, struct timeval* timeout) {
+
+	if (nfds < 0 || nfds > FD_SETSIZE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	int timeout_ms = -1;
+	if (timeout) {
+		if (timeout->tv_sec < 0 || timeout->tv_usec < 0) {
+			errno = EINVAL;
+			return -1;
+		}
+		if (timeout->tv_sec < INT_MAX / 1000 - 1) {
+			timeout_ms = timeout->tv_sec * 1000 + (timeout->tv_usec + 999) / 1000;
+		}
+	}
+
+	struct pollfd* fds = (struct pollfd*) malloc(sizeof(struct pollfd) * (nfds > 0 ? nfds : 1));
+	if (!fds) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	nfds_t count = 0;
+	for (int fd = 0; fd < nfds; fd++) {
+		short events = 0;
+		if (readfds && FD_ISSET(fd, readfds)) {
+			events |= POLLIN;
+		}
+		if (writefds && FD_ISSET(fd, writefds)) {
+			events |= POLLOUT;
+		}
+		if (events || (errorfds && FD_ISSET(fd, errorfds))) {
+			fds[count].fd = fd;
+			fds[count].events = events;
+			fds[count].revents = 0;
+			count++;
+		}
+	}
+
+	int ready = poll(fds, count, timeout_ms);
+	if (ready < 0) {
+		free(fds);
+		return -1;
+	}
+
+	if (readfds) {
+		FD_ZERO(readfds);
+	}
+	if (writefds) {
+		FD_ZERO(writefds);
+	}
+	if (errorfds) {
+		FD_ZERO(errorfds);
+	}
+
+	int result = 0;
+	for (nfds_t i = 0; i < count; i++) {
+		if (fds[i].revents & POLLNVAL) {
+			free(fds);
+			errno = EBADF;
+			return -1;
+		}
+
+		if (readfds && (fds[i].revents & POLLIN)) {
+			FD_SET(fds[i].fd, readfds);
+			result++;
+		}
+		if (writefds && (fds[i].revents & POLLOUT)) {
+			FD_SET(fds[i].fd, writefds);
+			result++;
+		}
+	}
+
+	free(fds);
+	return result;
+}
@@ -22,6 +22,8 @@
 #define GHOSTLIBRARY_GRAPHICS_TEXT_FONT
 
 #include <ghostuser/graphics/text/freetype.hpp>
+#include <ghostuser/graphics/text/glyph_atlas.hpp>
+#include <ghostuser/tasking/lock.hpp>
 #include <ghostuser/io/streams/input_stream.hpp>
 #include <string>
 #include <map>
@@ -53,6 +55,9 @@ private:
 
 	int activeSize;
 
+	std::map<int, g_glyph_atlas*> atlases;
+	g_lock atlasesLock;
+
 public:
 
 	/**
@@ -102,6 +107,16 @@ public:
 		return cairo_face;
 	}
 
+	/**
+	 * Returns the glyph cache of this font for the "size". The atlas is
+	 * created on first use and shared by everyone that renders this font
+	 * in this size.
+	 *
+	 * @param size	the font size
+	 * @return the atlas, or 0 if the font is not okay
+	 */
+	g_glyph_atlas* getAtlas(int size);
+
 };
 
 #endif
@@ -0,0 +1,118 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOSTLIBRARY_GRAPHICS_TEXT_GLYPHATLAS
+#define GHOSTLIBRARY_GRAPHICS_TEXT_GLYPHATLAS
+
+#include <ghostuser/tasking/lock.hpp>
+#include <cairo/cairo.h>
+#include <stdint.h>
+#include <vector>
+#include <map>
+
+#define G_GLYPH_ATLAS_PAGE_SIZE		256
+
+/**
+ * A glyph that was rasterized into an atlas page. The mask is a view on the
+ * region of the page that contains the glyphs alpha values, it is placed at
+ * the offset relative to the glyph origin (on the baseline).
+ */
+struct g_atlas_glyph {
+	cairo_surface_t* mask;
+	int offsetX;
+	int offsetY;
+	int width;
+	int height;
+	double advance;
+};
+
+/**
+ * Cache of pre-rasterized glyph alpha masks for one font face in one size.
+ * Glyphs are rasterized once when first requested and packed into A8 pages
+ * row by row. Painting a glyph is then a single masked composite instead of
+ * rendering its outline.
+ */
+class g_glyph_atlas {
+private:
+	cairo_scaled_font_t* scaledFont;
+	g_lock lock;
+
+	std::vector<cairo_surface_t*> pages;
+	cairo_surface_t* currentPage;
+	int rowX;
+	int rowY;
+	int rowHeight;
+
+	std::map<unsigned long, g_atlas_glyph*> glyphs;
+	std::map<uint32_t, unsigned long> characters;
+
+	/**
+	 * Rasterizes the glyph with the "index" into the current page.
+	 */
+	g_atlas_glyph* rasterize(unsigned long index);
+
+	/**
+	 * Reserves an area of the given size on a page.
+	 *
+	 * @return the page, or 0 if it could not be created
+	 */
+	cairo_surface_t* allocate(int width, int height, int* outX, int* outY);
+
+public:
+	/**
+	 * @param face	the cairo face of the font
+	 * @param size	the font size
+	 */
+	g_glyph_atlas(cairo_font_face_t* face, int size);
+	~g_glyph_atlas();
+
+	/**
+	 * Looks up the glyph with the "index", rasterizing it if necessary.
+	 *
+	 * @return the glyph, or 0 if it could not be rasterized
+	 */
+	g_atlas_glyph* getGlyph(unsigned long index);
+
+	/**
+	 * Looks up the glyph for the unicode "codepoint".
+	 *
+	 * @return the glyph, or 0 if the font can not display it
+	 */
+	g_atlas_glyph* getCharacter(uint32_t codepoint);
+
+	/**
+	 * Paints the "glyph" with the current source of "cr", with its origin
+	 * placed at "x"/"y".
+	 */
+	static void paint(cairo_t* cr, g_atlas_glyph* glyph, double x, double y) {
+		if (glyph && glyph->mask) {
+			cairo_mask_surface(cr, glyph->mask, x + glyph->offsetX, y + glyph->offsetY);
+		}
+	}
+
+	/**
+	 * @return the scaled font that is used for rasterizing
+	 */
+	cairo_scaled_font_t* getScaledFont() {
+		return scaledFont;
+	}
+};
+
+#endif
@@ -26,7 +26,9 @@
 #define G_VBE_DRIVER_IDENTIFIER			"vbedriver"
 
 /**
- *
+ * Information about a video mode. If the video memory holds more than one
+ * screen, "pages" screens lie directly after each other in the LFB and can be
+ * switched between with g_vbe::setDisplayStart.
  */
 struct g_vbe_mode_info {
 	uint16_t resX;
@@ -34,6 +36,7 @@ struct g_vbe_mode_info {
 	uint16_t bpp;
 	uint16_t bpsl;
 	uint32_t lfb;
+	uint16_t pages;
 }__attribute__((packed));
 
 /**
@@ -41,6 +44,7 @@ struct g_vbe_mode_info {
  */
 typedef int g_vbe_command;
 #define G_VBE_COMMAND_SET_MODE	((g_vbe_command) 0)
+#define G_VBE_COMMAND_SET_DISPLAY_START	((g_vbe_command) 1)
 
 /**
  *
@@ -74,12 +78,42 @@ struct g_vbe_set_mode_response {
 	g_vbe_mode_info mode_info;
 }__attribute__((packed));
 
+/**
+ *
+ */
+typedef int g_vbe_set_display_start_status;
+#define G_VBE_SET_DISPLAY_START_STATUS_SUCCESS		((g_vbe_set_display_start_status) 0)
+#define G_VBE_SET_DISPLAY_START_STATUS_FAILED		((g_vbe_set_display_start_status) 1)
+
+/**
+ * Sets the pixel in the LFB that is shown in the upper left corner. The driver
+ * switches during the vertical retrace and responds once the switch is done.
+ */
+struct g_vbe_set_display_start_request {
+	g_vbe_request_header header;
+	uint16_t x;
+	uint16_t y;
+}__attribute__((packed));
+
+/**
+ *
+ */
+struct g_vbe_set_display_start_response {
+	g_vbe_set_display_start_status status;
+}__attribute__((packed));
+
 /**
  *
  */
 class g_vbe {
 public:
 	static bool setMode(uint16_t width, uint16_t height, uint8_t bpp, g_vbe_mode_info& out);
+
+	/**
+	 * Shows the LFB starting at the given pixel, used to switch between
+	 * the pages of a mode. Blocks until the switch is done.
+	 */
+	static bool setDisplayStart(uint16_t x, uint16_t y);
 };
 
 #endif
@@ -23,16 +23,22 @@
 
 #include <ghostuser/ui/component.hpp>
 #include <ghostuser/ui/canvas_buffer_listener.hpp>
+#include <ghostuser/ui/canvas_damage_history.hpp>
 #include <ghostuser/graphics/color_argb.hpp>
+#include <ghostuser/ui/interface_specification.hpp>
 #include <cstdint>
 
 /**
- *
+ * Information about the buffer to paint in. The buffer changes with each
+ * blit, so it must be fetched again before painting the next frame. It always
+ * holds the content of the last blitted frame, unless "fresh" is set, which
+ * means that a new buffer was allocated that has no content yet.
  */
 struct g_canvas_buffer_info {
 	uint8_t* buffer;
 	uint16_t width;
 	uint16_t height;
+	bool fresh;
 };
 
 /**
@@ -43,6 +49,11 @@ protected:
 	g_address currentBuffer;
 	g_address nextBuffer;
 
+	uint8_t backIndex;
+	uint32_t frame;
+	bool fresh;
+	g_canvas_damage_history history;
+
 	/**
 	 * Listener only for user purpose, so a client gets an event once the
 	 * buffer was changed.
@@ -50,15 +61,27 @@ protected:
 	g_canvas_buffer_listener* userListener;
 
 	g_canvas(uint32_t id) :
-			g_component(id), currentBuffer(0), nextBuffer(0), userListener(0) {
+			g_component(id), currentBuffer(0), nextBuffer(0), backIndex(0), frame(0), fresh(true), userListener(0) {
 	}
 
+	/**
+	 * Copies everything that changed since the "since" frame from the
+	 * buffer "source" to the current back buffer.
+	 */
+	void copyForward(uint8_t source, uint32_t since);
+
 public:
 	static g_canvas* create();
 
 	void acknowledgeNewBuffer(g_address address);
 
+	/**
+	 * Presents the buffer, with the given areas being changed since the
+	 * previous blit. This never waits for the window server.
+	 */
 	void blit(g_rectangle rect);
+	void blit(const g_rectangle* rects, int count);
+
 	g_canvas_buffer_info getBuffer();
 
 	void setBufferListener(g_canvas_buffer_listener* l) {
@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOSTLIBRARY_UI_CANVAS_DAMAGE_HISTORY
+#define GHOSTLIBRARY_UI_CANVAS_DAMAGE_HISTORY
+
+#include <ghostuser/ui/interface_specification.hpp>
+#include <ghostuser/graphics/metrics/rectangle.hpp>
+#include <cstdint>
+
+/**
+ * Number of presented frames whose damage is remembered to bring a buffer
+ * up to date. Older buffers are copied completely.
+ */
+#define G_CANVAS_DAMAGE_HISTORY		4
+
+/**
+ *
+ */
+struct g_canvas_frame_damage {
+	uint32_t frame;
+	uint16_t count;
+	g_ui_canvas_damage_rect rects[G_UI_CANVAS_MAXIMUM_DAMAGE];
+};
+
+/**
+ * Remembers the damage of the last presented frames of a canvas, so that a
+ * buffer that is handed back by the window server can be brought up to date
+ * by copying only what changed since it was presented.
+ */
+class g_canvas_damage_history {
+private:
+	g_canvas_frame_damage frames[G_CANVAS_DAMAGE_HISTORY];
+
+public:
+	g_canvas_damage_history() {
+		clear();
+	}
+
+	/**
+	 * Forgets the damage of all frames.
+	 */
+	void clear();
+
+	/**
+	 * Records the damage of a frame. The rectangles are clipped to the given
+	 * size, if there are too many they are joined to a single rectangle.
+	 */
+	const g_canvas_frame_damage& record(uint32_t frame, const g_rectangle* rects, int count, int width, int height);
+
+	/**
+	 * Copies everything that changed after the "since" frame up to "frame"
+	 * from one buffer to the other. If the damage of one of these frames is
+	 * not remembered, the whole buffer is copied.
+	 */
+	void copyForward(uint8_t* to, const uint8_t* from, uint32_t stride, uint32_t size, uint32_t since, uint32_t frame) const;
+};
+
+#endif
@@ -82,6 +82,7 @@ protected:
 		g_ui_create_component_request request;
 		request.header.id = G_UI_PROTOCOL_CREATE_COMPONENT;
 		request.type = COMPONENT_CONSTANT;
+		g_ui::flush_batch();
 		g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_create_component_request), tx);
 
 		// read response
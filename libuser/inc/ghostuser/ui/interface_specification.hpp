@@ -73,6 +73,8 @@ const g_ui_protocol_command_id G_UI_PROTOCOL_GET_BOUNDS = 12;
 const g_ui_protocol_command_id G_UI_PROTOCOL_CANVAS_BLIT = 13;
 const g_ui_protocol_command_id G_UI_PROTOCOL_REGISTER_DESKTOP_CANVAS = 14;
 const g_ui_protocol_command_id G_UI_PROTOCOL_GET_SCREEN_DIMENSION = 15;
+const g_ui_protocol_command_id G_UI_PROTOCOL_GET_FRAME_STATISTICS = 16;
+const g_ui_protocol_command_id G_UI_PROTOCOL_BATCH = 17;
 
 /**
  * Common status for requests
@@ -324,6 +326,52 @@ typedef struct {
 	g_dimension size;
 }__attribute__((packed)) g_ui_get_screen_dimension_response;
 
+/**
+ * Frame time statistics of the window server. Frame times are bucketed in
+ * powers of two: bucket 0 counts frames below 1 ms, bucket i frames of at
+ * least 2^(i-1) ms and below 2^i ms, the last bucket all longer frames.
+ * The totals are the time spent in each stage summed over all frames.
+ */
+#define G_UI_FRAME_HISTOGRAM_BUCKETS		12
+
+typedef struct {
+	uint32_t frames;
+	uint32_t histogram[G_UI_FRAME_HISTOGRAM_BUCKETS];
+	uint32_t longest_frame;
+	uint64_t total_event_processing;
+	uint64_t total_component_processing;
+	uint64_t total_blitting;
+}__attribute__((packed)) g_ui_frame_statistics;
+
+/**
+ * Request/response for retrieving the frame statistics
+ */
+typedef struct {
+	g_ui_message_header header;
+}__attribute__((packed)) g_ui_get_frame_statistics_request;
+
+typedef struct {
+	g_ui_message_header header;
+	g_ui_frame_statistics statistics;
+}__attribute__((packed)) g_ui_get_frame_statistics_response;
+
+/**
+ * A batch carries multiple requests in one message. Each request is prefixed
+ * with a batch entry header that contains its length. Requests in a batch are
+ * processed in order and never answered, the same applies to any request that
+ * is sent without a message transaction.
+ */
+#define G_UI_BATCH_MAXIMUM_SIZE		G_MESSAGE_MAXIMUM_LENGTH
+
+typedef struct {
+	g_ui_message_header header;
+	uint16_t count;
+}__attribute__((packed)) g_ui_batch_request;
+
+typedef struct {
+	uint16_t length;
+}__attribute__((packed)) g_ui_batch_entry_header;
+
 /**
  * Event structures
  */
@@ -387,23 +435,63 @@ typedef struct {
 	g_mouse_button buttons;
 }__attribute__((packed)) g_ui_component_mouse_event;
 
+/**
+ * A canvas is triple-buffered. At any time the client owns one buffer to paint
+ * in, the window server owns one buffer to read from and the third one is the
+ * latest presented buffer. Ownership is handed over by atomically exchanging
+ * the index in the "present" field, the NEW flag tells the window server that
+ * the presented buffer was not yet taken. Neither side ever waits for the other.
+ */
+#define G_UI_CANVAS_BUFFER_COUNT				3
+#define G_UI_CANVAS_PRESENT_INDEX_MASK			0x3
+#define G_UI_CANVAS_PRESENT_NEW					0x4
+
+/**
+ * Maximum number of damage rectangles per presented frame. A client with more
+ * damage reports the bounding rectangle instead.
+ */
+#define G_UI_CANVAS_MAXIMUM_DAMAGE				8
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+}__attribute__((packed)) g_ui_canvas_damage_rect;
+
+/**
+ * Per-buffer information, written by the client before presenting the buffer.
+ * Frames are numbered consecutively, the damage describes what changed in
+ * comparison to the previous frame. If the window server missed a frame it
+ * must treat the whole buffer as damaged.
+ */
+typedef struct {
+	uint32_t frame;
+	uint16_t damage_count;
+	g_ui_canvas_damage_rect damage[G_UI_CANVAS_MAXIMUM_DAMAGE];
+}__attribute__((packed)) g_ui_canvas_buffer_header;
+
 /**
  * Canvas shared memory header
  */
 typedef struct {
 	uint16_t paintable_width;
 	uint16_t paintable_height;
-	uint16_t blit_x;
-	uint16_t blit_y;
-	uint16_t blit_width;
-	uint16_t blit_height;
-	g_bool ready;
+	uint32_t buffer_size;
+	volatile uint32_t present;
+	g_ui_canvas_buffer_header buffers[G_UI_CANVAS_BUFFER_COUNT];
 }__attribute__((packed)) g_ui_canvas_shared_memory_header;
 
 /**
  * Cairo requires the canvas memory buffer to be aligned. This constant must be used to calculate
- * the address for the canvas buffer in the canvas shared memory.
+ * the address for the canvas buffers in the canvas shared memory.
+ */
+#define G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE	((sizeof(g_ui_canvas_shared_memory_header) - sizeof(g_ui_canvas_shared_memory_header) % 16) + 16)
+
+/**
+ * Address of the buffer with the "index" in the canvas shared memory
  */
-#define G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE	((sizeof(g_ui_canvas_shared_memory_header) - sizeof(g_ui_canvas_shared_memory_header) % sizeof(g_address)) + sizeof(g_address))
+#define G_UI_CANVAS_BUFFER(memory, index)		(((uint8_t*) (memory)) + G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE \
+		+ (index) * ((g_ui_canvas_shared_memory_header*) (memory))->buffer_size)
 
 #endif
@@ -74,6 +74,36 @@ public:
 	static bool register_desktop_canvas(g_canvas* c);
 
 	static bool get_screen_dimension(g_dimension* out);
+
+	static bool get_frame_statistics(g_ui_frame_statistics* out);
+
+	/**
+	 * Opens a batch for the calling thread. Until the batch is ended, setters
+	 * called by this thread do not wait for the window server but are collected
+	 * and sent together, they then always report success. Requests that need
+	 * an answer first send the collected requests, so the window server always
+	 * sees the requests in the order they were made. Batches may be nested, only the outermost end sends the batch.
+	 */
+	static void begin_batch();
+
+	/**
+	 * Ends the batch of the calling thread and sends the collected requests.
+	 */
+	static void end_batch();
+
+	/**
+	 * Adds the request to the batch of the calling thread.
+	 *
+	 * @return whether the request was added, if not it must be sent normally
+	 */
+	static bool add_to_batch(void* request, size_t length);
+
+	/**
+	 * Sends the requests that were collected so far in the batch of the
+	 * calling thread. Must be called before sending any request that is
+	 * not part of the batch.
+	 */
+	static void flush_batch();
 };
 
 #endif
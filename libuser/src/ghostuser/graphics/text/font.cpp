@@ -60,6 +60,11 @@ g_font::g_font(std::string name, uint8_t* source, uint32_t sourceLength, g_font_
 g_font::~g_font() {
 	if (okay) {
 
+		// destroy glyph caches
+		for (auto entry : atlases) {
+			delete entry.second;
+		}
+
 		// destroy cairo face
 		cairo_font_face_destroy(cairo_face);
 
@@ -108,3 +113,27 @@ bool g_font::isOkay() {
 	return okay;
 }
 
+/**
+ *
+ */
+g_glyph_atlas* g_font::getAtlas(int size) {
+
+	if (!okay) {
+		return 0;
+	}
+
+	atlasesLock.lock();
+
+	g_glyph_atlas* atlas;
+	auto entry = atlases.find(size);
+	if (entry != atlases.end()) {
+		atlas = entry->second;
+	} else {
+		atlas = new g_glyph_atlas(cairo_face, size);
+		atlases[size] = atlas;
+	}
+
+	atlasesLock.unlock();
+	return atlas;
+}
+
@@ -0,0 +1,238 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <ghostuser/graphics/text/glyph_atlas.hpp>
+#include <math.h>
+
+/**
+ *
+ */
+g_glyph_atlas::g_glyph_atlas(cairo_font_face_t* face, int size) :
+		currentPage(0), rowX(0), rowY(0), rowHeight(0) {
+
+	cairo_matrix_t fontMatrix;
+	cairo_matrix_init_scale(&fontMatrix, size, size);
+	cairo_matrix_t ctm;
+	cairo_matrix_init_identity(&ctm);
+
+	cairo_font_options_t* options = cairo_font_options_create();
+	scaledFont = cairo_scaled_font_create(face, &fontMatrix, &ctm, options);
+	cairo_font_options_destroy(options);
+}
+
+/**
+ *
+ */
+g_glyph_atlas::~g_glyph_atlas() {
+
+	for (auto entry : glyphs) {
+		if (entry.second) {
+			if (entry.second->mask) {
+				cairo_surface_destroy(entry.second->mask);
+			}
+			delete entry.second;
+		}
+	}
+
+	for (cairo_surface_t* page : pages) {
+		cairo_surface_destroy(page);
+	}
+
+	cairo_scaled_font_destroy(scaledFont);
+}
+
+/**
+ *
+ */
+g_atlas_glyph* g_glyph_atlas::getGlyph(unsigned long index) {
+
+	lock.lock();
+
+	g_atlas_glyph* glyph;
+	auto entry = glyphs.find(index);
+	if (entry != glyphs.end()) {
+		glyph = entry->second;
+	} else {
+		glyph = rasterize(index);
+		glyphs[index] = glyph;
+	}
+
+	lock.unlock();
+	return glyph;
+}
+
+/**
+ *
+ */
+g_atlas_glyph* g_glyph_atlas::getCharacter(uint32_t codepoint) {
+
+	lock.lock();
+	auto entry = characters.find(codepoint);
+	bool known = entry != characters.end();
+	unsigned long index = known ? entry->second : 0;
+	lock.unlock();
+
+	if (!known) {
+		// encode as UTF-8 and let cairo look up the glyph
+		char utf8[4];
+		int length;
+		if (codepoint < 0x80) {
+			utf8[0] = codepoint;
+			length = 1;
+		} else if (codepoint < 0x800) {
+			utf8[0] = 0xC0 | (codepoint >> 6);
+			utf8[1] = 0x80 | (codepoint & 0x3F);
+			length = 2;
+		} else if (codepoint < 0x10000) {
+			utf8[0] = 0xE0 | (codepoint >> 12);
+			utf8[1] = 0x80 | ((codepoint >> 6) & 0x3F);
+			utf8[2] = 0x80 | (codepoint & 0x3F);
+			length = 3;
+		} else {
+			utf8[0] = 0xF0 | (codepoint >> 18);
+			utf8[1] = 0x80 | ((codepoint >> 12) & 0x3F);
+			utf8[2] = 0x80 | ((codepoint >> 6) & 0x3F);
+			utf8[3] = 0x80 | (codepoint & 0x3F);
+			length = 4;
+		}
+
+		cairo_glyph_t* glyphBuffer = 0;
+		int glyphCount = 0;
+		cairo_status_t status = cairo_scaled_font_text_to_glyphs(scaledFont, 0, 0, utf8, length, &glyphBuffer, &glyphCount, 0, 0, 0);
+		if (status != CAIRO_STATUS_SUCCESS || glyphCount < 1) {
+			return 0;
+		}
+		index = glyphBuffer[0].index;
+		cairo_glyph_free(glyphBuffer);
+
+		lock.lock();
+		characters[codepoint] = index;
+		lock.unlock();
+	}
+
+	return getGlyph(index);
+}
+
+/**
+ *
+ */
+g_atlas_glyph* g_glyph_atlas::rasterize(unsigned long index) {
+
+	cairo_glyph_t glyph;
+	glyph.index = index;
+	glyph.x = 0;
+	glyph.y = 0;
+
+	cairo_text_extents_t extents;
+	cairo_scaled_font_glyph_extents(scaledFont, &glyph, 1, &extents);
+
+	g_atlas_glyph* entry = new g_atlas_glyph();
+	entry->mask = 0;
+	entry->offsetX = 0;
+	entry->offsetY = 0;
+	entry->width = 0;
+	entry->height = 0;
+	entry->advance = extents.x_advance;
+
+	// glyphs without ink (like spaces) only have an advance
+	if (extents.width <= 0 || extents.height <= 0) {
+		return entry;
+	}
+
+	// leave a pixel for antialiasing on each side
+	int left = floor(extents.x_bearing) - 1;
+	int top = floor(extents.y_bearing) - 1;
+	int right = ceil(extents.x_bearing + extents.width) + 1;
+	int bottom = ceil(extents.y_bearing + extents.height) + 1;
+	int width = right - left;
+	int height = bottom - top;
+
+	int x;
+	int y;
+	cairo_surface_t* page = allocate(width, height, &x, &y);
+	if (page == 0) {
+		return entry;
+	}
+
+	cairo_t* cr = cairo_create(page);
+	cairo_rectangle(cr, x, y, width, height);
+	cairo_clip(cr);
+	cairo_set_scaled_font(cr, scaledFont);
+	glyph.x = x - left;
+	glyph.y = y - top;
+	cairo_show_glyphs(cr, &glyph, 1);
+	cairo_destroy(cr);
+	cairo_surface_flush(page);
+
+	entry->mask = cairo_surface_create_for_rectangle(page, x, y, width, height);
+	entry->offsetX = left;
+	entry->offsetY = top;
+	entry->width = width;
+	entry->height = height;
+	return entry;
+}
+
+/**
+ *
+ */
+cairo_surface_t* g_glyph_atlas::allocate(int width, int height, int* outX, int* outY) {
+
+	// oversized glyphs get a page of their own
+	if (width > G_GLYPH_ATLAS_PAGE_SIZE || height > G_GLYPH_ATLAS_PAGE_SIZE) {
+		cairo_surface_t* page = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+		if (cairo_surface_status(page) != CAIRO_STATUS_SUCCESS) {
+			cairo_surface_destroy(page);
+			return 0;
+		}
+		pages.push_back(page);
+		*outX = 0;
+		*outY = 0;
+		return page;
+	}
+
+	// continue in the next row if this one is full
+	if (currentPage && rowX + width > G_GLYPH_ATLAS_PAGE_SIZE) {
+		rowX = 0;
+		rowY += rowHeight;
+		rowHeight = 0;
+	}
+
+	// start a new page if the current one is full
+	if (currentPage == 0 || rowY + height > G_GLYPH_ATLAS_PAGE_SIZE) {
+		cairo_surface_t* page = cairo_image_surface_create(CAIRO_FORMAT_A8, G_GLYPH_ATLAS_PAGE_SIZE, G_GLYPH_ATLAS_PAGE_SIZE);
+		if (cairo_surface_status(page) != CAIRO_STATUS_SUCCESS) {
+			cairo_surface_destroy(page);
+			return 0;
+		}
+		pages.push_back(page);
+		currentPage = page;
+		rowX = 0;
+		rowY = 0;
+		rowHeight = 0;
+	}
+
+	*outX = rowX;
+	*outY = rowY;
+	rowX += width;
+	if (height > rowHeight) {
+		rowHeight = height;
+	}
+	return currentPage;
+}
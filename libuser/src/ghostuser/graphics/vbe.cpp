@@ -58,3 +58,27 @@ bool g_vbe::setMode(uint16_t width, uint16_t height, uint8_t bpp, g_vbe_mode_inf
 	return false;
 }
 
+/**
+ *
+ */
+bool g_vbe::setDisplayStart(uint16_t x, uint16_t y) {
+
+	g_tid driver_tid = g_task_get_id(G_VBE_DRIVER_IDENTIFIER);
+	if (driver_tid == -1) {
+		return false;
+	}
+	g_message_transaction transaction = g_get_message_tx_id();
+
+	g_vbe_set_display_start_request request;
+	request.header.command = G_VBE_COMMAND_SET_DISPLAY_START;
+	request.x = x;
+	request.y = y;
+	g_send_message_t(driver_tid, &request, sizeof(g_vbe_set_display_start_request), transaction);
+
+	size_t buflen = sizeof(g_message_header) + sizeof(g_vbe_set_display_start_response);
+	uint8_t buf[buflen];
+	auto status = g_receive_message_t(buf, buflen, transaction);
+	g_vbe_set_display_start_response* response = (g_vbe_set_display_start_response*) G_MESSAGE_CONTENT(buf);
+
+	return status == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL && response->status == G_VBE_SET_DISPLAY_START_STATUS_SUCCESS;
+}
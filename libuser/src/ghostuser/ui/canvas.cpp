@@ -46,20 +46,28 @@ g_canvas_buffer_info g_canvas::getBuffer() {
 		g_ui_component_canvas_ack_buffer_request request;
 		request.header.id = G_UI_PROTOCOL_CANVAS_ACK_BUFFER_REQUEST;
 		request.id = this->id;
+		g_ui::flush_batch();
 		g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_canvas_ack_buffer_request), tx);
 
 		nextBuffer = 0;
+
+		// start with the first buffer of the new memory
+		backIndex = 0;
+		frame = 0;
+		fresh = true;
+		history.clear();
 	}
 
 	if (currentBuffer == 0) {
 		info.buffer = 0;
 
 	} else {
-		// return buffer
-		info.buffer = (uint8_t*) (currentBuffer + G_UI_CANVAS_SHARED_MEMORY_HEADER_SIZE);
+		// return the buffer that the client owns
 		g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer;
+		info.buffer = G_UI_CANVAS_BUFFER(header, backIndex);
 		info.width = header->paintable_width;
 		info.height = header->paintable_height;
+		info.fresh = fresh;
 	}
 	return info;
 }
@@ -96,23 +104,65 @@ void g_canvas::acknowledgeNewBuffer(g_address address) {
  *
  */
 void g_canvas::blit(g_rectangle rect) {
+	blit(&rect, 1);
+}
+
+/**
+ *
+ */
+void g_canvas::blit(const g_rectangle* rects, int count) {
 
 	if (currentBuffer == 0) {
 		return;
 	}
 
-	// write blit parameters
 	g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer;
-	header->blit_x = rect.x;
-	header->blit_y = rect.y;
-	header->blit_width = rect.width;
-	header->blit_height = rect.height;
-	header->ready = true;
-
-	// send blit message
-	g_message_transaction tx = g_get_message_tx_id();
-	g_ui_component_canvas_blit_request request;
-	request.header.id = G_UI_PROTOCOL_CANVAS_BLIT;
-	request.id = this->id;
-	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_canvas_blit_request), tx);
+	int width = header->paintable_width;
+	int height = header->paintable_height;
+
+	// describe the damage of this frame, too many rectangles are joined
+	const g_canvas_frame_damage& damage = history.record(++frame, rects, count, width, height);
+
+	g_ui_canvas_buffer_header* bufferHeader = &header->buffers[backIndex];
+	bufferHeader->frame = frame;
+	bufferHeader->damage_count = damage.count;
+	for (int i = 0; i < damage.count; i++) {
+		bufferHeader->damage[i] = damage.rects[i];
+	}
+
+	// present the buffer and take the one that is free now
+	__sync_synchronize();
+	uint8_t presented = backIndex;
+	uint32_t previous = __sync_lock_test_and_set(&header->present, presented | G_UI_CANVAS_PRESENT_NEW);
+	backIndex = previous & G_UI_CANVAS_PRESENT_INDEX_MASK;
+	fresh = false;
+
+	// if the previous frame was not taken yet, the window server is already going to paint
+	if ((previous & G_UI_CANVAS_PRESENT_NEW) == 0) {
+		g_message_transaction tx = g_get_message_tx_id();
+		g_ui_component_canvas_blit_request request;
+		request.header.id = G_UI_PROTOCOL_CANVAS_BLIT;
+		request.id = this->id;
+		g_ui::flush_batch();
+		g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_canvas_blit_request), tx);
+	}
+
+	// bring the new back buffer up to date
+	copyForward(presented, header->buffers[backIndex].frame);
+}
+
+/**
+ *
+ */
+void g_canvas::copyForward(uint8_t source, uint32_t since) {
+
+	g_ui_canvas_shared_memory_header* header = (g_ui_canvas_shared_memory_header*) currentBuffer;
+	uint8_t* from = G_UI_CANVAS_BUFFER(header, source);
+	uint8_t* to = G_UI_CANVAS_BUFFER(header, backIndex);
+	if (header->buffer_size == 0) {
+		return;
+	}
+
+	uint32_t stride = header->buffer_size / header->paintable_height;
+	history.copyForward(to, from, stride, header->buffer_size, since, frame);
 }
@@ -0,0 +1,110 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <ghostuser/ui/canvas_damage_history.hpp>
+#include <string.h>
+
+/**
+ *
+ */
+void g_canvas_damage_history::clear() {
+
+	for (int i = 0; i < G_CANVAS_DAMAGE_HISTORY; i++) {
+		frames[i].frame = 0;
+		frames[i].count = 0;
+	}
+}
+
+/**
+ *
+ */
+const g_canvas_frame_damage& g_canvas_damage_history::record(uint32_t frame, const g_rectangle* rects, int count, int width, int height) {
+
+	g_canvas_frame_damage& damage = frames[frame % G_CANVAS_DAMAGE_HISTORY];
+	damage.frame = frame;
+	damage.count = 0;
+
+	int top = height;
+	int left = width;
+	int bottom = 0;
+	int right = 0;
+	for (int i = 0; i < count; i++) {
+		int x = rects[i].x < 0 ? 0 : rects[i].x;
+		int y = rects[i].y < 0 ? 0 : rects[i].y;
+		int r = rects[i].x + rects[i].width > width ? width : rects[i].x + rects[i].width;
+		int b = rects[i].y + rects[i].height > height ? height : rects[i].y + rects[i].height;
+		if (r <= x || b <= y) {
+			continue;
+		}
+
+		if (damage.count < G_UI_CANVAS_MAXIMUM_DAMAGE) {
+			g_ui_canvas_damage_rect& out = damage.rects[damage.count++];
+			out.x = x;
+			out.y = y;
+			out.width = r - x;
+			out.height = b - y;
+		}
+
+		left = x < left ? x : left;
+		top = y < top ? y : top;
+		right = r > right ? r : right;
+		bottom = b > bottom ? b : bottom;
+	}
+
+	if (count > G_UI_CANVAS_MAXIMUM_DAMAGE && right > left) {
+		damage.count = 1;
+		damage.rects[0].x = left;
+		damage.rects[0].y = top;
+		damage.rects[0].width = right - left;
+		damage.rects[0].height = bottom - top;
+	}
+	return damage;
+}
+
+/**
+ *
+ */
+void g_canvas_damage_history::copyForward(uint8_t* to, const uint8_t* from, uint32_t stride, uint32_t size, uint32_t since, uint32_t frame) const {
+
+	// without the damage history, the whole buffer is copied
+	bool complete = frame - since > G_CANVAS_DAMAGE_HISTORY;
+	for (uint32_t f = since + 1; !complete && f <= frame; f++) {
+		if (frames[f % G_CANVAS_DAMAGE_HISTORY].frame != f) {
+			complete = true;
+		}
+	}
+	if (complete) {
+		memcpy(to, from, size);
+		return;
+	}
+
+	for (uint32_t f = since + 1; f <= frame; f++) {
+		const g_canvas_frame_damage& damage = frames[f % G_CANVAS_DAMAGE_HISTORY];
+
+		for (int i = 0; i < damage.count; i++) {
+			const g_ui_canvas_damage_rect& rect = damage.rects[i];
+			uint32_t offset = rect.y * stride + rect.x * 4;
+			for (int y = 0; y < rect.height; y++) {
+				memcpy(to + offset, from + offset, rect.width * 4);
+				offset += stride;
+			}
+		}
+	}
+}
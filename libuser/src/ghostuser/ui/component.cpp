@@ -22,6 +22,7 @@
 #include <ghostuser/ui/component.hpp>
 #include <ghostuser/ui/interface_specification.hpp>
 #include <ghostuser/ui/properties.hpp>
+#include <ghostuser/ui/ui.hpp>
 #include <ghostuser/utils/value_placer.hpp>
 
 /**
@@ -40,6 +41,10 @@ bool g_component::addChild(g_component* child) {
 	request.header.id = G_UI_PROTOCOL_ADD_COMPONENT;
 	request.parent = this->id;
 	request.child = child->id;
+	if (g_ui::add_to_batch(&request, sizeof(g_ui_component_add_child_request))) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_add_child_request), tx);
 
 	// read response
@@ -73,6 +78,10 @@ bool g_component::setBounds(g_rectangle rect) {
 	request.header.id = G_UI_PROTOCOL_SET_BOUNDS;
 	request.id = this->id;
 	request.bounds = rect;
+	if (g_ui::add_to_batch(&request, sizeof(g_ui_component_set_bounds_request))) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_bounds_request), tx);
 
 	// read response
@@ -106,6 +115,7 @@ g_rectangle g_component::getBounds() {
 	g_ui_component_get_bounds_request request;
 	request.header.id = G_UI_PROTOCOL_GET_BOUNDS;
 	request.id = this->id;
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_get_bounds_request), tx);
 
 	// read response
@@ -140,6 +150,10 @@ bool g_component::setVisible(bool visible) {
 	request.header.id = G_UI_PROTOCOL_SET_VISIBLE;
 	request.id = this->id;
 	request.visible = visible;
+	if (g_ui::add_to_batch(&request, sizeof(g_ui_component_set_visible_request))) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_visible_request), tx);
 
 	// read response
@@ -174,6 +188,10 @@ bool g_component::setNumericProperty(int property, uint32_t value) {
 	request.id = this->id;
 	request.property = property;
 	request.value = value;
+	if (g_ui::add_to_batch(&request, sizeof(g_ui_component_set_numeric_property_request))) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_numeric_property_request), tx);
 
 	// read response
@@ -207,6 +225,7 @@ bool g_component::getNumericProperty(int property, uint32_t* out) {
 	request.header.id = G_UI_PROTOCOL_GET_NUMERIC_PROPERTY;
 	request.id = this->id;
 	request.property = property;
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_get_numeric_property_request), tx);
 
 	// read response
@@ -250,6 +269,10 @@ bool g_component::setListener(g_ui_component_event_type eventType, g_listener* n
 	request.id = this->id;
 	request.target_thread = g_ui_event_dispatcher_tid;
 	request.event_type = eventType;
+	if (g_ui::add_to_batch(&request, sizeof(g_ui_component_set_listener_request))) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_listener_request), tx);
 
 	// read response
@@ -26,6 +26,7 @@
 #include <ghostuser/utils/value_placer.hpp>
 #include <ghostuser/utils/local.hpp>
 #include <stdio.h>
+#include <stddef.h>
 
 /**
  *
@@ -47,13 +48,18 @@ bool g_titled_component::setTitle(std::string title) {
 	const char* title_str = title.c_str();
 	size_t title_len;
 	if (title.length() >= G_UI_COMPONENT_TITLE_MAXIMUM) {
-		title_len = G_UI_COMPONENT_TITLE_MAXIMUM;
+		title_len = G_UI_COMPONENT_TITLE_MAXIMUM - 1;
 	} else {
 		title_len = title.length();
 	}
 	memcpy(request()->title, title.c_str(), title_len);
 	request()->title[title_len] = 0;
 
+	// in a batch, only the used part of the title is sent
+	if (g_ui::add_to_batch(request(), offsetof(g_ui_component_set_title_request, title) + title_len + 1)) {
+		return true;
+	}
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, request(), sizeof(g_ui_component_set_title_request), tx);
 
 	// read response
@@ -85,6 +91,7 @@ std::string g_titled_component::getTitle() {
 	g_ui_component_get_title_request request;
 	request.header.id = G_UI_PROTOCOL_GET_TITLE;
 	request.id = this->id;
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_get_title_request), tx);
 
 	// read response
@@ -31,6 +31,7 @@
 #include <map>
 #include <deque>
 #include <stdio.h>
+#include <string.h>
 
 /**
  * Global ready indicator
@@ -43,6 +44,15 @@ bool g_ui_initialized = false;
 g_tid g_ui_delegate_tid = -1;
 g_tid g_ui_event_dispatcher_tid = -1;
 
+/**
+ * Batch of requests, owned by one thread at a time
+ */
+static g_atom batch_atom = 0;
+static g_tid batch_owner = -1;
+static int batch_depth = 0;
+static uint8_t batch_buffer[G_UI_BATCH_MAXIMUM_SIZE];
+static uint32_t batch_length = 0;
+
 /**
  * Opens a connection to the window server.
  */
@@ -136,6 +146,7 @@ bool g_ui::register_desktop_canvas(g_canvas* c) {
 	g_ui_register_desktop_canvas_request request;
 	request.header.id = G_UI_PROTOCOL_REGISTER_DESKTOP_CANVAS;
 	request.canvas_id = c->getId();
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_register_desktop_canvas_request), tx);
 
 	// read response
@@ -167,6 +178,7 @@ bool g_ui::get_screen_dimension(g_dimension* out) {
 	// send request
 	g_ui_get_screen_dimension_request request;
 	request.header.id = G_UI_PROTOCOL_GET_SCREEN_DIMENSION;
+	g_ui::flush_batch();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_get_screen_dimension_request), tx);
 
 	// read response
@@ -181,3 +193,113 @@ bool g_ui::get_screen_dimension(g_dimension* out) {
 
 	return false;
 }
+
+/**
+ *
+ */
+bool g_ui::get_frame_statistics(g_ui_frame_statistics* out) {
+
+	if (!g_ui_initialized) {
+		return false;
+	}
+
+	g_message_transaction tx = g_get_message_tx_id();
+
+	// send request
+	g_ui_get_frame_statistics_request request;
+	request.header.id = G_UI_PROTOCOL_GET_FRAME_STATISTICS;
+	g_ui::flush_batch();
+	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_get_frame_statistics_request), tx);
+
+	// read response
+	size_t bufferSize = sizeof(g_message_header) + sizeof(g_ui_get_frame_statistics_response);
+	g_local<uint8_t> buffer(new uint8_t[bufferSize]);
+
+	if (g_receive_message_t(buffer(), bufferSize, tx) == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL) {
+		g_ui_get_frame_statistics_response* response = (g_ui_get_frame_statistics_response*) G_MESSAGE_CONTENT(buffer());
+		*out = response->statistics;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ *
+ */
+void g_ui::begin_batch() {
+
+	g_tid tid = g_get_tid();
+	if (batch_owner == tid) {
+		++batch_depth;
+		return;
+	}
+
+	g_atomic_lock(&batch_atom);
+	batch_owner = tid;
+	batch_depth = 1;
+	batch_length = sizeof(g_ui_batch_request);
+	((g_ui_batch_request*) batch_buffer)->header.id = G_UI_PROTOCOL_BATCH;
+	((g_ui_batch_request*) batch_buffer)->count = 0;
+}
+
+/**
+ *
+ */
+void g_ui::end_batch() {
+
+	if (batch_owner != g_get_tid()) {
+		return;
+	}
+
+	if (--batch_depth == 0) {
+		flush_batch();
+		batch_owner = -1;
+		batch_atom = 0;
+	}
+}
+
+/**
+ *
+ */
+bool g_ui::add_to_batch(void* request, size_t length) {
+
+	if (!g_ui_initialized || batch_owner != g_get_tid()) {
+		return false;
+	}
+
+	size_t required = sizeof(g_ui_batch_entry_header) + length;
+	if (batch_length + required > G_UI_BATCH_MAXIMUM_SIZE) {
+		flush_batch();
+
+		// too large for any batch, keep the order by sending it after the previous ones
+		if (batch_length + required > G_UI_BATCH_MAXIMUM_SIZE) {
+			return false;
+		}
+	}
+
+	g_ui_batch_entry_header* entry = (g_ui_batch_entry_header*) &batch_buffer[batch_length];
+	entry->length = length;
+	memcpy(&batch_buffer[batch_length + sizeof(g_ui_batch_entry_header)], request, length);
+	batch_length += required;
+	((g_ui_batch_request*) batch_buffer)->count++;
+	return true;
+}
+
+/**
+ *
+ */
+void g_ui::flush_batch() {
+
+	if (batch_owner != g_get_tid()) {
+		return;
+	}
+
+	g_ui_batch_request* batch = (g_ui_batch_request*) batch_buffer;
+	if (batch->count > 0) {
+		g_send_message(g_ui_delegate_tid, batch_buffer, batch_length);
+	}
+
+	batch_length = sizeof(g_ui_batch_request);
+	batch->count = 0;
+}
@@ -0,0 +1,69 @@
+#!/bin/bash
+ROOT="../.."
+if [ -f "$ROOT/variables.sh" ]; then
+	. "$ROOT/variables.sh"
+fi
+. "$ROOT/ghost.sh"
+
+
+# Host benchmark for the pixel conversion routines of the window server
+TARGET=$1
+
+with TARGET		"all"
+with CC			"g++"
+with LD			"g++"
+with CFLAGS		"-std=c++11 -O2"
+with ARTIFACT	"blit-benchmark"
+with SRC		"src"
+with BIN		"bin"
+with CONVERSION_SRC	"$ROOT/applications/windowserver/src/output"
+
+echo "target: $TARGET"
+requireTool $CC
+requireTool $LD
+
+
+target_compile() {
+	echo "compiling:"
+	for src in $(find "$SRC" -iname "*.cpp"); do
+		obj=`sourceToObject $src`
+		list $obj
+		$CC -c $src -o "$BIN/$obj" -I$CONVERSION_SRC $CFLAGS
+		failOnError
+	done
+
+	list "pixel_conversion.cpp.o"
+	$CC -c "$CONVERSION_SRC/pixel_conversion.cpp" -o "$BIN/pixel_conversion.cpp.o" $CFLAGS
+	failOnError
+}
+
+target_link() {
+	echo "linking:"
+	$LD -o $ARTIFACT $BIN/*.o
+	failOnError
+	list $ARTIFACT
+}
+
+target_clean() {
+	echo "cleaning:"
+	cleanDirectory $BIN
+}
+
+
+if [[ $TARGET == "all" ]]; then
+	target_clean
+	target_compile
+	target_link
+
+elif [[ $TARGET == "run" ]]; then
+	./$ARTIFACT
+
+elif [[ $TARGET == "clean" ]]; then
+	target_clean
+
+else
+	echo "unknown target: '$TARGET'"
+	exit 1
+fi
+
+exit 0
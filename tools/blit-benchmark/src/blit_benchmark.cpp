@@ -0,0 +1,119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "pixel_conversion.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define BENCHMARK_WIDTH		1920
+#define BENCHMARK_HEIGHT	1080
+#define BENCHMARK_FRAMES	200
+
+/**
+ * Converts full frames with the given converter and prints the average time.
+ */
+static void benchmark(const char* name, pixel_row_converter_t converter, uint32_t* source, uint8_t* target,
+		uint32_t bytesPerPixel) {
+
+	uint32_t pitch = BENCHMARK_WIDTH * bytesPerPixel;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+		for (int y = 0; y < BENCHMARK_HEIGHT; y++) {
+			converter(&source[y * BENCHMARK_WIDTH], &target[y * pitch], BENCHMARK_WIDTH);
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	double total = std::chrono::duration<double, std::milli>(end - start).count();
+	double perFrame = total / BENCHMARK_FRAMES;
+	double throughput = (double) BENCHMARK_WIDTH * BENCHMARK_HEIGHT * 4 / (perFrame / 1000) / (1024 * 1024);
+	printf("%-18s %8.3f ms/frame %10.1f MiB/s\n", name, perFrame, throughput);
+}
+
+/**
+ * Checks that the SSE2 converter produces the same output as the generic one.
+ */
+static bool verify(const char* name, pixel_row_converter_t generic, pixel_row_converter_t sse2, uint32_t* source,
+		uint32_t bytesPerPixel) {
+
+	// odd offsets and lengths exercise the unaligned head and the tail
+	uint32_t length = BENCHMARK_WIDTH * bytesPerPixel + 64;
+	uint8_t* expected = new uint8_t[length];
+	uint8_t* actual = new uint8_t[length];
+	bool ok = true;
+
+	for (uint32_t offset = 0; offset < 16 && ok; offset++) {
+		for (uint32_t pixels = 0; pixels < 100 && ok; pixels += 3) {
+			memset(expected, 0, length);
+			memset(actual, 0, length);
+			generic(&source[offset], expected + offset * bytesPerPixel, pixels);
+			sse2(&source[offset], actual + offset * bytesPerPixel, pixels);
+			ok = memcmp(expected, actual, length) == 0;
+		}
+	}
+
+	delete[] expected;
+	delete[] actual;
+
+	if (!ok) {
+		printf("%s: SSE2 output differs from generic output\n", name);
+	}
+	return ok;
+}
+
+/**
+ *
+ */
+int main(int argc, char** argv) {
+
+	pixel_conversion_t::initialize();
+	printf("frames of %ix%i, SSE2 %s\n\n", BENCHMARK_WIDTH, BENCHMARK_HEIGHT,
+			pixel_conversion_t::sse2 ? "supported" : "not supported");
+
+	uint32_t* source = new uint32_t[BENCHMARK_WIDTH * BENCHMARK_HEIGHT];
+	for (int i = 0; i < BENCHMARK_WIDTH * BENCHMARK_HEIGHT; i++) {
+		source[i] = (rand() & 0xFFFF) | ((rand() & 0xFFFF) << 16);
+	}
+	uint8_t* target = new uint8_t[BENCHMARK_WIDTH * BENCHMARK_HEIGHT * 4 + 16];
+
+	benchmark("argb->rgb32", pixel_conversion_t::toRgb32, source, target, 4);
+	benchmark("argb->rgb24", pixel_conversion_t::toRgb24, source, target, 3);
+	benchmark("argb->rgb565", pixel_conversion_t::toRgb16, source, target, 2);
+
+	bool ok = true;
+	if (pixel_conversion_t::sse2) {
+		printf("\n");
+		benchmark("argb->rgb32 sse2", pixel_conversion_t::toRgb32Sse2, source, target, 4);
+		benchmark("argb->rgb24 sse2", pixel_conversion_t::toRgb24Sse2, source, target, 3);
+		benchmark("argb->rgb565 sse2", pixel_conversion_t::toRgb16Sse2, source, target, 2);
+
+		ok &= verify("argb->rgb32", pixel_conversion_t::toRgb32, pixel_conversion_t::toRgb32Sse2, source, 4);
+		ok &= verify("argb->rgb24", pixel_conversion_t::toRgb24, pixel_conversion_t::toRgb24Sse2, source, 3);
+		ok &= verify("argb->rgb565", pixel_conversion_t::toRgb16, pixel_conversion_t::toRgb16Sse2, source, 2);
+	}
+
+	delete[] source;
+	delete[] target;
+	return ok ? 0 : 1;
+}
@@ -24,9 +24,39 @@
 #include <fstream>
 #include <stdint.h>
 #include <list>
+#include <string>
+#include <vector>
 
 #define VERSION_MAJOR	1
-#define	VERSION_MINOR	0
+#define	VERSION_MINOR	1
+
+/**
+ * Must match the format definitions in the kernels "ghost/ramdisk.h"
+ */
+#define RAMDISK_MAGIC			"GRDX"
+#define RAMDISK_FORMAT_VERSION	2
+#define RAMDISK_FORMAT_VERSION_COMPRESSED	3
+#define RAMDISK_BLOCK_SIZE		0x10000
+#define RAMDISK_ENTRY_FLAG_COMPRESSED	1
+#define PAGE_SIZE				0x1000
+#define PAGE_ALIGN_UP(value)	(((value) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+
+/**
+ *
+ */
+struct ghost_ramdisk_entry
+{
+	uint32_t id;
+	uint32_t parentId;
+	bool isFile;
+	std::string name;
+	std::string path;
+	uint32_t length;
+
+	// only filled for files that are stored compressed
+	std::vector<uint8_t> stored;
+	bool compressed;
+};
 
 /**
  *
@@ -37,16 +67,28 @@ private:
 	int idCounter;
 	std::ofstream out;
 	std::list<std::string> ignores;
+	std::vector<ghost_ramdisk_entry> entries;
+
+	bool isIgnored(const char* basePath, const char* path);
+	void collectRecursive(const char* basePath, const char* path, const char* name, uint32_t contentLength, uint32_t parentId, bool isFile);
+
+	void writeInt(uint32_t value);
+	void writePadding(uint32_t length);
+	uint32_t writeContent(ghost_ramdisk_entry& entry);
+	void compressContent(ghost_ramdisk_entry& entry);
 
-	void writeRecursive(const char* basePath, const char* path, const char* name, uint32_t contentLength, uint32_t parentId, bool isFile);
+	void writeLegacy();
+	void writeIndexed();
 
 public:
 	ghost_ramdisk() :
-			idCounter(0), verbose(false)
+			idCounter(0), verbose(false), legacy(false), compress(false)
 	{
 	}
 
 	bool verbose;
+	bool legacy;
+	bool compress;
 	void create(const char* sourcePath, const char* targetPath);
 };
 
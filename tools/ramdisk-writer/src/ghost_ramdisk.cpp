@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "../inc/ghost_ramdisk.hpp"
+#include "../inc/ghost_ramdisk_compression.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -48,7 +49,12 @@ int main(int argc, char** argv)
 			std::cout << "  This program generates a Ghost ramdisk from a given source folder." << std::endl;
 			std::cout << "  To do so, use the following command syntax:" << std::endl;
 			std::cout << std::endl;
-			std::cout << "\tpath/to/source path/to/target" << std::endl;
+			std::cout << "\tpath/to/source path/to/target [-v] [--legacy] [--compress]" << std::endl;
+			std::cout << std::endl;
+			std::cout << "  By default, an indexed image with page-aligned file contents is" << std::endl;
+			std::cout << "  written. Use --legacy to write the original sequential format." << std::endl;
+			std::cout << "  Use --compress to store file contents in compressed blocks that" << std::endl;
+			std::cout << "  the kernel decompresses on first access." << std::endl;
 			std::cout << std::endl;
 			return 0;
 		}
@@ -59,13 +65,22 @@ int main(int argc, char** argv)
 
 	if(argc >= 3)
 	{
-
-		if(argc == 4)
+		for(int i = 3; i < argc; i++)
 		{
-			char* flag = argv[3];
+			char* flag = argv[i];
 			if(strcmp(flag, "-v") == 0)
 			{
 				ramdisk.verbose = true;
+			} else if(strcmp(flag, "--legacy") == 0)
+			{
+				ramdisk.legacy = true;
+			} else if(strcmp(flag, "--compress") == 0)
+			{
+				ramdisk.compress = true;
+			} else
+			{
+				std::cerr << "error: unrecognized command line option '" << flag << "'" << std::endl;
+				return 1;
 			}
 		}
 
@@ -120,7 +135,14 @@ void ghost_ramdisk::create(const char* sourcePath, const char* targetPath)
 		{
 			std::cout << "status: packing folder \"" << sourcePath << "\" to ramdisk file \"" << targetPath << "\":" << std::endl;
 			int64_t pos = out.tellp();
-			writeRecursive(sourcePath, sourcePath, "", 0, 0, false);
+			collectRecursive(sourcePath, sourcePath, "", 0, 0, false);
+			if(legacy)
+			{
+				writeLegacy();
+			} else
+			{
+				writeIndexed();
+			}
 			int64_t written = out.tellp() - pos;
 			std::cout << "status: ramdisk successfully created, wrote " << written << " bytes" << std::endl;
 		} else
@@ -142,10 +164,8 @@ void ghost_ramdisk::create(const char* sourcePath, const char* targetPath)
 /**
  *
  */
-void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const char* name, uint32_t contentLength, uint32_t parentId, bool isFile)
+bool ghost_ramdisk::isIgnored(const char* basePath, const char* path)
 {
-
-	// check whether to skip the file
 	std::string basePathStr(basePath);
 	std::string pathStr(path);
 	for(std::string ign : ignores)
@@ -157,8 +177,7 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 			std::string part = ign.substr(1);
 			if(pathStr.find(part) == pathStr.length() - part.length())
 			{
-				std::cout << "  skipping: " << path << std::endl;
-				return;
+				return true;
 			}
 		}
 
@@ -170,8 +189,7 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 
 			if(pathStr.find(absolutePartPath) == 0)
 			{
-				std::cout << "  skipping: " << path << std::endl;
-				return;
+				return true;
 			}
 		}
 
@@ -179,13 +197,25 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 		std::string absolutePath = basePathStr + "/" + ign;
 		if(absolutePath == pathStr)
 		{
-			std::cout << "  skipping: " << path << std::endl;
-			return;
+			return true;
 		}
 	}
+	return false;
+}
+
+/**
+ *
+ */
+void ghost_ramdisk::collectRecursive(const char* basePath, const char* path, const char* name, uint32_t contentLength, uint32_t parentId, bool isFile)
+{
+
+	// check whether to skip the file
+	if(isIgnored(basePath, path))
+	{
+		std::cout << "  skipping: " << path << std::endl;
+		return;
+	}
 
-	uint32_t bufferSize = 0x10000;
-	char* buffer = new char[bufferSize];
 	uint32_t entryId = idCounter++;
 
 	if(verbose)
@@ -195,63 +225,21 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 		std::cout << msg.str() << std::endl;
 	}
 
-	// Root must not be written
+	// Root is not part of the image
 	if(entryId > 0)
 	{
-		// file or folder
-		buffer[0] = isFile ? 1 : 0;
-		out.write(buffer, 1);
-
-		// id
-		buffer[0] = ((entryId >> 0) & 0xFF);
-		buffer[1] = ((entryId >> 8) & 0xFF);
-		buffer[2] = ((entryId >> 16) & 0xFF);
-		buffer[3] = ((entryId >> 24) & 0xFF);
-		out.write(buffer, 4);
-
-		// parent id
-		buffer[0] = ((parentId >> 0) & 0xFF);
-		buffer[1] = ((parentId >> 8) & 0xFF);
-		buffer[2] = ((parentId >> 16) & 0xFF);
-		buffer[3] = ((parentId >> 24) & 0xFF);
-		out.write(buffer, 4);
-
-		// name length
-		int32_t namelen = strlen(name);
-		buffer[0] = ((namelen >> 0) & 0xFF);
-		buffer[1] = ((namelen >> 8) & 0xFF);
-		buffer[2] = ((namelen >> 16) & 0xFF);
-		buffer[3] = ((namelen >> 24) & 0xFF);
-		out.write(buffer, 4);
-
-		// name
-		memcpy(buffer, name, namelen);
-		out.write(buffer, namelen);
+		ghost_ramdisk_entry entry;
+		entry.id = entryId;
+		entry.parentId = parentId;
+		entry.isFile = isFile;
+		entry.name = name;
+		entry.path = path;
+		entry.length = isFile ? contentLength : 0;
+		entry.compressed = false;
+		entries.push_back(entry);
 	}
 
-	if(isFile)
-	{
-		// file length
-		buffer[0] = ((contentLength >> 0) & 0xFF);
-		buffer[1] = ((contentLength >> 8) & 0xFF);
-		buffer[2] = ((contentLength >> 16) & 0xFF);
-		buffer[3] = ((contentLength >> 24) & 0xFF);
-		out.write(buffer, 4);
-
-		// file content
-		std::ifstream fileInput;
-		fileInput.open(path, std::ios::in | std::ios::binary);
-
-		int32_t length;
-		while(fileInput.good())
-		{
-			fileInput.read(buffer, bufferSize);
-			length = fileInput.gcount();
-			out.write(buffer, length);
-		}
-
-		fileInput.close();
-	} else
+	if(!isFile)
 	{
 		DIR *directory;
 		dirent *entry;
@@ -276,13 +264,13 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 
 					if(s.st_mode & S_IFREG)
 					{
-						writeRecursive(basePath, entryPath, entry->d_name, s.st_size, entryId, true);
+						collectRecursive(basePath, entryPath, entry->d_name, s.st_size, entryId, true);
 
 					} else if(s.st_mode & S_IFDIR)
 					{
 						if(!(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0))
 						{
-							writeRecursive(basePath, entryPath, entry->d_name, 0, entryId, false);
+							collectRecursive(basePath, entryPath, entry->d_name, 0, entryId, false);
 						}
 					}
 				} else
@@ -298,9 +286,247 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 			std::cerr << "error: could not open directory: '" << path << "'";
 		}
 	}
+}
+
+/**
+ *
+ */
+void ghost_ramdisk::writeInt(uint32_t value)
+{
+	char buffer[4];
+	buffer[0] = ((value >> 0) & 0xFF);
+	buffer[1] = ((value >> 8) & 0xFF);
+	buffer[2] = ((value >> 16) & 0xFF);
+	buffer[3] = ((value >> 24) & 0xFF);
+	out.write(buffer, 4);
+}
+
+/**
+ *
+ */
+void ghost_ramdisk::writePadding(uint32_t length)
+{
+	char zero = 0;
+	for(uint32_t i = 0; i < length; i++)
+	{
+		out.write(&zero, 1);
+	}
+}
+
+/**
+ *
+ */
+uint32_t ghost_ramdisk::writeContent(ghost_ramdisk_entry& entry)
+{
+	uint32_t bufferSize = 0x10000;
+	char* buffer = new char[bufferSize];
+
+	std::ifstream fileInput;
+	fileInput.open(entry.path, std::ios::in | std::ios::binary);
+
+	uint32_t total = 0;
+	while(fileInput.good() && total < entry.length)
+	{
+		uint32_t chunk = std::min(bufferSize, entry.length - total);
+		fileInput.read(buffer, chunk);
+		int32_t length = fileInput.gcount();
+		out.write(buffer, length);
+		total += length;
+	}
+
+	fileInput.close();
+	delete[] buffer;
+	return total;
+}
+
+/**
+ * Splits the contents into blocks and compresses each of them. The contents are
+ * only stored compressed if that saves at least an eighth.
+ */
+void ghost_ramdisk::compressContent(ghost_ramdisk_entry& entry)
+{
+	std::vector<uint8_t> content(entry.length);
+
+	std::ifstream fileInput;
+	fileInput.open(entry.path, std::ios::in | std::ios::binary);
+	fileInput.read((char*) content.data(), entry.length);
+	uint32_t length = fileInput.gcount();
+	fileInput.close();
+
+	if(length < entry.length)
+	{
+		std::cerr << "error: file '" << entry.path << "' is shorter than expected" << std::endl;
+		return;
+	}
+
+	uint32_t blockCount = (entry.length + RAMDISK_BLOCK_SIZE - 1) / RAMDISK_BLOCK_SIZE;
+	std::vector<uint32_t> offsets;
+	std::vector<uint8_t> blocks;
+	for(uint32_t i = 0; i < blockCount; i++)
+	{
+		uint32_t blockStart = i * RAMDISK_BLOCK_SIZE;
+		uint32_t blockLength = std::min((uint32_t) RAMDISK_BLOCK_SIZE, entry.length - blockStart);
+		offsets.push_back(blocks.size());
+
+		std::vector<uint8_t> block;
+		ramdiskCompressBlock(content.data() + blockStart, blockLength, block);
+		if(block.size() < blockLength)
+		{
+			blocks.insert(blocks.end(), block.begin(), block.end());
+		} else
+		{
+			blocks.insert(blocks.end(), content.begin() + blockStart, content.begin() + blockStart + blockLength);
+		}
+	}
+	offsets.push_back(blocks.size());
+
+	uint32_t tableLength = offsets.size() * 4;
+	if(tableLength + blocks.size() > entry.length - entry.length / 8)
+	{
+		return;
+	}
+
+	for(uint32_t offset : offsets)
+	{
+		uint32_t value = offset + tableLength;
+		for(int b = 0; b < 4; b++)
+		{
+			entry.stored.push_back((value >> (b * 8)) & 0xFF);
+		}
+	}
+	entry.stored.insert(entry.stored.end(), blocks.begin(), blocks.end());
+	entry.compressed = true;
+
+	if(verbose)
+	{
+		std::cout << "  compressed: " << entry.path << " " << entry.length << " -> " << entry.stored.size() << std::endl;
+	}
+}
+
+/**
+ *
+ */
+void ghost_ramdisk::writeLegacy()
+{
+	for(ghost_ramdisk_entry& entry : entries)
+	{
+		// file or folder
+		char type = entry.isFile ? 1 : 0;
+		out.write(&type, 1);
+
+		writeInt(entry.id);
+		writeInt(entry.parentId);
+
+		writeInt(entry.name.length());
+		out.write(entry.name.c_str(), entry.name.length());
+
+		if(entry.isFile)
+		{
+			writeInt(entry.length);
+
+			uint32_t written = writeContent(entry);
+			if(written < entry.length)
+			{
+				std::cerr << "error: file '" << entry.path << "' is shorter than expected" << std::endl;
+				writePadding(entry.length - written);
+			}
+		}
+	}
 
-	// entry done
 	out.flush();
+}
 
-	delete buffer;
+/**
+ *
+ */
+void ghost_ramdisk::writeIndexed()
+{
+	if(compress)
+	{
+		for(ghost_ramdisk_entry& entry : entries)
+		{
+			if(entry.isFile && entry.length > 0)
+			{
+				compressContent(entry);
+			}
+		}
+	}
+
+	uint32_t headerSize = 24;
+	uint32_t tableSize = entries.size() * (compress ? 32 : 24);
+
+	uint32_t namesOffset = headerSize + tableSize;
+	uint32_t namesLength = 0;
+	for(ghost_ramdisk_entry& entry : entries)
+	{
+		namesLength += entry.name.length() + 1;
+	}
+
+	uint32_t dataOffset = PAGE_ALIGN_UP(namesOffset + namesLength);
+
+	// Header
+	out.write(RAMDISK_MAGIC, 4);
+	writeInt(compress ? RAMDISK_FORMAT_VERSION_COMPRESSED : RAMDISK_FORMAT_VERSION);
+	writeInt(entries.size());
+	writeInt(namesOffset);
+	writeInt(namesLength);
+	writeInt(dataOffset);
+
+	// Entry table
+	uint32_t nameOffset = 0;
+	uint32_t contentOffset = dataOffset;
+	for(ghost_ramdisk_entry& entry : entries)
+	{
+		writeInt(entry.id);
+		writeInt(entry.parentId);
+		writeInt(entry.isFile ? 1 : 0);
+		writeInt(nameOffset);
+		writeInt(entry.isFile ? contentOffset : 0);
+		writeInt(entry.length);
+
+		uint32_t storedLength = entry.compressed ? entry.stored.size() : entry.length;
+		if(compress)
+		{
+			writeInt(storedLength);
+			writeInt(entry.compressed ? RAMDISK_ENTRY_FLAG_COMPRESSED : 0);
+		}
+
+		nameOffset += entry.name.length() + 1;
+		if(entry.isFile)
+		{
+			contentOffset = PAGE_ALIGN_UP(contentOffset + storedLength);
+		}
+	}
+
+	// Names
+	for(ghost_ramdisk_entry& entry : entries)
+	{
+		out.write(entry.name.c_str(), entry.name.length() + 1);
+	}
+	writePadding(dataOffset - (namesOffset + namesLength));
+
+	// Contents, each starting on a page boundary
+	for(ghost_ramdisk_entry& entry : entries)
+	{
+		if(!entry.isFile)
+		{
+			continue;
+		}
+
+		if(entry.compressed)
+		{
+			out.write((const char*) entry.stored.data(), entry.stored.size());
+			writePadding(PAGE_ALIGN_UP(entry.stored.size()) - entry.stored.size());
+			continue;
+		}
+
+		uint32_t written = writeContent(entry);
+		if(written < entry.length)
+		{
+			std::cerr << "error: file '" << entry.path << "' is shorter than expected" << std::endl;
+		}
+		writePadding(PAGE_ALIGN_UP(entry.length) - written);
+	}
+
+	out.flush();
 }
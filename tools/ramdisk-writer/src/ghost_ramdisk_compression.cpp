@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "../inc/ghost_ramdisk_compression.hpp"
+
+#include <string.h>
+
+#define HASH_BITS		12
+#define MINIMUM_MATCH	4
+#define MAXIMUM_OFFSET	0xFFFF
+
+// the last match must start this many bytes before the end of a block,
+// the last bytes of a block are always literals
+#define MATCH_START_LIMIT	12
+#define LAST_LITERALS		5
+
+/**
+ *
+ */
+static uint32_t read32(const uint8_t* position)
+{
+	uint32_t value;
+	memcpy(&value, position, 4);
+	return value;
+}
+
+/**
+ *
+ */
+static uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/**
+ *
+ */
+static void writeLength(std::vector<uint8_t>& out, uint32_t length)
+{
+	while(length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back(length);
+}
+
+/**
+ *
+ */
+static void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, uint32_t literalLength, uint32_t offset, uint32_t matchLength)
+{
+	uint8_t token = (literalLength < 15 ? literalLength : 15) << 4;
+	if(matchLength > 0)
+	{
+		uint32_t matchCode = matchLength - MINIMUM_MATCH;
+		token |= matchCode < 15 ? matchCode : 15;
+	}
+	out.push_back(token);
+
+	if(literalLength >= 15)
+	{
+		writeLength(out, literalLength - 15);
+	}
+	out.insert(out.end(), literals, literals + literalLength);
+
+	if(matchLength > 0)
+	{
+		out.push_back(offset & 0xFF);
+		out.push_back((offset >> 8) & 0xFF);
+
+		if(matchLength - MINIMUM_MATCH >= 15)
+		{
+			writeLength(out, matchLength - MINIMUM_MATCH - 15);
+		}
+	}
+}
+
+/**
+ *
+ */
+void ramdiskCompressBlock(const uint8_t* source, uint32_t length, std::vector<uint8_t>& out)
+{
+	std::vector<int32_t> table(1 << HASH_BITS, -1);
+
+	uint32_t anchor = 0;
+	uint32_t position = 0;
+	if(length > MATCH_START_LIMIT)
+	{
+		uint32_t matchStartLimit = length - MATCH_START_LIMIT;
+		uint32_t matchEndLimit = length - LAST_LITERALS;
+
+		while(position < matchStartLimit)
+		{
+			uint32_t sequence = read32(source + position);
+			uint32_t slot = hash(sequence);
+			int32_t candidate = table[slot];
+			table[slot] = position;
+
+			if(candidate < 0 || position - candidate > MAXIMUM_OFFSET || read32(source + candidate) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			uint32_t matchEnd = position + MINIMUM_MATCH;
+			while(matchEnd < matchEndLimit && source[matchEnd] == source[candidate + (matchEnd - position)])
+			{
+				matchEnd++;
+			}
+
+			writeSequence(out, source + anchor, position - anchor, position - candidate, matchEnd - position);
+			position = matchEnd;
+			anchor = position;
+		}
+	}
+
+	writeSequence(out, source + anchor, length - anchor, 0, 0);
+}